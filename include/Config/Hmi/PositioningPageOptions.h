@@ -0,0 +1,41 @@
+#ifndef POSITIONING_PAGE_OPTIONS_H
+#define POSITIONING_PAGE_OPTIONS_H
+
+#include <stdint.h>
+#include "../../lib/Lumen_Protocol/src/c/LumenProtocol.h" // For lumen_packet_t and kDataType
+#include "../SystemConfig.h"                              // For SystemConfig::HmiParameters::MAX_HMI_STRING_LENGTH
+
+namespace HmiPositioningPageOptions
+{
+    // The Z DRO shares address 135 with the Turning and Threading tabs.
+
+    // Go to an absolute Z (relative to the positioning zero)
+    const uint16_t string_goto_value_to_stm32Address = 220; // HMI keyboard input to STM32
+    const uint16_t bool_gotoAddress = 221;                  // "Go To" button
+
+    // Move by an increment
+    const uint16_t string_increment_to_stm32Address = 222; // HMI keyboard input to STM32
+    const uint16_t int_move_byAddress = 223;               // HMI: 1 = move -increment, 2 = move +increment
+
+    // Start position
+    const uint16_t bool_set_startAddress = 224;       // "Set Start" button: current Z becomes the start
+    const uint16_t bool_return_to_startAddress = 225; // "Return to Start" button
+
+    const uint16_t bool_stop_moveAddress = 226; // "Stop" button: decelerates the running move
+    const uint16_t bool_zero_zAddress = 227;    // "Zero Z" button
+
+    // STM32 displays to HMI
+    const uint16_t string_status_dispAddress = 228; // "READY" / "MOVING" / "TAKE-UP"
+    const uint16_t string_start_dispAddress = 229;  // Start position, e.g. "12.000 mm"
+
+    // Move-by command values (for int_move_byAddress)
+    enum MoveByCommandValue : int32_t
+    {
+        MOVE_BY_CMD_NONE = 0,
+        MOVE_BY_CMD_MINUS = 1,
+        MOVE_BY_CMD_PLUS = 2
+    };
+
+} // namespace HmiPositioningPageOptions
+
+#endif // POSITIONING_PAGE_OPTIONS_H
@@ -57,6 +57,12 @@ namespace HmiSetupPageOptions // Renamed namespace for clarity
 
     constexpr uint16_t ADDR_Z_LEADSCREW_STANDARD_TOGGLE = 157; // bool: 0=Metric, 1=Imperial
 
+    // Column 4: Sync modes (read at the next start of a synchronized move)
+    constexpr uint16_t ADDR_EDGE_TRIGGERED_SYNC_TOGGLE = 250; // bool: 1=step-boundary compares instead of polling
+    constexpr uint16_t ADDR_HARDWARE_GEARING_TOGGLE = 251;    // bool: 1=TIM2->TIM1 trigger chain for whole-number ratios
+    constexpr uint16_t ADDR_COMPARE_DMA_SYNC_TOGGLE = 252;    // bool: 1=DMA-fed TIM2 compares for fine feeds
+    constexpr uint16_t ADDR_NCO_SYNC_TOGGLE = 253;            // bool: 1=continuous-frequency TIM1 output for other ratios
+
     // --- Action Buttons ---
     constexpr uint16_t ADDR_SAVE_ALL_PARAMS_PULSE = 180; // bool: HMI sends pulse to save
 
@@ -43,6 +43,27 @@ namespace HmiThreadingPageOptions
     const uint16_t string_set_stop_disp_value_from_stm32Address = 213; // STM32 display to HMI
     const uint16_t bool_grab_zAddress = 214;                           // "Use Current Z" button
 
+    // Multi-start indexing
+    const uint16_t bool_next_startAddress = 217;        // "Next Start" button
+    const uint16_t string_current_startAddress = 218;   // STM32 display to HMI, e.g. "2/3"
+
+    // Virtual half-nut
+    const uint16_t bool_new_threadAddress = 219;        // "New Thread" button: forget the previous passes' groove
+
+    // Multi-pass cycle (thread to the auto-stop target, retract, rapid return, re-engage in the groove)
+    const uint16_t bool_cycle_startAddress = 234;              // "Cycle Start": first pass from the current Z
+    const uint16_t bool_cycle_finishAddress = 235;             // "Final Depth": spring passes, then end at the start
+    const uint16_t bool_cycle_abortAddress = 236;              // "Cycle Stop": leave the cycle
+    const uint16_t string_cycle_dispAddress = 237;             // STM32 display to HMI, e.g. "P4 RETURN"
+    const uint16_t int_spring_passes_prev_nextAddress = 238;   // HMI: 1 = one less, 2 = one more
+    const uint16_t string_spring_passes_dispAddress = 239;     // STM32 display to HMI, e.g. "1"
+
+    // Progressive (variable) pitch: the selected lead ramps to the end lead over the length
+    const uint16_t bool_progressive_pitch_enDisAddress = 243;           // HMI toggle: progressive pitch on/off
+    const uint16_t string_progressive_end_pitch_to_stm32Address = 244;  // HMI keyboard input, end lead in mm
+    const uint16_t string_progressive_length_to_stm32Address = 245;     // HMI keyboard input, ramp length in mm
+    const uint16_t string_progressive_pitch_dispAddress = 246;          // STM32 display to HMI, e.g. "1.000>1.500/40"
+
     // Lumen Packet Declarations for Auto-Stop (defined in .cpp file)
     extern lumen_packet_t bool_auto_stop_enDisPacket;
     extern lumen_packet_t string_set_stop_disp_value_to_stm32Packet;
@@ -19,6 +19,21 @@ namespace HmiTurningPageOptions
     const uint16_t string_set_stop_disp_value_from_stm32Address = 197; // STM32 display to HMI
     const uint16_t bool_grab_zAddress = 198;                           // "Use Current Z" button
 
+    // Feed override (percent of the selected feed, applied live)
+    const uint16_t int_feed_override_prev_nextAddress = 215; // HMI: 1 = -5 %, 2 = +5 %, 0 = reset to 100 %
+    const uint16_t string_feed_override_dispAddress = 216;   // STM32 display to HMI, e.g. "110%"
+
+    // Semi-auto cycle (feed to the auto-stop target, rapid back to the start, wait for re-arm)
+    const uint16_t bool_semi_autoAddress = 230;      // HMI toggle: semi-auto cycle mode on/off
+    const uint16_t bool_cycle_startAddress = 231;    // HMI button: arm the first pass / re-arm the next
+    const uint16_t bool_cycle_abortAddress = 232;    // HMI button: leave the cycle
+    const uint16_t string_cycle_dispAddress = 233;   // STM32 display to HMI, e.g. "P3 12.4s"
+
+    // Feed per minute (carriage speed independent of the spindle)
+    const uint16_t bool_feed_per_minuteAddress = 240;             // HMI toggle: mm/min feed on, mm/rev feed off
+    const uint16_t string_feed_per_minute_to_stm32Address = 241;  // HMI keyboard input, mm/min or in/min
+    const uint16_t string_feed_per_minute_dispAddress = 242;      // STM32 display to HMI, e.g. "50.0 mm/min"
+
     // Note: The "Jog Setup Tab selector number = 5" (now PAGE_JOG) implies that the main tab selector
     // (int_tab_selectionAddress = 136, currently in SetupPageOptions.h or a global HMI config)
     // will send '5' for the dedicated Jog Page.
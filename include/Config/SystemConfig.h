@@ -26,7 +26,13 @@ namespace SystemConfig
             // A value too high may filter out valid high-speed pulses.
             // Good starting range: 4-12.
             static constexpr uint8_t DEFAULT_FILTER = 10;         // Adjusted from 12 back towards 8
-            static constexpr uint32_t MIN_RPM_DELTA_TIME_MS = 10; // Minimum time delta (ms) for reliable RPM calculation
+
+            // Speed measurement (EncoderTimer::getCountsPerSecond())
+            static constexpr uint32_t SPEED_CAPTURE_HZ = 1000000;     // Finest TIM3 line-period tick
+            static constexpr uint32_t SPEED_CAPTURE_MIN_RPM = 1;      // Slowest encoder shaft speed one 16-bit TIM3 period must span; sets the tick from PPR
+            static constexpr uint32_t SPEED_PERIOD_MIN_TICKS = 50;    // Shorter line periods are too coarse; count a window instead
+            static constexpr uint32_t SPEED_WINDOW_US = 1000;         // Minimum count window at high speed
+            static constexpr uint32_t SUBCOUNT_SCALE = 256;           // Resolution of the interpolated fraction of a count
 
             // NEW: Added quadrature multiplier
             static constexpr uint16_t QUADRATURE_MULT = 4;
@@ -74,6 +80,70 @@ namespace SystemConfig
             // Good starting range: 20000-50000 Hz.
             static constexpr uint32_t DEFAULT_SYNC_FREQ = 50000;
             static constexpr float DEFAULT_THREAD_PITCH = 1.0f;
+            // Edge-triggered sync fires on TIM2 compares at each step boundary instead of polling at
+            // DEFAULT_SYNC_FREQ. Off by default until validated on the machine; switched on the setup page.
+            static constexpr bool DEFAULT_EDGE_TRIGGERED_SYNC = false;
+            static constexpr uint32_t MAX_EDGE_SYNC_STEP_HZ = 200000; // Upper bound for an edge-triggered burst
+            // Hardware gearing chains TIM2 TRGO (one trigger per encoder line) into TIM1 when the ratio
+            // is a whole number of steps per line or lines per step. Picked automatically when enabled;
+            // off by default until validated on the machine; switched on the setup page.
+            static constexpr bool DEFAULT_HARDWARE_GEARING = false;
+            static constexpr uint32_t HARDWARE_GEARING_BURST_HZ = 100000;       // Pulse rate of a steps-per-line burst
+            static constexpr uint32_t HARDWARE_GEARING_SUPERVISOR_HZ = 1000;    // Direction/phase check rate
+            static constexpr int32_t HARDWARE_GEARING_ERROR_MARGIN_STEPS = 2;   // Extra phase error tolerated before fallback
+            // Compare DMA streams exact step positions into a TIM2 compare for fine feeds
+            // (at most one step per two encoder counts) that hardware gearing cannot divide evenly.
+            // Off by default until validated on the machine; switched on the setup page.
+            static constexpr bool DEFAULT_COMPARE_DMA_SYNC = false;
+            // NCO sync runs TIM1 continuously and retunes it every tick instead of bursting
+            // finite moves; used for ratios neither exact hardware path can take. Off by default
+            // until validated on the machine; switched on the setup page.
+            static constexpr bool DEFAULT_NCO_SYNC = false;
+            static constexpr uint32_t NCO_UPDATE_HZ = 1000;     // Rate/phase update rate
+            static constexpr float NCO_PHASE_GAIN = 50.0f;      // Extra steps/s per step of phase error
+            static constexpr float NCO_MIN_STEP_HZ = 20.0f;     // Below this the output parks
+            static constexpr uint32_t NCO_MAX_STEP_HZ = 100000;
+            // Feed override scales the turning feed ratio while the cut runs. The applied value
+            // walks towards the requested one in small steps so the carriage never jumps in speed.
+            static constexpr uint16_t FEED_OVERRIDE_MIN_PERCENT = 50;
+            static constexpr uint16_t FEED_OVERRIDE_MAX_PERCENT = 150;
+            static constexpr uint16_t FEED_OVERRIDE_STEP_PERCENT = 5;       // Per HMI button press
+            static constexpr uint16_t FEED_OVERRIDE_SLEW_PERCENT = 1;       // Per slew interval
+            static constexpr uint32_t FEED_OVERRIDE_SLEW_INTERVAL_MS = 20;  // i.e. 50 %/s
+            // Variable-pitch threads: piecewise-linear pitch vs Z, walked by the sync ISR per step.
+            static constexpr uint8_t MAX_PITCH_PROFILE_POINTS = 16;
+            static constexpr uint32_t PITCH_PROFILE_MAX_DENOMINATOR = 1UL << 24; // Common ratio denominator cap
+            // Index-locked threading engages at a fixed encoder phase after the spindle index.
+            static constexpr bool DEFAULT_INDEX_ENGAGE = true;
+            static constexpr uint32_t INDEX_ENGAGE_MIN_LEAD_COUNTS = 8; // Engage point must be at least this far ahead
+            // Spindle observer (critically damped alpha-beta-gamma) in the PERIODIC and NCO ticks.
+            // Its velocity is the NCO feed-forward; with feed-forward on, PERIODIC gears to the count
+            // predicted for the end of the next period instead of the one just read.
+            static constexpr float OBSERVER_BANDWIDTH_HZ = 10.0f;
+            static constexpr bool DEFAULT_OBSERVER_FEED_FORWARD = true;
+            // startMotion() ramps the Z axis up to a turning spindle under Z_Axis::acceleration, then locks phase.
+            static constexpr bool DEFAULT_SOFT_ENGAGE = true;
+            static constexpr float ENGAGE_CATCHUP_FRACTION = 0.25f; // Catch-up speed, relative to synchronous speed
+            static constexpr float ENGAGE_CATCHUP_MIN_HZ = 200.0f;  // Catch-up speed floor at low spindle speed
+            static constexpr float ENGAGE_LOCK_VELOCITY_FRACTION = 0.05f; // Speed match needed to lock phase
+            // Following-error monitor: commanded steps not yet delivered (TIM5) beyond this stop the feed.
+            static constexpr float DEFAULT_FOLLOWING_ERROR_LIMIT_MM = 0.5f; // 0 disables the trip
+            static constexpr bool DEFAULT_FOLLOWING_ERROR_FAULT = false;    // true: emergency stop and error instead of a controlled stop
+            // Below one count per PERIODIC/NCO tick, step between encoder counts on the line-period interpolation.
+            static constexpr bool DEFAULT_SUBCOUNT_INTERPOLATION = true;
+            // Precise stop: settled once the target step is delivered, or after this many sync ticks in a
+            // row with nothing left to emit and no step delivered (a step lost short of the target).
+            static constexpr uint32_t STOP_SETTLE_QUIET_TICKS = 8;
+            // Semi-auto turning cycle: after the auto-stop settles the return leg starts this much later,
+            // so its acceleration ramp overlaps the operator backing the tool out in X.
+            static constexpr uint32_t DEFAULT_CYCLE_RETURN_DELAY_MS = 300;
+            static constexpr uint32_t MAX_CYCLE_RETURN_DELAY_MS = 5000;
+            // Threading cycle: the tool must be clear of the thread before the return, so it waits longer.
+            static constexpr uint32_t DEFAULT_THREAD_CYCLE_RETRACT_MS = 1000;
+            static constexpr uint8_t DEFAULT_SPRING_PASSES = 1; // Passes repeated at final depth
+            static constexpr uint8_t MAX_SPRING_PASSES = 5;
+            // Feed-per-minute (FEEDING) mode: carriage speed independent of the spindle, mm/min.
+            static constexpr float DEFAULT_FEED_PER_MINUTE_MM = 50.0f;
             // DEFAULT_LEADSCREW_PITCH will move to Z_Axis limits
         };
 
@@ -88,7 +158,9 @@ namespace SystemConfig
             static constexpr float DEFAULT_MAX_FEED_RATE = 2000.0f;            // mm/min for Z-axis rapids (general ELS)
             static constexpr float DEFAULT_MAX_JOG_SPEED_MM_PER_MIN = 600.0f;  // mm/min specifically for jogging
             static constexpr float DEFAULT_ACCELERATION = 20.0f;               // mm/s^2 for Z-axis (Drastically reduced for testing)
-            static constexpr float DEFAULT_BACKLASH_COMPENSATION = 0.02f;      // mm for Z-axis
+            static constexpr float DEFAULT_JERK = 200.0f;                      // mm/s^3 for S-curve jog profiles
+            static constexpr bool DEFAULT_S_CURVE_PROFILE = true;              // true: jerk-limited jogs, false: trapezoidal
+            static constexpr float DEFAULT_BACKLASH_COMPENSATION = 0.0f;       // mm for Z-axis; 0 = no take-up until measured on the machine
             static constexpr bool DEFAULT_LEADSCREW_STANDARD_IS_METRIC = true; // true for MM, false for Inches
             static constexpr bool DEFAULT_ENABLE_POLARITY_ACTIVE_HIGH = true;  // true for active high, false for active low
             static constexpr uint32_t DEFAULT_MIN_STEP_PULSE_US = 5;           // Minimum step pulse width in microseconds
@@ -127,6 +199,19 @@ namespace SystemConfig
             // leadscrew_pitch moved to Z_Axis struct
             static uint32_t sync_frequency; // Sync update rate (Hz)
             static bool sync_enabled;       // Synchronization enable flag
+            static bool edge_triggered_sync; // Use encoder step-boundary compares instead of periodic polling (setup page)
+            static bool hardware_gearing;    // Allow the TIM2->TIM1 trigger chain for whole-number ratios (setup page)
+            static bool compare_dma_sync;    // Allow DMA-fed TIM2 compares for fine feeds (setup page)
+            static bool nco_sync;            // Use the continuous-frequency TIM1 output for other ratios (setup page)
+            static bool index_engage;        // Start threading passes at a fixed phase after the index pulse (not persisted)
+            static bool observer_feed_forward; // PERIODIC sync gears one observer-predicted period ahead (not persisted)
+            static bool soft_engage;         // Ramp up to a turning spindle on startMotion() (not persisted)
+            static float following_error_limit_mm; // Following error that stops the feed, mm (not persisted)
+            static bool following_error_fault; // Following-error trip is a fault (emergency stop), not a controlled stop (not persisted)
+            static bool subcount_interpolation; // Step between encoder counts on interpolated sub-count position (not persisted)
+            static uint32_t cycle_return_delay_ms; // Semi-auto cycle: stop to start of the rapid return (not persisted)
+            static uint32_t thread_cycle_retract_ms; // Threading cycle: stop to start of the rapid return (not persisted)
+            static uint8_t spring_passes;         // Threading cycle: passes at final depth (not persisted)
         };
 
         // NEW: Z-Axis runtime parameters
@@ -140,6 +225,8 @@ namespace SystemConfig
             static float max_feed_rate;               // Max rapid traverse speed for Z, e.g., mm/min (general ELS)
             static float max_jog_speed_mm_per_min;    // Max speed specifically for jogging
             static float acceleration;                // Z-axis acceleration, e.g., mm/s^2
+            static float jerk;                        // Z-axis jerk limit for S-curve profiles, mm/s^3 (not persisted)
+            static bool s_curve_profile;              // Jog with jerk-limited instead of trapezoidal profiles (not persisted)
             static float backlash_compensation;       // mm
             static bool leadscrew_standard_is_metric; // true for MM, false for Inches
             static bool enable_polarity_active_high;  // true for active high, false for active low
@@ -188,6 +275,7 @@ namespace SystemConfig
             static bool thread_pitch;
             static bool sync_frequency;
             static bool sync_enabled;
+            static bool sync_modes; // Optional sync modes: edge_triggered_sync, hardware_gearing, compare_dma_sync, nco_sync
         };
         struct Z_Axis
         {
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "stm32h7xx_hal.h"
+
+namespace DCache
+{
+    /**
+     * @brief Writes a freshly filled DMA source buffer back from the D-cache, so the DMA (which
+     * does not snoop the cache) reads it and not stale memory. A no-op with the cache off.
+     * @param data  Start of the buffer.
+     * @param bytes Length of the buffer.
+     */
+    inline void cleanForDma(const void *data, uint32_t bytes)
+    {
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+        if (SCB->CCR & SCB_CCR_DC_Msk)
+        {
+            // Cleaning whole lines around the range is harmless: the DMA only reads the buffer
+            uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~static_cast<uintptr_t>(31);
+            uintptr_t end = reinterpret_cast<uintptr_t>(data) + bytes;
+            SCB_CleanDCache_by_Addr(reinterpret_cast<uint32_t *>(start), static_cast<int32_t>(end - start));
+        }
+#else
+        (void)data;
+        (void)bytes;
+#endif
+    }
+} // namespace DCache
@@ -3,18 +3,30 @@
 #include <Arduino.h>
 #include <HardwareTimer.h> // For TIM_HandleTypeDef if not fully encapsulated
 #include "stm32h7xx_hal.h" // For HAL types like TIM_HandleTypeDef, GPIO_InitTypeDef etc.
+#include <functional>
 
 /**
  * @class EncoderTimer
  * @brief Manages a hardware timer (TIM2) in encoder interface mode to track spindle position and speed.
  *
  * This class configures TIM2 to decode quadrature encoder signals (A/B channels)
- * to provide a continuous count of encoder pulses. It also calculates RPM based on
- * changes in this count over time.
+ * to provide a continuous count of encoder pulses.
+ *
+ * TIM2 TRGO pulses on every channel A rising edge (compare-pulse mode on the IC1 capture), i.e.
+ * once per encoder line (QUADRATURE_MULT counts) in either direction, except while the compare
+ * table owns it. It reaches TIM1 on ITR1 for hardware gearing and TIM3 on ITR1 for speed
+ * measurement: TIM3 captures and restarts on each line, so it holds the last line period.
  */
 class EncoderTimer
 {
 public:
+    /**
+     * @brief Produces the next `count` compare positions of a DMA compare table.
+     * Called once for the initial compare value, then from the DMA interrupt for each
+     * half of the table that has been consumed.
+     */
+    using CompareTableRefill = std::function<void(uint32_t *entries, uint32_t count)>;
+
     /**
      * @struct Position
      * @brief Holds comprehensive position and speed data from the encoder.
@@ -54,8 +66,9 @@ public:
     void end();
 
     /**
-     * @brief Resets the encoder count and error state.
-     * Sets the hardware timer counter to 0.
+     * @brief Re-zeroes the relative count (getCount()) and clears the error state.
+     * Non-destructive: TIM2 and the absolute position keep running, so raw counts and
+     * compare positions held elsewhere stay valid.
      */
     void reset();
 
@@ -67,18 +80,51 @@ public:
     Position getPosition() const;
 
     /**
-     * @brief Gets the current raw encoder count.
-     * This is a direct read of the hardware timer's counter register.
-     * @return Current encoder count (quadrature).
+     * @brief Gets the encoder count since the last reset().
+     * @return Current encoder count (quadrature), relative to the reset() origin.
      */
     int32_t getCount() const;
 
     /**
-     * @brief Calculates and returns the current RPM of the spindle.
+     * @brief 64-bit absolute spindle position in quadrature counts since begin(); never reset.
+     * TIM2 is extended by a wrap epoch kept in the update interrupt. The read is lock-free:
+     * a sequence count retries if the epoch changed underneath, and a wrap whose interrupt has
+     * not run yet (e.g. read with interrupts masked) is folded in from the pending flag.
+     * Must not be called from an interrupt that outranks TIM2.
+     * The low 32 bits always equal getRawCounter() at the same instant.
+     */
+    int64_t getAbsolutePosition() const;
+
+    /**
+     * @brief Encoder speed in counts per second, positive while TIM2 counts up.
+     * Below SPEED_PERIOD_MIN_TICKS per line it is the last line-to-line period from TIM3 (a fresh
+     * reading every encoder line, and down to SPEED_CAPTURE_MIN_RPM before TIM3 times out as
+     * stopped: its tick is scaled from the PPR, and again whenever the PPR setting changes);
+     * above it, counts over a window of at least SPEED_WINDOW_US. Any caller, at any rate, gets
+     * the latest estimate: there is no per-call minimum interval. Main loop only.
+     */
+    float getCountsPerSecond() const;
+
+    /**
+     * @brief Encoder shaft RPM from getCountsPerSecond(), honouring Encoder::invert_direction.
      * @return Current RPM as a signed 16-bit integer.
      */
     int16_t getRPM() const;
 
+    /**
+     * @brief Time-interpolated position within the current count, for encoders coarser than the step.
+     * The distance since the last line edge (TIM3 elapsed ticks over the last line period, with the
+     * count TIM2 captured in CCR1 at that edge) is clamped to the count the counter is on. The result
+     * therefore never reaches the next count: a decelerating or stopping spindle leaves it parked
+     * just short of the edge, and the error stays below one count. ISR-safe.
+     * @param count Raw counter value the fraction is relative to (as read by the caller).
+     * @param fraction Receives the fraction of a count travelled past `count`, in 1/SUBCOUNT_SCALE units,
+     *                 signed with TIM2's direction: [0, SUBCOUNT_SCALE) counting up, (-SUBCOUNT_SCALE, 0] down.
+     * @return False if there is no line period to interpolate with (standstill, first line after it,
+     *         compare table active, or `count` is not within a line of the last edge).
+     */
+    bool getSubCountFraction(uint32_t count, int32_t &fraction) const;
+
     /**
      * @brief Checks if the encoder timer is initialized and no errors are present.
      * @return True if the encoder is initialized and valid, false otherwise.
@@ -90,31 +136,107 @@ public:
      * @brief Gets the raw value of the TIM2 counter register.
      * @return Raw 32-bit timer counter value.
      */
-    uint32_t getRawCounter() const; // Implementation: return __HAL_TIM_GET_COUNTER(&htim2);
+    uint32_t getRawCounter() const; // Implementation: return __HAL_TIM_GET_COUNTER(_htim);
 
     /**
      * @brief Gets the TIM2 update interrupt flag status.
      * @return Value of the TIM_FLAG_UPDATE.
      */
-    uint32_t getTimerStatus() const; // Implementation: return __HAL_TIM_GET_FLAG(&htim2, TIM_FLAG_UPDATE);
+    uint32_t getTimerStatus() const; // Implementation: return __HAL_TIM_GET_FLAG(_htim, TIM_FLAG_UPDATE);
 
     /**
      * @brief Gets the value of the TIM2 Control Register 1 (CR1).
      * @return Raw 32-bit value of CR1.
      */
-    uint32_t getTimerCR1() const; // Implementation: return htim2.Instance->CR1;
+    uint32_t getTimerCR1() const; // Implementation: return _htim->Instance->CR1;
 
     /**
      * @brief Provides access to the underlying TIM_HandleTypeDef for TIM2.
      * Useful for direct HAL manipulation or ISR configuration if needed externally.
      * @return Pointer to the TIM_HandleTypeDef for TIM2.
      */
-    TIM_HandleTypeDef *getTimerHandle() { return &htim2; }
+    TIM_HandleTypeDef *getTimerHandle() { return _htim; }
 
     /**
-     * @brief To be called from HAL_TIM_TriggerCallback when an index pulse (ETR) occurs.
+     * @brief True if TIM2 last counted down (hardware DIR bit).
      */
-    void IndexPulse_Callback_Internal();
+    bool isCountingDown() const;
+
+    // --- Step-Boundary Compare Events ---
+    /**
+     * @brief Arms the TIM2 compare channels at the next step-boundary counts.
+     * CH3 fires when the counter reaches `upCount`, CH4 when it reaches `downCount`.
+     * Either match disarms both and invokes the callback set with setStepBoundaryCallback().
+     * @param upCount Counter value of the next boundary while counting up.
+     * @param downCount Counter value of the next boundary while counting down.
+     */
+    void armStepBoundaries(uint32_t upCount, uint32_t downCount);
+
+    /**
+     * @brief Disables the step-boundary compare interrupts.
+     */
+    void disarmStepBoundaries();
+
+    /**
+     * @brief Sets the function called (from the TIM2 interrupt) when a step boundary is reached.
+     * @param callback The function to call, or nullptr to clear it.
+     */
+    void setStepBoundaryCallback(callback_function_t callback);
+
+    // --- DMA Compare Table ---
+    /**
+     * @brief Streams a table of encoder positions into TIM2 CCR3 by DMA.
+     * CH3 toggles OC3REF on every match and drives TIM2 TRGO, so each pair of entries
+     * (rising, falling) gives one TRGO rising edge at exactly the first count of the pair.
+     * The DMA runs circularly over `table`; `refill` rewrites each half once it has been consumed,
+     * and the rewritten half is cleaned from the D-cache before the DMA reaches it.
+     * Shares CH3 with the step-boundary compares, so those must be disarmed.
+     * @param table Ring buffer in DMA-accessible RAM (AXI/SRAM, not DTCM). `length` must be even.
+     * @param length Number of entries in `table`.
+     * @param refill Generator for the compare positions.
+     * @return True if the DMA was started.
+     */
+    bool startCompareTable(uint32_t *table, uint32_t length, CompareTableRefill refill);
+
+    /**
+     * @brief Stops the compare DMA and returns CH3 and TRGO to their idle configuration.
+     */
+    void stopCompareTable();
+
+    /** @brief True while the compare DMA is running. */
+    bool isCompareTableActive() const { return _compareTableActive; }
+
+    /**
+     * @brief Compare value CH3 is currently waiting for.
+     */
+    uint32_t getActiveCompare() const;
+
+    /**
+     * @brief Compare DMA stream interrupt, called from the stream's IRQ handler.
+     */
+    static void compareDmaIrqHandler();
+
+    /**
+     * @brief To be called from the index pulse interrupt (PA5 EXTI).
+     * The handler reads the TIM2 counter (getRawCounter()) as its very first statement and
+     * passes it in, so the index position is exact to the count at any practical spindle speed.
+     * (TIM2's slave controller is taken by encoder mode, so the index cannot reset or capture
+     * the counter in hardware.)
+     * @param count TIM2 count read on entry to the index interrupt.
+     */
+    void IndexPulse_Callback_Internal(uint32_t count);
+
+    /**
+     * @brief Raw encoder count latched at the most recent index pulse.
+     * @param count Receives the latched count.
+     * @return False if no index pulse has been seen since begin().
+     */
+    bool getIndexCount(uint32_t &count) const;
+
+    /**
+     * @brief Quadrature counts per encoder revolution (PPR x 4), i.e. between two index pulses.
+     */
+    uint32_t getCountsPerRevolution() const;
 
     /**
      * @brief Checks if an index pulse has occurred since the last check.
@@ -127,40 +249,80 @@ public:
     /**
      * @brief Static callback function for TIM2 update interrupts (overflow/underflow).
      * This function calls the handleOverflow method of the singleton instance.
-     * It must be registered with the NVIC for TIM2_IRQn.
+     * It is attached to the TIM2 HardwareTimer in begin().
      */
     static void updateCallback();
 
 private:
-    // Hardware handle for TIM2
-    TIM_HandleTypeDef htim2;
+    static constexpr uint32_t STEP_BOUNDARY_FORWARD_CHANNEL = 3;  ///< TIM2 CH3: next boundary while counting up.
+    static constexpr uint32_t STEP_BOUNDARY_BACKWARD_CHANNEL = 4; ///< TIM2 CH4: next boundary while counting down.
+    static constexpr uint32_t COMPARE_DMA_REQUEST = DMA_REQUEST_TIM2_CH3;      ///< DMAMUX request line for the compare table.
+    static constexpr IRQn_Type COMPARE_DMA_IRQ = DMA1_Stream0_IRQn;            ///< Must match the stream used in initCompareDma().
+
+    // Hardware timer for TIM2 and its HAL handle
+    HardwareTimer *_timer;
+    TIM_HandleTypeDef *_htim;
+    callback_function_t _stepBoundaryCallback;
+
+    // Line period capture: TIM3, slaved to TIM2 TRGO (see class description)
+    HardwareTimer *_speedTimer;
+    TIM_HandleTypeDef *_hspeed;
+    mutable uint32_t _speedTicksPerSecond;  ///< TIM3 count rate.
+    mutable uint16_t _speedCapturePpr;      ///< PPR the TIM3 tick was scaled for.
+    mutable int64_t _speedWindowPosition;   ///< Absolute position at the start of the count window.
+    mutable uint32_t _speedWindowStartUs;
+    mutable float _speedWindowCountsPerSecond; ///< Result of the last complete window.
+
+    // Compare table DMA (TIM2_CH3 request on DMA1 stream 0)
+    DMA_HandleTypeDef _hdmaCompare;
+    CompareTableRefill _compareRefill;
+    uint32_t *_compareTable;
+    uint32_t _compareTableLength;
+    bool _compareDmaInitialized;
+    volatile bool _compareTableActive;
 
     // State variables
-    volatile int32_t _currentCount;    ///< Software-extended count (not currently used for extension, hardware count is 32-bit).
+    volatile int32_t _epoch;            ///< TIM2 wraps: +1 per overflow, -1 per underflow. Upper word of the absolute position.
+    volatile uint32_t _epochSequence;   ///< Odd while the update interrupt rewrites _epoch.
+    int64_t _origin;                    ///< Absolute position at the last reset().
     volatile uint32_t _lastUpdateTime; ///< Timestamp of the last ISR update or significant event.
     volatile bool _error;              ///< Flag indicating an error state.
     bool _initialized;                 ///< True if begin() has been successfully called.
     volatile bool _indexPulseOccurred; ///< Flag set by IndexPulse_Callback_Internal, cleared by hasIndexPulseOccurred.
+    volatile uint32_t _indexCount;     ///< TIM2 count latched at the last index pulse.
+    volatile bool _indexLatched;       ///< True once _indexCount is valid.
 
     // Initialization methods
     bool initGPIO();  ///< Initializes GPIO pins for TIM2 encoder channels.
     bool initTimer(); ///< Initializes TIM2 in encoder interface mode.
+    bool initCompareDma(); ///< One-time setup of the compare table DMA stream.
+    bool initSpeedCapture(); ///< TIM3 line period capture (reset + trigger slave on TIM2 TRGO).
+    uint32_t speedCapturePrescaler() const; ///< TIM3 prescaler for the current PPR (see SPEED_CAPTURE_MIN_RPM).
 
     // Helper methods
     /**
-     * @brief Calculates RPM based on count changes over time.
-     * Uses static local variables to track previous count and time for delta calculation.
-     * @return Calculated RPM.
+     * @brief Counts per second over the count window, starting a new window once the
+     * current one spans SPEED_WINDOW_US.
      */
-    int16_t calculateRPM() const;
+    float windowCountsPerSecond() const;
 
     /**
      * @brief Handles timer overflow/underflow interrupts.
-     * Called by the static updateCallback.
-     * Currently updates _lastUpdateTime. Could be used for software count extension if needed.
+     * Called by the static updateCallback. Extends TIM2 to the 64-bit absolute position.
      */
     void handleOverflow();
 
+    /**
+     * @brief Handles a TIM2 CH3/CH4 compare match (step boundary reached).
+     */
+    void handleStepBoundary();
+
+    /**
+     * @brief DMA half/complete transfer: refills the half of the table that was just consumed.
+     * @param secondHalf True for the transfer-complete event.
+     */
+    void handleCompareRefill(bool secondHalf);
+
     // Static instance for callbacks (singleton pattern for ISR)
     static EncoderTimer *instance;
 };
@@ -48,7 +48,7 @@ public:
     bool getIsMetric() const { return isMetric; }           // Get current unit system
 
     // Display formatting
-    void getDisplayString(char *buffer, size_t size) const; // Get formatted display string
+    void getDisplayString(char *buffer, size_t size, uint16_t overridePercent = 100) const; // Get formatted display string (effective feed if overridden)
 };
 
 #endif // FEED_RATE_MANAGER_H
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @class GearRatio
+ * @brief Exact rational electronic gearing between spindle encoder counts and Z-axis steps.
+ *
+ * The whole drive chain (encoder PPR x quadrature, chuck/encoder pulleys, motor/leadscrew
+ * pulleys, leadscrew pitch and the requested feed or thread pitch) is reduced to a single
+ * `numerator / denominator` pair: `numerator` steps are due for every `denominator` encoder
+ * counts. The SyncTimer ISR runs a Bresenham-style accumulator on this pair (advance()), so
+ * there is no rounding error that can build up over a long thread.
+ */
+class GearRatio
+{
+public:
+    /**
+     * @brief Largest value used for either term.
+     * Kept below 2^30 so the ISR accumulator (< 2 x denominator) fits in an int32_t.
+     */
+    static constexpr uint32_t MAX_TERM = 0x3FFFFFFFUL;
+
+    uint32_t numerator;   ///< Steps generated per `denominator` encoder counts.
+    uint32_t denominator; ///< Encoder counts per `numerator` steps. Never 0.
+    bool exact;           ///< False if the reduced fraction had to be approximated to fit MAX_TERM.
+
+    GearRatio() : numerator(0), denominator(1), exact(true) {}
+
+    /**
+     * @brief Builds a reduced ratio from an arbitrary 64-bit fraction.
+     * Falls back to the closest continued-fraction approximation (and clears `exact`)
+     * if the reduced terms do not fit MAX_TERM.
+     * @param num Fraction numerator.
+     * @param den Fraction denominator. A zero denominator yields a 0/1 ratio.
+     * @return The reduced ratio.
+     */
+    static GearRatio fromFraction(uint64_t num, uint64_t den);
+
+    /**
+     * @brief Builds the steps-per-encoder-count ratio for a feed or thread pitch.
+     * Machine parameters are taken from SystemConfig::RuntimeConfig.
+     * @param pitch_mm Feed per spindle revolution in mm (sign is ignored; direction is handled separately).
+     * @param pitch_tpi If non-zero, the pitch is an imperial thread of this many TPI (0.01 TPI resolution).
+     *                  The lead is then built exactly as 25.4 x starts / TPI, with the start count
+     *                  recovered from pitch_mm.
+     * @return The reduced ratio.
+     */
+    static GearRatio forFeed(float pitch_mm, float pitch_tpi = 0.0f);
+
+    /**
+     * @brief Returns this ratio multiplied by `mul / div`, reduced again.
+     * @param mul Multiplier numerator.
+     * @param div Multiplier denominator (0 is treated as 1).
+     */
+    GearRatio scaled(uint32_t mul, uint32_t div) const;
+
+    /**
+     * @brief Steps per encoder count as a float, for display and diagnostics only.
+     */
+    float toFloat() const { return denominator ? static_cast<float>(numerator) / static_cast<float>(denominator) : 0.0f; }
+
+    /**
+     * @brief Advances a Bresenham accumulator by a signed number of encoder counts in one go.
+     * Yields exactly the steps and phase of adding `numerator` per count and carrying whole
+     * steps out at `denominator`, for one 64-bit divide however many counts there are. This is
+     * the gearing step of the SyncTimer ISR.
+     * @param counts Encoder counts, negative for reverse rotation.
+     * @param numerator Steps per `denominator` counts; `counts x numerator` must fit an int64.
+     * @param denominator Counts per `numerator` steps, > 0.
+     * @param phase Accumulator in [0, denominator); advanced in place.
+     * @return Steps that became due (signed).
+     */
+    static int64_t advance(int64_t counts, int64_t numerator, int32_t denominator, int32_t &phase)
+    {
+        int64_t total = phase + counts * numerator;
+        int64_t steps = total / denominator;
+        int64_t rest = total - steps * denominator;
+        if (rest < 0)
+        {
+            rest += denominator; // Floor, not truncate, when running backward
+            --steps;
+        }
+        phase = static_cast<int32_t>(rest);
+        return steps;
+    }
+
+    /**
+     * @brief advance() on this ratio.
+     */
+    int64_t advance(int64_t counts, int32_t &phase) const
+    {
+        return advance(counts, numerator, static_cast<int32_t>(denominator), phase);
+    }
+
+    /**
+     * @brief Where the gearing, started at a point with Bresenham `phase`, first reaches a step offset.
+     * Along the relation, `steps x denominator + accumulator = phase + counts x numerator`.
+     */
+    struct Reach
+    {
+        int64_t counts;       ///< First encoder count offset at which `steps` have been demanded.
+        int32_t phase;        ///< Accumulator at that count, in [0, denominator).
+        int32_t catchUpSteps; ///< Steps demanded beyond `steps` at that count.
+    };
+
+    /**
+     * @brief Finds the first encoder count at which the gearing has demanded `steps` (which may be
+     * negative) from a point at Bresenham `phase`. Used to re-engage a thread on its old relation.
+     * @param steps Step offset from the point.
+     * @param phase Accumulator at the point, in [0, denominator).
+     */
+    Reach reach(int32_t steps, int32_t phase) const;
+
+private:
+    GearRatio(uint32_t num, uint32_t den, bool isExact) : numerator(num), denominator(den), exact(isExact) {}
+};
@@ -3,6 +3,8 @@
 #include <Arduino.h>               // For standard types like uint32_t, bool
 #include "Hardware/EncoderTimer.h" // Dependency
 #include "Motion/SyncTimer.h"      // Dependency
+#include "Motion/GearRatio.h"      // Dependency
+#include "Config/SystemConfig.h"   // Limits used for member array sizes
 #include <STM32Step.h>             // Dependency (STM32Step::Stepper)
 
 /**
@@ -28,6 +30,16 @@ public:
         uint32_t enable_pin; ///< GPIO pin for ENABLE signal.
     };
 
+    /**
+     * @struct PitchPoint
+     * @brief One breakpoint of a variable-pitch thread: the pitch at a distance along the thread.
+     */
+    struct PitchPoint
+    {
+        float z_mm;     ///< Travel from the thread start in mm (strictly increasing, first point at 0).
+        float pitch_mm; ///< Pitch at this point in mm/rev (> 0).
+    };
+
     /**
      * @struct Config
      * @brief Configuration parameters for motion control.
@@ -42,6 +54,11 @@ public:
         uint32_t microsteps;     ///< Microstepping setting for the stepper driver (e.g., 8, 16).
         bool reverse_direction;  ///< If true, reverses the calculated direction of stepper motion.
         uint32_t sync_frequency; ///< Frequency (Hz) at which SyncTimer ISR runs to update stepper commands.
+        float thread_tpi = 0.0f; ///< Non-zero for imperial threads: thread_pitch is then 25.4 x starts / thread_tpi
+                                 ///< and the gearing is built from the exact TPI instead of the rounded mm value.
+        const PitchPoint *pitch_table = nullptr; ///< Optional variable-pitch profile (>= 2 points); the pitch is linear
+                                                 ///< between points and held beyond the ends. thread_pitch then only gives the sign.
+        uint8_t pitch_table_size = 0;            ///< Number of points in pitch_table (<= MAX_PITCH_PROFILE_POINTS).
     };
 
     /**
@@ -98,7 +115,7 @@ public:
         IDLE,      ///< System is idle, no motion.
         THREADING, ///< Thread cutting mode.
         TURNING,   ///< General turning/feeding mode.
-        FEEDING    ///< Potentially a distinct feeding mode (currently maps to TURNING behavior).
+        FEEDING    ///< Feed per minute: the carriage runs at a set speed, independent of the spindle.
     };
 
     // --- Constructors and Destructor ---
@@ -161,13 +178,96 @@ public:
      */
     void setMode(Mode mode);
 
+    /**
+     * @brief Requests a feed override for TURNING/FEEDING (ignored while THREADING).
+     * The override scales the gear ratio exactly (percent / 100). While motion runs, the applied
+     * value slews towards the request from update(), each step handed to the SyncTimer live.
+     * @param percent Requested override, clamped to the FEED_OVERRIDE_* limits.
+     */
+    void setFeedOverride(uint16_t percent);
+
+    /**
+     * @brief Sets the FEEDING mode carriage speed. A running feed ramps to it on its profile.
+     * @param speed_mm_per_min Speed in mm/min, clamped to 0..max_feed_rate. The feed override scales it.
+     */
+    void setFeedPerMinute(float speed_mm_per_min);
+
+    /**
+     * @brief Gets the FEEDING mode carriage speed in mm/min.
+     */
+    float getFeedPerMinute() const { return _feedPerMinute; }
+
+    /**
+     * @brief Gets the requested feed override in percent.
+     */
+    uint16_t getFeedOverride() const { return _feedOverrideTarget; }
+
+    /**
+     * @brief Gets the feed override currently applied to the gearing, in percent.
+     */
+    uint16_t getEffectiveFeedOverride() const { return _feedOverrideApplied; }
+
     // --- Motion Control ---
     /**
      * @brief Starts synchronized motion based on the current mode and configuration.
-     * Enables the stepper, encoder, and SyncTimer.
+     * Enables the stepper, encoder, and SyncTimer. With Motion::soft_engage, the Z axis ramps up
+     * to a turning spindle under Z_Axis::acceleration in PERIODIC or NCO mode (see
+     * SyncTimer::requestEngageRamp()); update() hands over to the configured sync path once the
+     * ramp has locked phase.
      */
     void startMotion();
 
+    /**
+     * @brief Starts synchronized motion locked to the spindle index.
+     * Configures everything like startMotion(), then arms the SyncTimer to engage at the first
+     * encoder count that is `indexPhaseCounts` past an index pulse and lies ahead of the spindle.
+     * The engagement itself happens in the TIM2 compare interrupt, so every pass starts at the
+     * same spindle phase. isElsActive() is true from the moment the engage point is armed.
+     * @param indexPhaseCounts Encoder counts after the index (taken modulo one spindle revolution).
+     * @return False if no index pulse has been latched yet, the encoder turns a fraction of a spindle
+     *         revolution per index (or the pulley ratio is inexact), or the engage point could not be armed.
+     */
+    bool startMotionAtIndex(uint32_t indexPhaseCounts);
+
+    /**
+     * @brief Re-engages threading in the groove of the previous pass ("virtual half-nut").
+     * Every threading stop records one exact point of the spindle-count/Z-step relation. The
+     * encoder keeps counting while the carriage is stopped, jogged or the spindle reversed, so
+     * from the carriage's current position the SyncTimer is armed at the next count (in the
+     * spindle's direction, whole spindle revolutions apart) where that relation reaches it again,
+     * with the matching step phase. The encoder is not reset.
+     * Re-engagement always runs on a software sync path, which can start mid-phase.
+     * @return False if there is no lock, the pitch changed since it was taken (the lock is then
+     *         released) or the engage point could not be armed.
+     */
+    bool startMotionLocked();
+
+    /**
+     * @brief True if a previous threading pass left a relation to re-engage with startMotionLocked().
+     */
+    bool hasThreadLock() const { return _threadLock.valid; }
+
+    /**
+     * @brief Forgets the thread lock, so the next threading start begins a new thread.
+     */
+    void releaseThreadLock() { _threadLock.valid = false; }
+
+    /**
+     * @brief Shifts the spindle phase reference of the running (or armed) sync by whole encoder counts
+     * in the spindle's direction of rotation, without moving or re-zeroing the carriage.
+     * While idle, shifts the thread lock instead, so the next startMotionLocked() cuts the other start.
+     * @param counts Encoder counts to shift by.
+     * @return False if there is nothing to shift (idle without a lock, or hardware gearing active).
+     */
+    bool shiftSpindlePhase(uint32_t counts);
+
+    /**
+     * @brief Encoder counts per spindle revolution (PPR x 4 x chuck/encoder pulley ratio).
+     * @param counts Receives the count, rounded down if the pulley ratio does not divide evenly.
+     * @return True if the count is exact.
+     */
+    bool getCountsPerSpindleRevolution(uint32_t &counts) const;
+
     /**
      * @brief Stops any ongoing synchronized motion.
      * Disables SyncTimer and stops the stepper.
@@ -209,6 +309,8 @@ public:
 
     /**
      * @brief Stops any active continuous jogging motion.
+     * The jog decelerates along its profile; synchronized motion in the ELS modes resumes
+     * from update() once the carriage has stopped.
      */
     void endContinuousJog();
 
@@ -218,6 +320,29 @@ public:
      */
     bool isJogActive() const;
 
+    // --- Positioning ---
+    /**
+     * @brief Moves the Z axis to an absolute stepper position along a planned acceleration profile.
+     * Synchronized motion is stopped first and, unless `resumeSync` is false, resumes from
+     * update() once the carriage is there, as after a jog.
+     * @param absoluteSteps Target in absolute stepper microsteps (TIM5-tracked position).
+     * @param speed_mm_per_min Cruise speed; 0 or above Z_Axis::max_feed_rate uses max_feed_rate.
+     * @param resumeSync False leaves synchronized motion off after the move (cycle returns).
+     * @return True if the move was started (or the carriage is already there).
+     */
+    bool moveToPositionSteps(int32_t absoluteSteps, float speed_mm_per_min = 0.0f, bool resumeSync = true);
+
+    /**
+     * @brief Decelerates a positioning move to a stop short of its target.
+     */
+    void abortPositioning();
+
+    /** @brief True while a positioning move is playing or decelerating. */
+    bool isPositioning() const { return _positioningActive; }
+
+    /** @brief Target of the last positioning move, absolute microsteps. */
+    int32_t getPositioningTargetSteps() const { return _positioningTargetSteps; }
+
     /**
      * @brief Checks if any ELS (Electronic Lead Screw) synchronized mode is active.
      * This includes THREADING, TURNING, or FEEDING modes.
@@ -232,6 +357,11 @@ public:
      */
     Status getStatus() const;
 
+    /**
+     * @brief Following-error statistics of the sync path since the last start (see SyncTimer::FollowingErrorStats).
+     */
+    SyncTimer::FollowingErrorStats getFollowingErrorStats() const { return _syncTimer.getFollowingErrorStats(); }
+
     /**
      * @brief Checks if the stepper motor driver is currently enabled.
      * @return True if the motor is enabled, false otherwise.
@@ -248,10 +378,15 @@ public:
     // --- Auto-Stop Feature Control (New) ---
     /**
      * @brief Configures the absolute target step position for the auto-stop feature.
+     * The stop is enforced by the SyncTimer ISR (SyncTimer::armStopAt()): it brakes under
+     * Z_Axis::acceleration early enough to come to rest on the target while the spindle turns.
+     * While armed, the gearing runs in PERIODIC or NCO mode only.
      * @param absoluteSteps The target position in absolute machine steps.
      * @param enable True to enable the auto-stop feature with this target, false to disable.
+     * @param startFeed If true and the feed is off in an ELS mode, enabling also starts it;
+     *        false only arms the stop for a start that follows (e.g. startMotionLocked()).
      */
-    void configureAbsoluteTargetStop(int32_t absoluteSteps, bool enable);
+    void configureAbsoluteTargetStop(int32_t absoluteSteps, bool enable, bool startFeed = true);
 
     /**
      * @brief Clears any configured absolute target stop and disables the feature.
@@ -265,6 +400,11 @@ public:
      */
     bool wasTargetStopReachedAndMotionHalted();
 
+    /**
+     * @brief Steps past the target (negative: short of it) the last auto-stop came to rest at.
+     */
+    int32_t getLastStopOvershootSteps() const { return _lastStopOvershootSteps; }
+
     /**
      * @brief Gets the current feed direction of the Z-axis.
      * @return The current FeedDirection.
@@ -273,10 +413,16 @@ public:
 
     /**
      * @brief Gets the current absolute position of the Z-axis stepper in microsteps.
+     * This is the carriage position: backlash take-up after a reversal is not counted.
      * @return Absolute stepper position in microsteps.
      */
     int32_t getCurrentPositionSteps() const;
 
+    /**
+     * @brief Backlash take-up steps still to run before the carriage follows a reversal.
+     */
+    uint32_t getBacklashTakeUpSteps() const;
+
     // --- Unit Conversion Utilities ---
     /**
      * @brief Converts a value from system units (mm or in) to absolute stepper steps.
@@ -303,9 +449,42 @@ private:
     Config _config;    ///< Current motion parameters.
     Mode _currentMode; ///< Current operational mode.
 
+    // Feed override
+    uint16_t _feedOverrideTarget;     ///< Requested override in percent.
+    uint16_t _feedOverrideApplied;    ///< Override the gearing currently runs with, in percent.
+    uint32_t _lastFeedOverrideSlewMs; ///< Time of the last slew step.
+
+    /**
+     * @brief One exact point of the last threading pass's gearing (see startMotionLocked()).
+     */
+    struct ThreadLock
+    {
+        bool valid;
+        int64_t count;        ///< Absolute encoder position of the point (EncoderTimer::getAbsolutePosition()).
+        int32_t position;     ///< Stepper position demanded at `count`.
+        int32_t phase;        ///< Bresenham phase at `count`.
+        uint32_t numerator;   ///< Ratio the relation was cut with.
+        uint32_t denominator;
+        bool reverse;
+    };
+    ThreadLock _threadLock;
+    bool _softEngaging; ///< startMotion() ramp still running; the gearing is held to the ticked paths.
+
+    // Variable-pitch profile handed to the SyncTimer (must outlive its config)
+    SyncTimer::PitchSegment _pitchSegments[SystemConfig::Limits::Motion::MAX_PITCH_PROFILE_POINTS - 1];
+
     // State
     volatile bool _running;   ///< True if synchronized motion is active.
     volatile bool _jogActive; ///< True if a manual jog operation is active.
+    bool _jogStopping;        ///< A jog is decelerating; update() releases the stepper when it has stopped.
+    JogDirection _pendingJogDirection; ///< Jog to start once the stop has finished (reversal).
+    float _pendingJogSpeed;            ///< mm/min for _pendingJogDirection.
+    volatile bool _positioningActive;  ///< A moveToPositionSteps() profile is playing.
+    int32_t _positioningTargetSteps;
+    bool _positioningResumesSync;      ///< update() restarts synchronized motion after the move.
+    float _feedPerMinute;              ///< FEEDING mode speed, mm/min.
+    bool _feedStopping;                ///< A timed feed is decelerating; update() releases the stepper.
+    bool _feedRestartPending;          ///< startMotion() arrived during _feedStopping.
     volatile bool _error;     ///< True if an error has occurred.
     const char *_errorMsg;    ///< Descriptive error message.
 
@@ -314,6 +493,7 @@ private:
     volatile bool _targetStopFeatureEnabledForMotion;   ///< True if auto-stop is armed in MotionControl.
     volatile int32_t _absoluteTargetStopStepsForMotion; ///< Target for auto-stop in absolute steps.
     volatile bool _targetStopReached;                   ///< Flag set when auto-stop condition met and halt initiated.
+    int32_t _lastStopOvershootSteps;                    ///< See getLastStopOvershootSteps().
 
     // Private methods
     /**
@@ -335,8 +515,100 @@ private:
     void updateSyncParameters();
 
     /**
-     * @brief Calculates the comprehensive steps_per_encoder_tick factor and
+     * @brief Reduces the drive chain to an exact GearRatio for the current pitch and
      * configures the SyncTimer with it.
+     * @param softwareOnly Skip the hardware gearing paths (they always start from phase 0).
+     */
+    void calculateAndSetSyncTimerConfig(bool softwareOnly = false);
+
+    /**
+     * @brief Arms SyncTimer::engageAt() at `target`, retrying `period` counts later (in the
+     * counting direction) if the spindle overtakes the engage point while it is being armed.
+     * @return True once armed.
+     */
+    bool armEngage(uint32_t target, uint32_t period, bool countingDown, int32_t phase = 0, int32_t catchUpSteps = 0);
+
+    /**
+     * @brief Records the running threading pass's gearing relation in _threadLock.
+     * Called just before the sync path is disabled.
+     */
+    void captureThreadLock();
+
+    /**
+     * @brief Ends a jog or positioning move, or the deceleration after one, at once.
+     */
+    void haltManualMove();
+
+    /**
+     * @brief Sets the stepper's acceleration, profile shape and backlash from the Z-axis settings.
+     * @param stepsPerMm Z-axis microsteps per mm.
+     */
+    void applyZProfile(float stepsPerMm);
+
+    /**
+     * @brief Loads Z_Axis::backlash_compensation into the stepper as take-up steps per reversal.
+     * @param stepsPerMm Z-axis microsteps per mm.
+     */
+    void applyZBacklash(float stepsPerMm);
+
+    /**
+     * @brief Encoder counts spanning a whole number of spindle revolutions: one revolution,
+     * or as many as it takes for an uneven pulley ratio to land on a whole count.
+     */
+    uint32_t spindlePeriodCounts() const;
+
+    /**
+     * @brief Sets _currentFeedDirection from the pitch sign and reverse_direction.
+     */
+    void updateFeedDirection();
+
+    /**
+     * @brief Converts _config.pitch_table into SyncTimer pitch segments over a common denominator.
+     * @param syncConfig Receives the starting ratio and the segments.
+     * @return False if the table is unusable (the caller then gears at thread_pitch).
+     */
+    bool buildPitchProfile(SyncTimer::SyncConfig &syncConfig);
+
+    /**
+     * @brief Z-axis microsteps per mm of carriage travel.
+     */
+    float zStepsPerMm() const;
+
+    /**
+     * @brief Starts the FEEDING mode feed as a planned jog, or as a bounded move onto an armed auto-stop.
+     */
+    void startTimedFeed();
+
+    /**
+     * @brief FEEDING mode step rate with the applied feed override.
+     */
+    float feedPerMinuteStepHz(float stepsPerMm) const;
+
+    /**
+     * @brief Moves the applied feed override one slew step towards the requested value.
+     */
+    void slewFeedOverride();
+
+    /**
+     * @brief Switches a SyncTimer config to HARDWARE_GEARING if the ratio is a whole number of
+     * steps per encoder line (or lines per step) and a burst can keep up at the maximum RPM.
+     * @param ratio The exact steps-per-count ratio.
+     * @param syncConfig The config to update; left untouched if hardware gearing is not possible.
+     * @return True if hardware gearing was selected.
+     */
+    bool planHardwareGearing(const GearRatio &ratio, SyncTimer::SyncConfig &syncConfig) const;
+
+    /**
+     * @brief Switches a SyncTimer config to COMPARE_DMA for fine feeds: at most one step per two
+     * encoder counts, with the step rate at maximum RPM inside the single-pulse limit.
+     * @param ratio The exact steps-per-count ratio.
+     * @param syncConfig The config to update; left untouched if compare DMA is not possible.
+     * @return True if compare DMA was selected.
+     */
+    bool planCompareDma(const GearRatio &ratio, SyncTimer::SyncConfig &syncConfig) const;
+
+    /**
+     * @brief Encoder lines per second at the configured maximum spindle RPM.
      */
-    void calculateAndSetSyncTimerConfig();
+    float maxEncoderLinesPerSecond() const;
 };
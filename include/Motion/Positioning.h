@@ -2,6 +2,13 @@
 
 #include <Arduino.h>
 
+class MotionControl;
+
+/**
+ * @brief Z-axis positioning: start/end bookkeeping, backlash settings, and planned
+ * go-to, move-by and return-to-start moves through MotionControl.
+ * Positions are in system units (mm or in) relative to the positioning zero.
+ */
 class Positioning {
 public:
     // Backlash compensation type
@@ -11,7 +18,7 @@ public:
         MANUAL       // Manual backlash settings
     };
     
-    Positioning();
+    explicit Positioning(MotionControl *motionControl = nullptr);
     ~Positioning() = default;
     
     // Configuration
@@ -30,8 +37,47 @@ public:
     float getEndPosition() const { return _endPosition; }
     float getDistanceToEnd(float currentPosition) const;
     float getCompensatedPosition(float position, bool movingPositive) const;
+
+    // Planned moves (need a MotionControl); speed 0 means rapid (Z_Axis::max_feed_rate)
+    /**
+     * @brief Moves to an absolute position relative to the positioning zero.
+     * @return True if the move was started.
+     */
+    bool goToAbsolute(float position, float speedMmPerMin = 0.0f);
+
+    /**
+     * @brief Moves by a signed distance from the current position.
+     * @return True if the move was started.
+     */
+    bool moveBy(float distance, float speedMmPerMin = 0.0f);
+
+    /**
+     * @brief Moves back to the start position (see setStartPosition() / setStartHere()).
+     * @return True if the move was started.
+     */
+    bool returnToStart(float speedMmPerMin = 0.0f);
+
+    /** @brief Decelerates a running move to a stop. */
+    void stopMove();
+
+    /** @brief True while a planned move is running. */
+    bool isMoving() const;
+
+    /** @brief True while the stepper takes up backlash after a reversal (the carriage is not moving yet). */
+    bool isTakingUpBacklash() const;
+
+    /** @brief Makes the current carriage position the positioning zero. */
+    void setZeroPosition();
+
+    /** @brief Records the current carriage position as the start position. */
+    void setStartHere();
+
+    /** @brief Current carriage position relative to the positioning zero. */
+    float getCurrentPosition() const;
     
 private:
+    MotionControl *_motionControl;
+    int32_t _zeroOffsetSteps;     // Stepper position of the positioning zero
     float _startPosition;         // Start position in mm
     float _endPosition;           // End position in mm
     float _backlashAmount;        // Backlash amount in mm
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @class SpindleObserver
+ * @brief Critically damped alpha-beta-gamma (g-h-k) tracker of the spindle encoder count.
+ *
+ * Run once per sync tick by the PERIODIC and NCO paths of SyncTimer. All three poles sit at
+ * Limits::Motion::OBSERVER_BANDWIDTH_HZ. The tick itself is integer only: the estimate is kept
+ * as a Q32 offset from the measured count, so the fractions fit in an int64 however far the
+ * spindle has turned, and the gains are Q30. configure() is the only float code.
+ */
+class SpindleObserver
+{
+public:
+    SpindleObserver();
+
+    /**
+     * @brief Recomputes the gains for a tick rate (float, off the ISR path).
+     * @param tickHz Rate update() will be called at.
+     */
+    void configure(uint32_t tickHz);
+
+    /**
+     * @brief Restarts the observer at rest at an encoder count.
+     */
+    void reset(uint32_t count);
+
+    /**
+     * @brief One tick: predict, then correct with the counts measured this tick.
+     * @param rawDelta Raw encoder counts since the previous tick.
+     */
+    void update(int32_t rawDelta);
+
+    /**
+     * @brief Overrides the velocity estimate, e.g. to start at a known spindle speed.
+     * @param countsPerTickQ32 Counts per tick, Q32.
+     */
+    void setVelocity(int64_t countsPerTickQ32) { _velocity = countsPerTickQ32; }
+
+    int64_t measured() const { return _measured; }         ///< Unwrapped encoder count.
+    int64_t offset() const { return _offset; }             ///< Estimate minus measured count, Q32.
+    int64_t velocity() const { return _velocity; }         ///< Counts per tick, Q32.
+    int64_t acceleration() const { return _acceleration; } ///< Counts per tick^2, Q32.
+
+private:
+    int64_t _measured;
+    int64_t _offset;
+    int64_t _velocity;
+    int64_t _acceleration;
+    int32_t _gainPosition;     ///< g, Q30.
+    int32_t _gainVelocity;     ///< h, Q30.
+    int32_t _gainAcceleration; ///< k, Q30 (already includes the usual factor of 2).
+};
@@ -3,6 +3,7 @@
 #include <Arduino.h>
 #include "stm32h7xx_hal.h"
 #include "Hardware/EncoderTimer.h"
+#include "Motion/SpindleObserver.h"
 #include <STM32Step.h>
 #include <HardwareTimer.h>
 
@@ -14,25 +15,121 @@
  * The ISR, `handleInterrupt()`, reads the encoder, calculates the required stepper motor
  * velocity (frequency) and number of steps for the next time interval, and commands the
  * hardware-driven stepper controller.
+ *
+ * In Mode::EDGE_TRIGGERED the periodic timer is idle; instead TIM2 compare channels are armed
+ * at the encoder counts where the next step becomes due, so work scales with spindle speed.
+ *
+ * In Mode::COMPARE_DMA a precomputed table of step positions is streamed into a TIM2 compare
+ * register by DMA and every match triggers a single TIM1 pulse, so each step lands on its
+ * exact encoder count with no ISR in the path.
+ *
+ * In Mode::NCO TIM1 runs a continuous pulse train whose rate is preloaded every tick from the
+ * filtered spindle velocity plus a phase correction from the TIM5 pulse count.
  */
 class SyncTimer
 {
 public:
+    /**
+     * @enum Mode
+     * @brief Selects what drives the gearing update.
+     */
+    enum class Mode
+    {
+        PERIODIC,         ///< TIM6 polls the encoder at `update_freq`.
+        EDGE_TRIGGERED,   ///< TIM2 compare events fire exactly at the next step boundary.
+        HARDWARE_GEARING, ///< TIM2 TRGO drives TIM1 directly; TIM6 only supervises direction and phase
+                          ///< (a reversal is followed within one supervisor period).
+        COMPARE_DMA,      ///< DMA-fed TIM2 compares fire one TIM1 pulse per step; TIM6 only supervises phase.
+                          ///< Forward-only: a reversal is noticed by the 1 kHz supervisor as phase loss.
+        NCO               ///< TIM1 runs continuously; TIM6 preloads its rate from velocity and phase error.
+    };
+
+    /**
+     * @struct PitchSegment
+     * @brief One piece of a variable-pitch profile: the ratio numerator moves linearly from the
+     * previous segment's end value to `end_numerator` over `length_steps` steps of thread travel.
+     */
+    struct PitchSegment
+    {
+        uint32_t length_steps;  ///< Thread travel covered by this segment, in steps (> 0).
+        uint32_t end_numerator; ///< Ratio numerator at the end of the segment (same denominator).
+    };
+
+    /**
+     * @struct SyncConfig
+     * @brief Electronic gearing parameters.
+     * `ratio_numerator` steps are generated for every `ratio_denominator` encoder counts
+     * (see GearRatio). Both terms must be <= GearRatio::MAX_TERM.
+     */
     struct SyncConfig
     {
-        uint32_t steps_per_encoder_tick_scaled;
-        uint32_t scaling_factor;
-        uint32_t update_freq;
+        uint32_t ratio_numerator;   ///< Steps per `ratio_denominator` encoder counts.
+        uint32_t ratio_denominator; ///< Encoder counts per `ratio_numerator` steps. Never 0.
+        uint32_t update_freq;       ///< PERIODIC mode ISR rate (Hz).
         bool reverse_direction;
+        Mode mode;
+        uint32_t chain_triggers_per_step; ///< HARDWARE_GEARING: encoder lines per step (divide ratio).
+        uint32_t chain_steps_per_trigger; ///< HARDWARE_GEARING: steps per encoder line (multiply ratio).
+        uint32_t chain_burst_freq;        ///< HARDWARE_GEARING / COMPARE_DMA: pulse rate of a triggered burst (Hz).
+        // Optional variable-pitch profile (PERIODIC, EDGE_TRIGGERED and NCO only). `ratio_numerator`
+        // is then the starting numerator; the array must outlive the config. Travel is counted from
+        // the point the config is adopted, positive for forward spindle rotation.
+        const PitchSegment *pitch_segments;
+        uint8_t pitch_segment_count;
 
-        SyncConfig() : steps_per_encoder_tick_scaled(0),
-                       scaling_factor(1),
+        SyncConfig() : ratio_numerator(0),
+                       ratio_denominator(1),
                        update_freq(10000),
-                       reverse_direction(false)
+                       reverse_direction(false),
+                       mode(Mode::PERIODIC),
+                       chain_triggers_per_step(1),
+                       chain_steps_per_trigger(1),
+                       chain_burst_freq(0),
+                       pitch_segments(nullptr),
+                       pitch_segment_count(0)
         {
         }
     };
 
+    /**
+     * @struct SyncState
+     * @brief One exact point of the gearing relation: at encoder count `count` the sync path
+     * demands stepper position `position` with Bresenham phase `phase`.
+     */
+    struct SyncState
+    {
+        uint32_t count;   ///< Raw encoder count (a pending phase shift is already folded in).
+        int32_t position; ///< Stepper position demanded at `count`.
+        int32_t phase;    ///< Bresenham phase at `count`, in [0, ratio_denominator).
+    };
+
+    /**
+     * @struct ObserverState
+     * @brief Spindle observer estimate, in raw encoder counts (positive counting up).
+     */
+    struct ObserverState
+    {
+        float position;     ///< Estimated count, with sub-count interpolation (absolute, low word precision).
+        float velocity;     ///< Counts per second.
+        float acceleration; ///< Counts per second squared.
+        bool valid;         ///< False unless PERIODIC or NCO sync is running.
+    };
+
+    /**
+     * @struct FollowingErrorStats
+     * @brief Steps the sync path has commanded that the stepper (TIM5 pulse count) has not delivered,
+     * sampled every sync tick (every step boundary in EDGE_TRIGGERED) since engagement or the last
+     * resetFollowingErrorStats(). Positive: the stepper lags in its positive direction.
+     */
+    struct FollowingErrorStats
+    {
+        int32_t current;
+        int32_t min;
+        int32_t max;
+        float rms;
+        uint32_t samples;
+    };
+
     SyncTimer();
     ~SyncTimer();
 
@@ -41,6 +138,83 @@ public:
     void enable(bool enable);
     bool isEnabled() const { return _enabled; }
 
+    /**
+     * @brief Arms the sync path to engage when the encoder counter reaches `count`.
+     * The TIM2 CH3/CH4 compares fire at that count and the gearing takes the compare count
+     * itself as its origin, so the engagement phase does not depend on interrupt latency.
+     * HARDWARE_GEARING, COMPARE_DMA and NCO need timer re-initialisation that does not belong in
+     * the compare interrupt, so an engagement armed in those modes runs as PERIODIC.
+     * enable(false) cancels a pending engagement.
+     * @param count Encoder count to engage at; must lie ahead in the current counting direction.
+     * @param initialPhase Bresenham phase at `count`, in [0, ratio_denominator).
+     * @param catchUpSteps Steps commanded on top of the gearing at engagement.
+     * @return False if not initialized, already enabled, or the counter has already passed `count`.
+     */
+    bool engageAt(uint32_t count, int32_t initialPhase = 0, int32_t catchUpSteps = 0);
+
+    /**
+     * @brief Makes the next engagement ramp up instead of demanding synchronous speed at once.
+     * The steps the gearing yields are owed to the stepper, which accelerates at `acceleration`
+     * toward the spindle's synchronous speed plus a catch-up term for the steps owed. The
+     * catch-up is bounded to ENGAGE_CATCHUP_FRACTION of the synchronous speed, or ENGAGE_CATCHUP_MIN_HZ
+     * if that is more. Once nothing is owed and the speed matches, the gearing output goes straight
+     * out again. PERIODIC and NCO only; other modes engage as usual.
+     * @param acceleration Steps/s^2; 0 cancels the request.
+     * @param spindleCountsPerSecond Current spindle speed, to seed the observer so the ramp knows
+     *                               its target from the first tick.
+     */
+    void requestEngageRamp(float acceleration, float spindleCountsPerSecond);
+
+    /**
+     * @brief True while an engagement ramp is still catching up with the spindle.
+     */
+    bool isEngageRampActive() const { return _rampActive; }
+
+    /**
+     * @brief True while an engageAt() compare is armed and has not fired yet.
+     */
+    bool isEngagePending() const { return _engagePending; }
+
+    /**
+     * @brief Moves the gearing's encoder origin by a whole number of counts (e.g. to index to the
+     * next start of a multi-start thread) without re-zeroing anything.
+     * A pending engageAt() simply engages `counts` later. While running in a software mode, the
+     * next `counts` encoder counts in that direction are absorbed without stepping, so the
+     * carriage dwells instead of jumping; the phase relation is exact once they are absorbed.
+     * @param counts Signed raw encoder counts; use the spindle's counting direction.
+     * @return False when idle or in HARDWARE_GEARING / COMPARE_DMA (steps generated in hardware).
+     */
+    bool shiftPhaseOrigin(int32_t counts);
+
+    /**
+     * @brief Encoder counts of a shiftPhaseOrigin() still to be absorbed.
+     */
+    int32_t getPendingPhaseShift() const { return _phaseShiftRemaining; }
+
+    /**
+     * @brief Reads the current point of the gearing relation, e.g. to re-engage in phase later.
+     * @param state Filled in on success.
+     * @return False when idle, with an engagement still pending, during an engagement ramp, or with
+     *         a variable-pitch profile (whose relation is not a single ratio).
+     */
+    bool getSyncState(SyncState &state) const;
+
+    const SyncConfig &getConfig() const { return _config; }
+
+    /**
+     * @brief Reads the spindle observer (telemetry, RPM display).
+     */
+    ObserverState getObserverState() const;
+
+    /**
+     * @brief Applies a new sync configuration.
+     * While running in PERIODIC, EDGE_TRIGGERED or NCO mode with an unchanged mode, the config
+     * is handed to the ISR through a double-buffered, sequence-counted slot and takes effect at
+     * the next sync period (or step boundary) without stopping; the step phase is carried over.
+     * Any other change restarts the sync path from the count the old path had geared up to, with
+     * the phase and any steps still owed carried over. While running, a HARDWARE_GEARING or
+     * COMPARE_DMA config runs as PERIODIC instead: those paths only start from a fresh engagement.
+     */
     void setConfig(const SyncConfig &config);
     void setSyncFrequency(uint32_t freq);
 
@@ -48,6 +222,56 @@ public:
     uint32_t getLastUpdateTime() const { return _lastUpdateTime; }
     uint32_t getTimerFrequency() const { return _timerFrequency; }
     bool isInitialized() const { return _initialized; }
+    Mode getActiveMode() const { return _config.mode; }
+
+    /**
+     * @brief Arms a precise stop at an absolute stepper position, enforced in the PERIODIC and NCO ticks.
+     * Each tick compares the distance left with the braking distance v^2/2a at the current step
+     * rate. Once within it, the output leaves the gearing and follows sqrt(2 a d) down to zero
+     * exactly at `position` while the spindle keeps turning. Only approaching the target starts a
+     * stop. The gearing relation itself runs on, so getSyncState() (and a thread lock cut from it)
+     * stays valid. Stays armed across engagements until disarmStop().
+     * @param position Absolute stepper position to stop at.
+     * @param deceleration Braking deceleration in steps/s^2.
+     */
+    void armStopAt(int32_t position, float deceleration);
+
+    /**
+     * @brief Cancels an armed stop. A stop that is already braking still completes.
+     */
+    void disarmStop() { _stopArmed = false; }
+
+    bool isStopBraking() const { return _braking; }
+
+    /**
+     * @brief True once a braked stop has ended on its target and TIM5 shows the stepper at rest.
+     */
+    bool isStopSettled() const { return _stopSettled; }
+
+    /**
+     * @brief Delivered minus target position of the last settled stop, positive past the target.
+     */
+    int32_t getStopOvershoot() const { return _stopOvershoot; }
+
+    /**
+     * @brief Sets the following error that trips the monitor (see hasFollowingErrorTrip()).
+     * @param steps Largest tolerated |demanded - delivered|; 0 disables the trip (statistics are kept regardless).
+     */
+    void setFollowingErrorLimit(int32_t steps) { _followingErrorLimit = steps; }
+
+    FollowingErrorStats getFollowingErrorStats() const;
+    void resetFollowingErrorStats();
+
+    /**
+     * @brief True once the following error has exceeded the limit since engagement. The sync path
+     * keeps running; the owner decides how to stop.
+     */
+    bool hasFollowingErrorTrip() const { return _followingErrorTripped; }
+
+    /**
+     * @brief Number of times hardware gearing or compare DMA lost phase and handed over to PERIODIC mode.
+     */
+    uint32_t getHardwareGearingFallbacks() const { return _hardwareGearingFallbacks; }
 
     // Debugging
     volatile uint32_t _debug_interrupt_count;
@@ -66,7 +290,20 @@ protected:
      */
     void handleInterrupt();
 
+    /**
+     * @brief TIM2 step-boundary compare handler (Mode::EDGE_TRIGGERED).
+     * Consumes the encoder movement up to the live count, commands the steps that became
+     * due and re-arms the compares at the next forward/backward boundaries.
+     */
+    void handleStepBoundary();
+
 private:
+    /**
+     * @brief Entries in the COMPARE_DMA ring (two per step). Each half gives the refill
+     * interrupt COMPARE_TABLE_LENGTH / 4 steps of slack.
+     */
+    static constexpr uint32_t COMPARE_TABLE_LENGTH = 64;
+
     HardwareTimer *_timer;
 
     volatile bool _enabled;
@@ -80,11 +317,289 @@ private:
     EncoderTimer *_encoder;
     STM32Step::Stepper *_stepper;
 
-    int64_t _desiredSteps_scaled_accumulated;
+    // Bresenham gearing state, precomputed from _config so the ISR only adds and compares.
+    int32_t _stepsPerCountWhole;     ///< numerator / denominator.
+    int32_t _stepsPerCountRemainder; ///< numerator % denominator.
+    int32_t _ratioDenominator;       ///< Cached denominator.
+    int32_t _stepAccumulator;        ///< Fractional step phase, always in [0, _ratioDenominator).
+    int32_t _commandedPosition;      ///< Stepper position demanded so far (software modes).
+    int32_t _subCountSteps;          ///< Steps commanded past _commandedPosition for the interpolated fraction of a count.
     int32_t _isr_lastEncoderCount;
     uint32_t _previousSpindlePosition;
+    uint32_t _lastBoundaryMicros; ///< Time of the previous step-boundary event (EDGE_TRIGGERED).
+
+    // HARDWARE_GEARING supervision
+    uint32_t _hwOriginCount;                      ///< Encoder count when the trigger chain was engaged.
+    int32_t _hwOriginSteps;                       ///< Stepper position when the trigger chain (or NCO) was engaged.
+    bool _hwCountingDown;                         ///< Encoder direction the DIR pin currently follows.
+    int32_t _hwErrorToleranceSteps;               ///< Phase error that forces a fallback to PERIODIC.
+    volatile uint32_t _hardwareGearingFallbacks;  ///< See getHardwareGearingFallbacks().
+
+    // COMPARE_DMA table generator; runs ahead of the encoder, so it has its own Bresenham phase.
+    uint32_t _compareTable[COMPARE_TABLE_LENGTH]; ///< DMA ring of compare positions (must not be in DTCM; cleaned from the D-cache on refill).
+    uint32_t _compareStepCount;                   ///< Encoder count of the last step written to the table.
+    int32_t _compareAccumulator;                  ///< Bresenham phase at _compareStepCount.
+    bool _comparePendingFall;                     ///< Next entry is the falling edge of the last step.
+
+    // NCO loop
+    int32_t _ncoDemandedSteps; ///< Exact steps demanded by the encoder since the NCO was started.
+    float _ncoVelocity;        ///< Feed-forward step rate in steps/s (signed).
+    float _ncoStepsPerCount;   ///< Ratio as a float, for the velocity feed-forward only.
+
+    // Variable-pitch profile, walked incrementally per step so the ISR never divides by segment length
+    uint8_t _profileSegment;         ///< Current segment index.
+    int32_t _profileStepInSegment;   ///< Steps into the current segment, in [0, length].
+    int32_t _profileBeyond;          ///< Steps past the last (> 0) or before the first (< 0) segment.
+    int32_t _profileNumerator;       ///< Ratio numerator at the current position.
+    int32_t _profileSlopeWhole;      ///< floor(delta numerator / length).
+    int32_t _profileSlopeRemainder;  ///< delta numerator mod length, in [0, length).
+    int32_t _profileSlopeAccumulator;
+
+    // Spindle observer run by the PERIODIC and NCO ticks
+    SpindleObserver _observer;
+    int32_t _obsLeadCounts;       ///< Whole counts the PERIODIC gearing runs ahead of the encoder.
+    volatile bool _obsRunning;
+
+    // Following-error monitor (see getFollowingErrorStats())
+    int32_t _followingErrorLimit;
+    int32_t _followingError;
+    int32_t _followingErrorMin;
+    int32_t _followingErrorMax;
+    uint64_t _followingErrorSumSquares;
+    uint32_t _followingErrorSamples;
+    volatile bool _followingErrorTripped;
+
+    // Precise stop (see armStopAt())
+    volatile bool _stopArmed;
+    int32_t _stopTarget;
+    float _stopDeceleration;       ///< Steps/s^2.
+    volatile bool _braking;        ///< Output has left the gearing and is braking onto _stopTarget.
+    volatile bool _stopReached;    ///< Braking has commanded the last step.
+    volatile bool _stopSettled;
+    int32_t _brakePosition;        ///< Stepper position commanded so far while braking.
+    int32_t _brakeDirection;       ///< +1 or -1, toward the target.
+    float _brakeVelocity;          ///< Steps/s, >= 0.
+    float _brakeCarry;
+    int32_t _stopLastDelivered;
+    uint32_t _stopQuietTicks;      ///< Consecutive ticks with nothing to emit and nothing delivered.
+    volatile int32_t _stopOvershoot;
+
+    // Engagement ramp (see requestEngageRamp())
+    bool _rampRequested;
+    float _rampAcceleration;     ///< Steps/s^2.
+    float _rampSeedCountsPerSecond;
+    volatile bool _rampActive;
+    float _rampVelocity;         ///< Current step rate, steps/s (signed, step direction).
+    float _rampCarry;            ///< Fraction of a step not yet emitted.
+    int32_t _rampDeficit;        ///< Steps the gearing has demanded that the ramp has not emitted yet.
+
+    // Compare-triggered engagement (see engageAt())
+    volatile bool _engagePending;
+    uint32_t _engageCount;
+    int32_t _engagePhase;
+    int32_t _catchUpSteps; ///< Added to the first steps the gearing yields after engagement.
+
+    volatile int32_t _phaseShiftRemaining; ///< Raw counts still to absorb (see shiftPhaseOrigin()).
+
+    // Live config hand-off (see setConfig())
+    SyncConfig _configSlots[2];          ///< Written by setConfig(), slot (sequence & 1) is the latest.
+    volatile uint32_t _configSequence;   ///< Bumped after a slot is fully written.
+    uint32_t _appliedSequence;           ///< Last sequence the ISR picked up.
 
     bool initTimer();
+
+    /**
+     * @brief Restarts the observer at rest at an encoder count, with no feed-forward lead.
+     */
+    void resetObserver(uint32_t count);
+
+    /**
+     * @brief Enables the sync path for _config.mode, starting from the given step phase.
+     * @param initialPhase Bresenham phase in [0, _ratioDenominator).
+     * @param origin Encoder count the gearing starts from.
+     * @param fromCompare True when called from the engageAt() compare interrupt.
+     */
+    void engage(int32_t initialPhase, uint32_t origin, bool fromCompare = false);
+
+    /**
+     * @brief Takes the part of a raw encoder delta that goes into a pending phase shift.
+     * @return Counts absorbed (same sign as countDelta, or 0); subtract from the delta.
+     */
+    int32_t absorbPhaseShift(int32_t countDelta);
+
+    /**
+     * @brief engageAt() compare fired: engages from the armed count.
+     */
+    void handleEngageCompare();
+
+    /**
+     * @brief Recomputes the cached Bresenham terms from _config.
+     */
+    void applyRatio();
+
+    /**
+     * @brief Rewinds the variable-pitch profile (if any) to its start.
+     */
+    void resetPitchProfile();
+
+    /**
+     * @brief Loads the slope of profile segment `index` (from the previous segment's end numerator).
+     */
+    void loadPitchSegment(uint8_t index);
+
+    /**
+     * @brief Moves the variable-pitch profile by a number of steps of thread travel and
+     * updates the cached ratio terms (one 32-bit divide) if the numerator changed.
+     * @param steps Signed travel, positive for forward spindle rotation.
+     */
+    void advancePitchProfile(int32_t steps);
+
+    /**
+     * @brief Maps the current step phase onto a new ratio denominator.
+     */
+    int32_t rescalePhase(uint32_t newDenominator) const;
+
+    /**
+     * @brief After a hardware path has stopped: sets the phase, and the steps still owed, from
+     * the exact demand at the live count.
+     * @return The count the demand was taken at, i.e. the origin for the next path.
+     */
+    uint32_t settleHardwareDemand();
+
+    /**
+     * @brief ISR side of the live hand-off: adopts the newest published config, if any.
+     * Called only after the counts seen so far have been consumed with the old ratio.
+     */
+    void applyPendingConfig();
+
+    /**
+     * @brief Advances the gearing accumulator by a signed number of encoder counts.
+     * @param countDelta Encoder counts since the last call, already direction-corrected.
+     * @return Whole steps that became due (signed).
+     */
+    int32_t advanceGearing(int32_t countDelta);
+
+    /**
+     * @brief advanceGearing() along a variable-pitch profile: each count is geared at the pitch
+     * where it starts, and a reverse count undoes a forward one exactly.
+     * @param countDelta Encoder counts, already direction-corrected.
+     * @return Whole steps that became due (signed).
+     */
+    int32_t advanceProfileGearing(int32_t countDelta);
+
+    /**
+     * @brief Moves the sub-count step target to the interpolated spindle position.
+     * Only below one count per tick (no observer lead), with no phase shift being absorbed and
+     * no variable-pitch profile; otherwise the target is 0. With no line period to interpolate
+     * and no counts this tick, the target is held rather than stepped back.
+     * @param spindlePosition Raw count just consumed by the gearing.
+     * @param countDelta Raw counts consumed this tick.
+     * @return Change in the target, to command on top of the gearing's steps.
+     */
+    int32_t interpolateSubCount(uint32_t spindlePosition, int32_t countDelta);
+
+    /**
+     * @brief Stepper position commanded so far by the ticked paths (gearing, sub-count, ramp, stop).
+     */
+    int32_t emittedPosition() const;
+
+    /**
+     * @brief Passes the steps to command this tick through the precise stop, if one is armed.
+     * @param steps Steps the gearing and ramp yielded this tick (already in emittedPosition()).
+     * @return Steps to command this tick.
+     */
+    int32_t brakeSteps(int32_t steps);
+
+    /**
+     * @brief After a stop has commanded its last step, waits for TIM5 to show the stepper at rest
+     * and records the overshoot.
+     */
+    void superviseStop();
+
+    /**
+     * @brief Adds one following-error sample and checks it against the limit (ISR).
+     * @param error Demanded minus delivered stepper position.
+     */
+    void recordFollowingError(int32_t error);
+
+    /**
+     * @brief Synchronous step rate (steps/s, step direction) from the observer velocity.
+     */
+    float observerStepRate() const;
+
+    /**
+     * @brief Passes the steps due this tick through the engagement ramp, if one is active.
+     * @param dueSteps Steps the gearing (and sub-count interpolation) yielded this tick.
+     * @return Steps to command this tick.
+     */
+    int32_t rampSteps(int32_t dueSteps);
+
+    /**
+     * @brief Encoder counts (>= 1) until the gearing yields the next whole step.
+     * Only called at step boundaries, so the division here is off the per-count path.
+     * @param accumulator Bresenham phase to start from, in [0, _ratioDenominator).
+     * @param stepForward True for counts that advance the step accumulator, false for counts that rewind it.
+     * @return Count distance, or 0 if the ratio never produces a step.
+     */
+    uint32_t countsToNextStep(int32_t accumulator, bool stepForward) const;
+
+    /**
+     * @brief Arms the encoder compares at the next step boundaries around _previousSpindlePosition.
+     * @return False if the live counter already reached one of the new boundaries (caller must re-run).
+     */
+    bool armNextStepBoundaries();
+
+    /**
+     * @brief Engages the TIM2 -> TIM1 trigger chain from the current encoder/stepper positions.
+     * @return False if the chain could not be started (caller falls back to PERIODIC).
+     */
+    bool startHardwareGearing();
+
+    /**
+     * @brief Engages COMPARE_DMA: TIM1 fires one pulse per TIM2 TRGO edge and the compare
+     * table is started at the next step after the current encoder position.
+     * Only ratios of at most one step per two counts, in the forward direction, are supported.
+     * @return False if the ratio is unsupported or the spindle outran the first compare.
+     */
+    bool startCompareDmaGearing();
+
+    /**
+     * @brief COMPARE_DMA table generator (EncoderTimer::CompareTableRefill).
+     * Emits a rising entry at each step position followed by a falling entry one count later.
+     */
+    void fillCompareTable(uint32_t *entries, uint32_t count);
+
+    /**
+     * @brief Detaches the trigger chain and stops any compare DMA (TIM2 TRGO returns to line edges).
+     */
+    void stopHardwareGearing();
+
+    /**
+     * @brief Low-rate TIM6 task in HARDWARE_GEARING and COMPARE_DMA modes.
+     * Follows spindle reversals on the DIR pin (HARDWARE_GEARING only) and compares the exact
+     * demanded position with the TIM5 pulse count; a phase error beyond tolerance, or backlash
+     * left to take up after a reversal, hands over to PERIODIC mode.
+     */
+    void superviseHardwareGearing();
+
+    /**
+     * @brief Starts the TIM1 NCO from the current encoder/stepper positions.
+     * @return False if the stepper could not start the oscillator.
+     */
+    bool startNco();
+
+    /**
+     * @brief TIM6 task in NCO mode.
+     * Advances the exact demanded position, filters the spindle velocity as feed-forward and adds
+     * a proportional correction on (demanded - TIM5 delivered) steps. A sign change of the command
+     * halts the pulse train on a period boundary, flips DIR and restarts it.
+     */
+    void updateNco();
+
+    /**
+     * @brief Maps an encoder counting direction to the step direction, honouring reverse_direction.
+     */
+    bool stepDirectionFor(bool encoderCountingDown) const;
     void calculateTimerParameters(uint32_t freq, uint32_t &prescaler, uint32_t &period);
 
     static SyncTimer *instance;
@@ -41,6 +41,16 @@ public:
         bool valid;           // Position data valid flag
     };
 
+    // Multi-pass cycle: thread to the auto-stop target, wait for the X retract, rapid back to the
+    // start Z with the spindle turning, re-engage in the same groove
+    enum class CycleState
+    {
+        IDLE,      // No cycle; passes are started by hand
+        THREADING, // Pass in progress (or its engagement armed)
+        RETRACT,   // Stopped at the target; the return starts after thread_cycle_retract_ms
+        RETURNING  // Planned move back to the start Z at max_feed_rate
+    };
+
     ThreadingMode();
     ~ThreadingMode();
 
@@ -49,6 +59,42 @@ public:
     void setPositions(const Position &positions);
     void enableMultiStart(bool enable);
 
+    // Variable pitch (feed screws, special worms). Pitches are leads in mm; Z is measured along the
+    // feed from the point where sync engages. Cleared by clearVariablePitch().
+    void setProgressivePitch(float start_pitch_mm, float end_pitch_mm, float length_mm); // Linear start -> end
+    bool setPitchTable(const MotionControl::PitchPoint *points, uint8_t count);          // Piecewise-linear
+    void clearVariablePitch();
+    bool isVariablePitch() const { return _pitchTableSize >= 2; }
+
+    // Progressive pitch from the HMI: the selected lead ramps linearly to the end lead over the
+    // length (both in mm), and follows a newly selected lead
+    void setUiProgressivePitchEnabled(bool enabled);
+    void setUiProgressiveEndPitchFromString(const char *valueStr);
+    void setUiProgressiveLengthFromString(const char *valueStr);
+    bool isUiProgressivePitchEnabled() const { return _ui_progressiveEnabled; }
+    String getFormattedUiProgressivePitch() const; // e.g. "1.000>1.500/40"
+
+    // Index-locked start: passes engage this many encoder counts after the spindle index
+    void setIndexEngagePhase(uint32_t counts);
+    uint32_t getIndexEngagePhase() const { return _indexEngagePhaseCounts; }
+
+    // Multi-start: shift the spindle phase reference by one revolution / starts for the next start
+    // start() refuses any start but the first unless it can engage on the index or a thread lock
+    bool indexToNextStart();                              // Wraps back to the first start after the last
+    uint8_t getCurrentStart() const { return _currentStart; } // 0-based
+
+    // Virtual half-nut: start() re-engages in the previous pass's groove until this is called
+    void startNewThread();
+
+    // Multi-pass cycle
+    bool cycleStart();                 // Arms the first pass at the current Z; needs an auto-stop target
+    void cycleAbort();                 // Leaves the cycle; a running pass keeps its auto-stop
+    void cycleFinish();                // Final depth reached: run the spring passes, then end back at the start
+    CycleState getCycleState() const { return _cycleState; }
+    uint32_t getCyclePasses() const { return _cyclePasses; }                 // Completed passes
+    uint8_t getSpringPassesLeft() const { return _cycleSpringPassesLeft; }
+    bool isCycleFinishing() const { return _cycleFinishing; }
+
     // Operation
     bool begin(MotionControl *motion_control);
     void end();
@@ -101,6 +147,21 @@ private:
     ThreadData _threadData;
     Position _positions;
 
+    // Variable-pitch profile (empty for constant pitch)
+    MotionControl::PitchPoint _pitchTable[SystemConfig::Limits::Motion::MAX_PITCH_PROFILE_POINTS];
+    uint8_t _pitchTableSize;
+
+    // Progressive pitch as set on the HMI (applied through setProgressivePitch())
+    bool _ui_progressiveEnabled;
+    float _ui_progressiveEndPitchMm;
+    float _ui_progressiveLengthMm;
+    void applyUiProgressivePitch();
+
+    uint32_t _indexEngagePhaseCounts; // Encoder phase after the index at which passes engage
+    uint8_t _currentStart;            // Start being cut (0-based), see indexToNextStart()
+
+    uint32_t startPhaseCounts(uint8_t start, uint32_t countsPerRev) const; // Phase offset of a start
+
     // Z-Axis Auto-Stop State (UI-level)
     bool _ui_autoStopEnabled;            // Reflects the HMI toggle for this mode's auto-stop
     int32_t _ui_targetStopAbsoluteSteps; // Target stop position in absolute machine steps
@@ -113,7 +174,17 @@ private:
     bool _error;
     const char *_errorMsg;
 
+    // Multi-pass cycle state
+    CycleState _cycleState;
+    int32_t _cycleStartSteps;       // Z every pass starts from, absolute steps
+    uint32_t _cyclePasses;
+    uint32_t _cycleStopMs;          // millis() when the current pass reached the stop
+    bool _cycleFinishing;           // cycleFinish() called: counting down spring passes
+    uint8_t _cycleSpringPassesLeft;
+
     // Helper methods
+    bool engageInGroove();          // Thread lock, else index; false if neither can engage
+    void updateCycle();
     void configureThreading();
     float convertToMetricPitch(float imperial_tpi) const;
     void handleError(const char *msg);
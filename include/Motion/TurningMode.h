@@ -23,6 +23,25 @@ public:
         bool valid;           // Position data valid flag
     };
 
+    // Semi-auto cycle: feed to the auto-stop target, rapid back to the start Z, wait for re-arm
+    enum class CycleState
+    {
+        IDLE,      // No cycle; turning behaves as in MANUAL
+        FEEDING,   // Synchronized feed towards the auto-stop target
+        RETRACT,   // Stopped at the target; the return leg starts after cycle_return_delay_ms
+        RETURNING, // Planned move back to the start Z at max_feed_rate
+        WAITING    // Back at the start with the feed off, until cycleStart() re-arms
+    };
+
+    struct CycleStats
+    {
+        uint32_t passes;       // Completed passes since the cycle was first armed
+        uint32_t lastFeedMs;   // Feed of the last pass, arm to stop
+        uint32_t lastReturnMs; // Stop to back at the start, retract delay included
+        uint32_t lastPassMs;   // Arm to back at the start
+        uint32_t totalMs;      // Sum of lastPassMs over all passes
+    };
+
     TurningMode();
     ~TurningMode();
 
@@ -30,6 +49,8 @@ public:
     void selectNextFeedRate();
     void selectPreviousFeedRate();
     void setFeedRateMetric(bool isMetric);
+    void adjustFeedOverride(int32_t prevNextValue); // 1 = decrease, 2 = increase, 0 = back to 100 %
+    uint16_t getFeedOverride() const;               // Override currently applied to the feed, in percent
     void setMode(Mode mode);
     void setPositions(const Position &positions);
 
@@ -73,6 +94,18 @@ public:
     bool isAutoStopCompletionPendingHmiSignal() const;                // Check if HMI signal is pending
     void clearAutoStopCompletionHmiSignal();                          // Clear the HMI signal flag
 
+    // --- Feed Per Minute ---
+    void setFeedPerMinuteEnabled(bool enabled);                      // Switches between mm/rev and timed (mm/min) feed
+    bool isFeedPerMinuteEnabled() const { return _feedPerMinuteEnabled; }
+    void setFeedPerMinuteFromString(const char *valueStr);           // mm/min or in/min per measurement unit
+    String getFormattedFeedPerMinute() const;                        // Rate in the display unit, for HMI
+
+    // --- Semi-Auto Cycle ---
+    bool cycleStart();                                          // Arms the first pass or re-arms the next one
+    void cycleAbort();                                          // Leaves the cycle; a running feed keeps its auto-stop
+    CycleState getCycleState() const { return _cycleState; }
+    const CycleStats &getCycleStats() const { return _cycleStats; }
+
     // Mode activation/deactivation
     void activate();   // Call when entering Turning Tab
     void deactivate(); // Call when leaving Turning Tab
@@ -87,6 +120,7 @@ private:
     Position _positions;
     int32_t _z_axis_zero_offset_steps; // For Z-axis zeroing
     bool _feedDirectionTowardsChuck;   // True if feeding towards chuck, false if away (default)
+    bool _feedPerMinuteEnabled;        // Feed at MotionControl's feed-per-minute instead of following the spindle
 
     // Z-Axis Auto-Stop State (UI-level)
     bool _ui_autoStopEnabled;            // Reflects the HMI toggle for this mode's auto-stop
@@ -100,7 +134,17 @@ private:
     // Auto-stop HMI signaling
     bool _autoStopCompletionPendingHmiSignal;
 
+    // Semi-auto cycle state
+    CycleState _cycleState;
+    int32_t _cycleStartSteps;     // Z the cycle returns to, absolute steps
+    uint32_t _cyclePassStartMs;   // millis() when the current pass was armed
+    uint32_t _cycleStopMs;        // millis() when the current pass reached the stop
+    CycleStats _cycleStats;
+
     // Helper methods
+    MotionControl::Mode motionMode() const;
+    void updateCycle();
+    void finishCyclePass();
     // void configureFeedRate(); // Moved to public
     void handleEndPosition();
     void handleError(const char *msg);
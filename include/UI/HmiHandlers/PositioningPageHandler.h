@@ -0,0 +1,35 @@
+#pragma once
+
+#include "LumenProtocol.h"      // For lumen_packet_t
+#include "Motion/Positioning.h" // For Positioning
+
+class PositioningPageHandler
+{
+public:
+    // Public Interface
+    static void init(Positioning *positioning);
+    static void onEnterPage();
+    static void onExitPage();
+    static void handlePacket(const lumen_packet_t *packet);
+    static void update();
+
+private:
+    // Dependencies
+    static Positioning *_positioning;
+
+    // State
+    static float _increment;       ///< Move-by distance, system units
+    static bool _lastShownMoving;  ///< Status last sent to the HMI
+    static bool _lastShownTakeUp;  ///< "TAKE-UP" last sent: the move is still taking up backlash
+
+    // Helper Methods
+    static void updateDRO();
+    static void sendStatusDisplay();
+    static void sendStartDisplay();
+    static void sendString(uint16_t address, const char *text);
+    static void formatPosition(float position, char *buffer, size_t size);
+
+    // Make class non-instantiable
+    PositioningPageHandler() = delete;
+    ~PositioningPageHandler() = delete;
+};
@@ -45,6 +45,10 @@ private:
     static void loadPitchesForCurrentCategoryAndSetDefault();
     static void updateDRO(); // For Z-Position display
     static void updateAutoStopTargetDisplay();
+    static void updateStartDisplay();
+    static void updateCycleDisplay();
+    static void updateSpringPassesDisplay();
+    static void updateProgressivePitchDisplay();
     static void checkAndHandleAutoStopCompletionFlash();
 
     // Structure to manage timed flashing of HMI elements
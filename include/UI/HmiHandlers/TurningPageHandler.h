@@ -29,7 +29,10 @@ private:
     // Helper Methods
     static void updateDRO();
     static void sendTurningPageFeedDisplays();
+    static void sendFeedOverrideDisplay();
     static void flashCompleteMessage();
+    static void sendCycleDisplay();
+    static void sendFeedPerMinuteDisplay();
 
     // Make class non-instantiable
     TurningPageHandler() = delete;
@@ -56,9 +56,21 @@ namespace STM32Step
         static constexpr uint32_t TIMER_INSTANCE = 1;          ///< TIM1
         static constexpr uint32_t PWM_CHANNEL = TIM_CHANNEL_1; ///< Timer channel for PWM
         static constexpr uint32_t SAFE_STOP_FREQ = 1000;       ///< 1kHz safe stop frequency
+        static constexpr uint32_t NCO_PARK_FREQ = 1000;        ///< Rate of the empty periods run while the NCO is parked
+        static constexpr uint32_t SEGMENT_QUEUE_LENGTH = 64;   ///< Segments buffered ahead of the DMA ring
+        static constexpr uint32_t SEGMENT_RING_HALF = 8;       ///< Segments per half of the DMA ring
         static constexpr uint32_t GPIO_AF = GPIO_AF1_TIM1;     ///< GPIO alternate function
     };
 
+    /**
+     * @brief Motion planner parameters
+     */
+    struct PlannerConfig
+    {
+        static constexpr uint32_t SEGMENT_US = 2000;              ///< Profile slice (one segment) length
+        static constexpr float DEFAULT_START_SPEED_HZ = 200.0f;   ///< Rate the motor starts and stops at without a ramp
+    };
+
     /**
      * @brief Hardware timing parameters
      */
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "config.h"
+#include "timer_base.h"
+
+namespace STM32Step
+{
+    /**
+     * @brief Velocity profile shape used by MotionPlanner.
+     */
+    enum class ProfileShape
+    {
+        TRAPEZOIDAL, ///< Constant acceleration, instant acceleration changes
+        S_CURVE      ///< Jerk-limited: acceleration itself ramps in and out
+    };
+
+    /**
+     * @class MotionPlanner
+     * @brief Turns a move, jog or stop request into a stream of StepSegment runs.
+     *
+     * The planner integrates its own velocity (and, for S_CURVE, acceleration) in fixed
+     * PlannerConfig::SEGMENT_US slices and emits one segment per slice, so the segment DMA
+     * stream reproduces the profile exactly. generate() is called from the segment ring
+     * refill interrupt; the request methods may be called from the main loop at any time
+     * and take effect on the next slice.
+     */
+    class MotionPlanner
+    {
+    public:
+        MotionPlanner();
+
+        /**
+         * @brief Sets the profile limits used by the next and the current move.
+         * @param shape Trapezoidal or jerk-limited profile.
+         * @param acceleration Maximum acceleration, steps/s^2.
+         * @param jerk Maximum jerk, steps/s^3 (S_CURVE only).
+         * @param startSpeedHz Rate the motor may start and stop at without ramping.
+         */
+        void configure(ProfileShape shape, float acceleration, float jerk, float startSpeedHz);
+
+        /**
+         * @brief Plans a move of exactly `steps` steps, cruising at up to `speedHz`.
+         */
+        void startMove(uint32_t steps, float speedHz);
+
+        /**
+         * @brief Plans an open-ended move that accelerates to `speedHz` and runs until requestStop().
+         */
+        void startJog(float speedHz);
+
+        /**
+         * @brief Changes the cruise speed; the profile ramps to it from wherever it is.
+         * For a jog this also cancels a stop that has not finished yet.
+         */
+        void setTargetSpeed(float speedHz);
+
+        /**
+         * @brief Decelerates to a stop along the profile (a finite move ends early).
+         */
+        void requestStop();
+
+        /**
+         * @brief Turns a running jog into a move that ends after `totalSteps` steps in all.
+         * The profile decelerates onto the count; if it is already closer than its stopping
+         * distance it brakes as hard as the limits allow and still ends on it.
+         */
+        void limitTo(uint32_t totalSteps);
+
+        /**
+         * @brief Produces up to `maxSegments` segments of the profile.
+         * @return Number of segments written; fewer than requested only once the profile has ended.
+         */
+        uint32_t generate(StepSegment *out, uint32_t maxSegments);
+
+        /** @brief True once the last segment of the profile has been generated. */
+        bool isFinished() const { return _finished; }
+
+        /** @brief True while the profile holds its cruise speed. */
+        bool isCruising() const { return !_finished && _speed == _targetSpeed && _accel == 0.0f; }
+
+        /** @brief Speed at the end of the last generated slice, steps/s. */
+        float getCurrentSpeed() const { return _speed; }
+
+        /** @brief Steps generated since the profile started. */
+        uint32_t getGeneratedSteps() const { return _generated; }
+
+    private:
+        /** @brief Steps needed to stop from the current speed and acceleration. */
+        float stoppingDistance() const;
+
+        /** @brief Advances speed (and acceleration) by one slice towards `goal`. */
+        void advance(float goal, float dt);
+
+        ProfileShape _shape;
+        float _acceleration;
+        float _jerk;
+        float _startSpeed;
+
+        volatile float _targetSpeed;     ///< Requested cruise speed
+        volatile bool _stopRequested;
+        volatile bool _bounded;          ///< startMove()/limitTo(): the profile ends after _totalSteps
+        volatile uint32_t _totalSteps;
+        uint32_t _generated;
+        float _speed;                    ///< steps/s at the end of the last slice
+        float _accel;                    ///< steps/s^2 (S_CURVE)
+        float _carry;                    ///< Fractional step not yet emitted
+        volatile bool _finished;
+    };
+
+} // namespace STM32Step
@@ -1,6 +1,7 @@
 #pragma once
 #include "config.h" // For OperationMode enum and PinConfig
 #include "timer_base.h"
+#include "planner.h"
 #include "Config/systemconfig.h" // For SystemConfig access if needed, though direct use is in .cpp
 
 class SyncTimer;
@@ -79,8 +80,139 @@ namespace STM32Step
          */
         void moveExact(int32_t steps, uint32_t frequency_hz);
 
+        // --- Hardware Gearing ---
+        /**
+         * @brief Lets the encoder trigger chain drive the step output (see TimerControl::startExternalGearing).
+         * @param direction Initial step direction (true = positive).
+         * @param triggersPerStep Encoder triggers per step (divide ratio).
+         * @param stepsPerTrigger Steps per encoder trigger (multiply ratio).
+         * @param burstFrequencyHz Pulse rate inside a multiply burst.
+         * @return True if the chain was started.
+         */
+        bool startExternalGearing(bool direction, uint32_t triggersPerStep, uint32_t stepsPerTrigger, uint32_t burstFrequencyHz);
+
+        /**
+         * @brief Changes the step direction while the trigger chain is running.
+         * Pulses already counted by TIM5 are booked against the old direction first.
+         */
+        void setExternalGearingDirection(bool direction);
+
+        /**
+         * @brief Returns the step output to CPU control and re-bases target/desired on the live position.
+         */
+        void stopExternalGearing();
+
+        // --- Continuous-Frequency (NCO) Output ---
+        /**
+         * @brief Starts a free-running step train whose rate is set with setNcoFrequency().
+         * @param direction Initial step direction (true = positive).
+         * @return True if the oscillator was started.
+         */
+        bool startNco(bool direction);
+
+        /**
+         * @brief Preloads the step rate for the next NCO period (0 parks the output).
+         */
+        void setNcoFrequency(float frequency_hz);
+
+        /**
+         * @brief Non-blocking direction change for the NCO: halts at the end of the current
+         * period, books the pulses against the old direction, flips DIR and restarts.
+         * Call repeatedly until it returns true.
+         * @param direction Requested step direction.
+         * @return True once the output is running in `direction`.
+         */
+        bool setNcoDirection(bool direction);
+
+        /**
+         * @brief Stops the NCO and re-bases target/desired on the live position.
+         */
+        void stopNco();
+
+        // --- DMA Segment Stream ---
+        /**
+         * @brief Sets DIR and starts playing the segments queued with TimerControl::queueSegments().
+         * The position keeps tracking through TIM5; stop() ends the stream.
+         * @param direction Step direction for the whole stream (true = positive).
+         * @param planned True if the motion planner feeds the stream (see moveProfiled()).
+         * @return True if the stream was started.
+         */
+        bool startSegmentStream(bool direction, bool planned = false);
+
+        // --- Planned Motion ---
+        /**
+         * @brief Selects the velocity profile for moveProfiled() and jogProfiled().
+         * The acceleration is the one set with setAcceleration().
+         * @param shape Trapezoidal or jerk-limited S-curve.
+         * @param jerk_steps_per_s3 Jerk limit for the S-curve.
+         */
+        void setProfile(ProfileShape shape, float jerk_steps_per_s3);
+
+        /**
+         * @brief Moves exactly `steps` steps along an accelerating/decelerating profile.
+         * The profile is planned from the segment ring refill interrupt, so it plays out
+         * without main-loop involvement; call updateProfile() to release TIM1 afterwards.
+         * @param steps Steps to move; negative values move in the opposite direction.
+         * @param speedHz Cruise speed.
+         * @return True if the move was started (the stepper must be enabled and idle).
+         */
+        bool moveProfiled(int32_t steps, float speedHz);
+
+        /**
+         * @brief Accelerates to `speedHz` and runs until decelerateToStop().
+         * While a jog in the same direction is playing (or still decelerating) this only
+         * changes its speed.
+         * @param direction Step direction (true = positive).
+         * @param speedHz Cruise speed.
+         * @return False if the stepper is busy with anything else, including a jog in the other direction.
+         */
+        bool jogProfiled(bool direction, float speedHz);
+
+        /** @brief Ramps a planned move or jog to a new cruise speed. */
+        void setProfileSpeed(float speedHz);
+
+        /** @brief Ramps a planned move or jog down to a stop. */
+        void decelerateToStop();
+
+        /**
+         * @brief Makes a running profiled jog end exactly at `targetPosition`.
+         * @return False if no profile is playing or the target is not ahead of the steps already planned.
+         */
+        bool endProfileAt(int32_t targetPosition);
+
+        /**
+         * @brief Releases TIM1 once a planned profile has played out completely.
+         * @return True while a planned profile is still playing.
+         */
+        bool updateProfile();
+
+        /** @brief True from moveProfiled()/jogProfiled() until updateProfile() or stop() ends it. */
+        bool isProfileActive() const { return _profileActive; }
+
+        // --- Backlash Take-Up ---
+        /**
+         * @brief Sets the slack between screw and nut that a direction reversal has to take up.
+         * After a reversal the first `steps` pulses are extra: planned streams play them ahead of
+         * the profile at `takeUpHz`, exact moves add them to their burst, and the closed-loop
+         * (NCO, gearing fallback) paths make them up as position error. They are not counted as
+         * travel, so getCurrentPosition() stays the carriage position throughout.
+         * @param steps Take-up per reversal (0 disables).
+         * @param takeUpHz Take-up rate for planned streams; the default is the no-ramp start rate.
+         */
+        void setBacklash(uint32_t steps, float takeUpHz = PlannerConfig::DEFAULT_START_SPEED_HZ);
+
+        /** @brief Configured take-up per reversal, steps. */
+        uint32_t getBacklash() const { return _backlashSteps; }
+
+        /** @brief Take-up pulses still due before the carriage moves in the current direction. */
+        uint32_t getTakeUpRemaining() const { return _takeUpRemaining; }
+
+        /** @brief Direction the step output is currently producing (true = positive). */
+        bool getDirection() const { return _currentDirection; }
+
         int32_t getCurrentPosition() const { return _currentPosition; }
         int32_t getTargetPosition() const { return _targetPosition; }
+        int32_t getDesiredPosition() const { return _desiredPosition; } ///< Where ISR() moves next; == target once all is queued.
         void setPosition(int32_t position) { _currentPosition = position; }
         void resetPosition()
         {
@@ -107,6 +239,12 @@ namespace STM32Step
     protected:
         friend class TimerControl; // Allow TimerControl to access _running
 
+        /**
+         * @brief Tops the segment queue up to `wanted` segments from the planner.
+         * Called by TimerControl from the segment ring refill interrupt.
+         */
+        void fillSegmentQueue(uint32_t wanted);
+
         /**
          * @brief Main ISR for the stepper motion control.
          * This is called from the high-frequency SyncTimer interrupt.
@@ -119,6 +257,18 @@ namespace STM32Step
         void GPIO_SET_DIRECTION();
         void GPIO_CLEAR_DIRECTION();
 
+        /**
+         * @brief Drives the DIR pin for a logical direction, honouring the Z-axis invert setting.
+         * @param direction True for positive steps.
+         */
+        void applyDirectionPin(bool direction);
+
+        /**
+         * @brief Sets the step direction and, on a reversal, re-arms the backlash take-up.
+         * Pulses of the old direction must already be booked (updatePositionFromHardware()).
+         */
+        void setStepDirection(bool direction);
+
     private:
         // Hardware pins
         uint8_t _stepPin;
@@ -140,6 +290,19 @@ namespace STM32Step
         volatile float _targetSpeedHz;
         volatile float _currentSpeedHz;
         float _accelerationStepsPerS2;
+
+        // Planned motion
+        MotionPlanner _planner;
+        ProfileShape _profileShape;
+        float _jerkStepsPerS3;
+        volatile bool _profileActive;
+        int32_t _profileOrigin; ///< Position the current profile started from
+
+        // Backlash take-up
+        uint32_t _backlashSteps;
+        float _takeUpHz;
+        volatile uint32_t _takeUpRemaining; ///< Pulses in _currentDirection that are not carriage travel
+        bool _directionKnown;               ///< False until the first direction is set (slack side unknown)
     };
 
 } // namespace STM32Step
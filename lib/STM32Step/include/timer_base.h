@@ -10,6 +10,15 @@ namespace STM32Step
     // Forward declaration
     class Stepper;
 
+    /**
+     * @brief One run of equally spaced step pulses for TimerControl::queueSegments().
+     */
+    struct StepSegment
+    {
+        float frequency_hz; ///< Step rate of this run.
+        uint16_t pulses;    ///< Number of pulses (1..65535; 0 is skipped).
+    };
+
     /**
      * @class TimerControl
      * @brief Static class to manage the hardware timer (TIM1) for generating hardware stepper pulses.
@@ -66,6 +75,134 @@ namespace STM32Step
          */
         static void setPulseCount(uint32_t pulses);
 
+        /**
+         * @brief Hands TIM1 to the encoder trigger chain (TIM2 TRGO -> ITR1) for zero-CPU gearing.
+         * Exactly one of the two ratios may be greater than 1:
+         * - `triggersPerStep` > 1: TIM1 counts encoder triggers and emits one step every N of them.
+         * - `stepsPerTrigger` >= 1: each encoder trigger starts a one-pulse burst of K steps at `burstFrequencyHz`.
+         * The DIR pin is left to the caller. TIM5 keeps counting every pulse.
+         * @param stepper The stepper whose position tracks the generated pulses.
+         * @param triggersPerStep Encoder triggers per step (divide ratio).
+         * @param stepsPerTrigger Steps per encoder trigger (multiply ratio).
+         * @param burstFrequencyHz Pulse rate inside a multiply burst.
+         * @return True if the chain was configured.
+         */
+        static bool startExternalGearing(Stepper *stepper, uint32_t triggersPerStep,
+                                         uint32_t stepsPerTrigger, uint32_t burstFrequencyHz);
+
+        /**
+         * @brief Detaches TIM1 from the encoder trigger chain and returns it to CPU-driven PWM.
+         */
+        static void stopExternalGearing();
+
+        /**
+         * @brief Stops the trigger chain taking encoder triggers and lets a pulse already on the
+         * step line finish: a multiply burst runs out on its own, a divided step is held for
+         * TimingConfig::PULSE_WIDTH. DIR can then change (or the chain stop) without truncating
+         * a pulse or booking one against the wrong direction. Triggers seen while held are lost.
+         */
+        static void holdExternalGearing();
+
+        /** @brief Lets a held trigger chain take encoder triggers again. */
+        static void resumeExternalGearing();
+
+        /** @brief True while TIM1 is driven by the encoder trigger chain. */
+        static bool isExternalGearingActive() { return externalGearing; }
+
+        /**
+         * @brief Starts TIM1 as a numerically controlled oscillator: a free-running pulse train
+         * whose rate is changed through the preloaded PSC/ARR/CCR1 registers, so every new
+         * frequency takes effect on a period boundary and the pulse train never gaps or glitches.
+         * @param stepper The stepper whose position tracks the generated pulses.
+         * @param frequency_hz Initial frequency (0 starts parked).
+         * @return True if the oscillator was started.
+         */
+        static bool startNco(Stepper *stepper, float frequency_hz);
+
+        /**
+         * @brief Preloads the NCO frequency for the next period.
+         * The prescaler is chosen per call, so rates well below the fixed-prescaler floor of
+         * setFrequency() are reachable. A frequency <= 0 parks the output: the timer keeps running
+         * empty NCO_PARK_FREQ periods with CCR1 beyond ARR, ready to resume on the next period.
+         * @param frequency_hz Step rate in Hz.
+         */
+        static void setNcoFrequency(float frequency_hz);
+
+        /**
+         * @brief Lets the current NCO period (and its pulse) finish, then halts the counter.
+         * Used to change direction without a truncated pulse; poll isNcoHalted().
+         */
+        static void requestNcoHalt();
+
+        /** @brief True once a requested NCO halt has taken effect. */
+        static bool isNcoHalted();
+
+        /** @brief True while a halt requested with requestNcoHalt() is pending or in effect. */
+        static bool isNcoHaltRequested();
+
+        /**
+         * @brief Restarts a halted NCO with the preloaded frequency, or cancels a pending halt.
+         */
+        static void resumeNco();
+
+        /**
+         * @brief Stops the NCO immediately and restores the fixed prescaler used by setFrequency().
+         */
+        static void stopNco();
+
+        /** @brief True while TIM1 runs as an NCO. */
+        static bool isNcoActive() { return ncoActive; }
+
+        // --- DMA Segment Stream ---
+        /**
+         * @brief Starts TIM1 in segment-stream mode.
+         * Every TIM1 update (end of a segment) triggers a DMA burst through DCR/DMAR that loads
+         * the next segment's PSC, ARR, RCR and CCR1 into the preload registers, so a whole
+         * schedule of variable step periods plays out without an interrupt per segment.
+         * The DMA ring is double-buffered; each half is refilled from the queue in one interrupt.
+         * Segments should be queued before starting; an empty queue plays idle (pulse-free) periods.
+         * @param stepper The stepper whose position tracks the generated pulses.
+         * @param planned True to have the stepper's motion planner top up the queue from each
+         *        ring refill (Stepper::fillSegmentQueue()) instead of queueing from the main loop.
+         * @return True if the stream was started.
+         */
+        static bool startSegmentStream(Stepper *stepper, bool planned = false);
+
+        /**
+         * @brief Appends segments to the stream queue.
+         * @param segments Segments to append.
+         * @param count Number of segments.
+         * @param last True if no more segments will follow; idle periods after it are not underruns.
+         * @return Number of segments accepted (limited by free queue space).
+         */
+        static uint32_t queueSegments(const StepSegment *segments, uint32_t count, bool last = false);
+
+        /** @brief Free space in the segment queue. */
+        static uint32_t getSegmentQueueSpace();
+
+        /**
+         * @brief True once every pulse queued since startSegmentStream() has been emitted.
+         */
+        static bool isSegmentStreamIdle();
+
+        /**
+         * @brief Number of ring refills that found the queue empty while more segments were expected.
+         */
+        static uint32_t getSegmentUnderruns() { return segmentUnderruns; }
+
+        /**
+         * @brief Stops the segment stream and restores the fixed prescaler used by setFrequency().
+         */
+        static void stopSegmentStream();
+
+        /** @brief True while TIM1 plays a segment stream. */
+        static bool isSegmentStreamActive() { return segmentStreamActive; }
+
+        /**
+         * @brief Segment DMA stream interrupt, called from the stream's IRQ handler.
+         */
+        static void segmentDmaIrqHandler();
+
         /**
          * @brief Gets the accumulated pulse count from the hardware slave timer (TIM5).
          * This counter increments for every pulse generated by TIM1, regardless of direction.
@@ -95,9 +232,51 @@ namespace STM32Step
          */
         static void initGPIO_PWM();
 
+        /**
+         * @brief TIM1 register image of one segment, in DMAR burst order (PSC, ARR, RCR, CCR1).
+         */
+        struct SegmentRegisters
+        {
+            uint32_t psc;
+            uint32_t arr;
+            uint32_t rcr;
+            uint32_t ccr1;
+        };
+
+        /**
+         * @brief Prescaler and auto-reload for a step rate, using the smallest prescaler that fits ARR.
+         * A rate <= 0 gives the idle (NCO_PARK_FREQ) period at the fixed prescaler.
+         */
+        static void computePeriod(float frequency_hz, uint32_t &psc, uint32_t &arr);
+
+        /** @brief An idle segment: one park period with CCR1 beyond ARR, so no pulse. */
+        static SegmentRegisters idleSegment();
+
+        /**
+         * @brief Moves up to `count` segments from the queue into the DMA ring, padding with idle ones.
+         */
+        static void refillSegmentRing(SegmentRegisters *dest, uint32_t count);
+
         // State tracking
         static volatile MotorState currentState; ///< Current state of the TimerControl.
         static volatile bool emergencyStop;      ///< Flag indicating an emergency stop has been requested.
+        static volatile bool externalGearing;    ///< True while TIM1 is slaved to the TIM2 trigger chain.
+        static uint32_t externalGearingSlaveMode; ///< SMCR.SMS of the running chain, restored on resume.
+        static volatile bool ncoActive;          ///< True while TIM1 runs as a preloaded NCO.
+
+        // Segment stream state
+        static volatile bool segmentStreamActive;
+        static volatile bool segmentStreamLast;     ///< The producer queued its final segment.
+        static volatile bool segmentStreamPlanned;  ///< The stepper's planner feeds the queue from the refill.
+        static volatile uint32_t segmentUnderruns;
+        static volatile uint32_t segmentQueueHead;  ///< Next write slot (producer).
+        static volatile uint32_t segmentQueueTail;  ///< Next read slot (DMA refill).
+        static volatile bool segmentRingReal;       ///< The last ring refill contained real segments.
+        static volatile uint32_t segmentPulsesQueued; ///< Pulses accepted since the stream started.
+        static uint32_t segmentStartPulseCount;       ///< TIM5 count when the stream started.
+        static SegmentRegisters segmentQueue[TimerConfig::SEGMENT_QUEUE_LENGTH];
+        static SegmentRegisters segmentRing[2 * TimerConfig::SEGMENT_RING_HALF]; ///< DMA source (AXI SRAM).
+        static DMA_HandleTypeDef hdmaSegments;
     };
 
 } // namespace STM32Step
@@ -0,0 +1,196 @@
+#include "planner.h"
+#include <cmath>
+
+namespace STM32Step
+{
+    MotionPlanner::MotionPlanner()
+        : _shape(ProfileShape::TRAPEZOIDAL),
+          _acceleration(1000.0f),
+          _jerk(0.0f),
+          _startSpeed(PlannerConfig::DEFAULT_START_SPEED_HZ),
+          _targetSpeed(0.0f),
+          _stopRequested(false),
+          _bounded(false),
+          _totalSteps(0),
+          _generated(0),
+          _speed(0.0f),
+          _accel(0.0f),
+          _carry(0.0f),
+          _finished(true)
+    {
+    }
+
+    void MotionPlanner::configure(ProfileShape shape, float acceleration, float jerk, float startSpeedHz)
+    {
+        _shape = shape;
+        _acceleration = (acceleration > 0.0f) ? acceleration : 1000.0f;
+        _jerk = (jerk > 0.0f) ? jerk : 0.0f;
+        _startSpeed = (startSpeedHz > 0.0f) ? startSpeedHz : 0.0f;
+    }
+
+    void MotionPlanner::startMove(uint32_t steps, float speedHz)
+    {
+        _bounded = true;
+        _totalSteps = steps;
+        _generated = 0;
+        _speed = 0.0f;
+        _accel = 0.0f;
+        _carry = 0.0f;
+        _targetSpeed = (speedHz > 0.0f) ? speedHz : 0.0f;
+        _stopRequested = false;
+        _finished = (steps == 0);
+    }
+
+    void MotionPlanner::startJog(float speedHz)
+    {
+        _bounded = false;
+        _totalSteps = 0;
+        _generated = 0;
+        _speed = 0.0f;
+        _accel = 0.0f;
+        _carry = 0.0f;
+        _targetSpeed = (speedHz > 0.0f) ? speedHz : 0.0f;
+        _stopRequested = false;
+        _finished = false;
+    }
+
+    void MotionPlanner::setTargetSpeed(float speedHz)
+    {
+        _targetSpeed = (speedHz > 0.0f) ? speedHz : 0.0f;
+        if (!_bounded)
+        {
+            _stopRequested = false; // A jog that is still running down picks up again
+        }
+    }
+
+    void MotionPlanner::requestStop()
+    {
+        _stopRequested = true;
+    }
+
+    void MotionPlanner::limitTo(uint32_t totalSteps)
+    {
+        // _totalSteps first: generate() only reads it once _bounded is set
+        _totalSteps = (totalSteps > _generated) ? totalSteps : _generated;
+        _bounded = true;
+    }
+
+    float MotionPlanner::stoppingDistance() const
+    {
+        float v = _speed;
+        if (_shape != ProfileShape::S_CURVE || _jerk <= 0.0f)
+        {
+            return v * v / (2.0f * _acceleration);
+        }
+
+        float distance = 0.0f;
+        if (_accel > 0.0f)
+        {
+            // Speed keeps rising while the acceleration ramps out
+            float rampTime = _accel / _jerk;
+            float peak = v + _accel * _accel / (2.0f * _jerk);
+            distance += 0.5f * (v + peak) * rampTime;
+            v = peak;
+        }
+        // Symmetric jerk-limited stop from zero acceleration: average speed v/2
+        if (v >= _acceleration * _acceleration / _jerk)
+        {
+            distance += 0.5f * v * (v / _acceleration + _acceleration / _jerk);
+        }
+        else
+        {
+            distance += v * sqrtf(v / _jerk); // Never reaches full deceleration
+        }
+        return distance;
+    }
+
+    void MotionPlanner::advance(float goal, float dt)
+    {
+        if (goal > _startSpeed && _speed < _startSpeed)
+        {
+            _speed = _startSpeed; // Starting needs no ramp
+        }
+
+        if (_shape != ProfileShape::S_CURVE || _jerk <= 0.0f)
+        {
+            float dv = _acceleration * dt;
+            _speed = (_speed < goal) ? fminf(_speed + dv, goal) : fmaxf(_speed - dv, goal);
+            _accel = 0.0f;
+        }
+        else
+        {
+            // Steer the acceleration so that ramping it back to zero lands on the goal speed
+            float error = goal - _speed;
+            float rampOut = _accel * fabsf(_accel) / (2.0f * _jerk);
+            float wanted = (error > rampOut) ? _acceleration : ((error < rampOut) ? -_acceleration : 0.0f);
+            float dj = _jerk * dt;
+            _accel = (_accel < wanted) ? fminf(_accel + dj, wanted) : fmaxf(_accel - dj, wanted);
+            _speed += _accel * dt;
+            if ((error >= 0.0f) ? (_speed >= goal) : (_speed <= goal))
+            {
+                _speed = goal;
+                _accel = 0.0f;
+            }
+        }
+
+        if (goal <= _startSpeed && _speed <= _startSpeed)
+        {
+            // Below the start speed the motor may change speed at once; a bounded move creeps
+            // out its last steps instead of stopping short, unless it was asked to stop
+            _speed = (goal > 0.0f) ? goal : ((_bounded && !_stopRequested) ? _startSpeed : 0.0f);
+            _accel = 0.0f;
+        }
+    }
+
+    uint32_t MotionPlanner::generate(StepSegment *out, uint32_t maxSegments)
+    {
+        const float dt = static_cast<float>(PlannerConfig::SEGMENT_US) * 1e-6f;
+        uint32_t count = 0;
+
+        while (count < maxSegments && !_finished)
+        {
+            float elapsed = 0.0f;
+            uint32_t pulses = 0;
+
+            // At crawl speed several slices pass before a whole step is due
+            while (pulses == 0 && !_finished)
+            {
+                float goal = _stopRequested ? 0.0f : _targetSpeed;
+                uint32_t remaining = _totalSteps - _generated;
+                if (_bounded && stoppingDistance() + _speed * dt >= static_cast<float>(remaining) - _carry)
+                {
+                    goal = 0.0f;
+                }
+
+                float before = _speed;
+                advance(goal, dt);
+                elapsed += dt;
+
+                float distance = 0.5f * (before + _speed) * dt + _carry;
+                uint32_t whole = static_cast<uint32_t>(distance);
+                _carry = distance - static_cast<float>(whole);
+                pulses += whole;
+
+                if (_bounded && pulses >= remaining)
+                {
+                    pulses = remaining;
+                    _finished = true;
+                }
+                else if (_speed <= 0.0f)
+                {
+                    _finished = true; // A jog has stopped; the fraction left over is dropped
+                }
+            }
+
+            if (pulses > 0)
+            {
+                out[count].frequency_hz = static_cast<float>(pulses) / elapsed;
+                out[count].pulses = static_cast<uint16_t>(pulses);
+                _generated += pulses;
+                count++;
+            }
+        }
+        return count;
+    }
+
+} // namespace STM32Step
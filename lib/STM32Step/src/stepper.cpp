@@ -21,7 +21,15 @@ namespace STM32Step
           _targetSpeedHz(0.0f),
           _currentSpeedHz(0.0f),
           _accelerationStepsPerS2(1000.0f),
-          _lastHardwarePulseCount(0)
+          _lastHardwarePulseCount(0),
+          _profileShape(ProfileShape::TRAPEZOIDAL),
+          _jerkStepsPerS3(0.0f),
+          _profileActive(false),
+          _profileOrigin(0),
+          _backlashSteps(0),
+          _takeUpHz(PlannerConfig::DEFAULT_START_SPEED_HZ),
+          _takeUpRemaining(0),
+          _directionKnown(false)
     {
         initPins();
     }
@@ -58,17 +66,7 @@ namespace STM32Step
 
         // Update position before changing direction or starting new move
         updatePositionFromHardware();
-
-        _currentDirection = direction;
-        bool zAxisInvertDir = SystemConfig::RuntimeConfig::Z_Axis::invert_direction;
-        if ((direction && !zAxisInvertDir) || (!direction && zAxisInvertDir))
-        {
-            GPIO_SET_DIRECTION();
-        }
-        else
-        {
-            GPIO_CLEAR_DIRECTION();
-        }
+        setStepDirection(direction);
 
         _running = true;
         TimerControl::setFrequency(static_cast<uint32_t>(_targetSpeedHz));
@@ -83,22 +81,14 @@ namespace STM32Step
 
         _steps_pending_for_isr = steps; // Store the exact number of steps for the ISR
 
-        bool direction = steps > 0;
-        _currentDirection = direction;
-        bool zAxisInvertDir = SystemConfig::RuntimeConfig::Z_Axis::invert_direction;
-        if ((direction && !zAxisInvertDir) || (!direction && zAxisInvertDir))
-        {
-            GPIO_SET_DIRECTION();
-        }
-        else
-        {
-            GPIO_CLEAR_DIRECTION();
-        }
+        updatePositionFromHardware(); // Book the last burst against its own direction
+        setStepDirection(steps > 0);
 
         _targetPosition += steps;
         _running = true;
         TimerControl::setFrequency(frequency_hz);
-        TimerControl::setPulseCount(std::abs(steps));
+        // A reversal takes the slack up in the same burst; those pulses are not counted as travel
+        TimerControl::setPulseCount(std::abs(steps) + _takeUpRemaining);
         TimerControl::start(this);
     }
 
@@ -120,6 +110,7 @@ namespace STM32Step
     {
         updatePositionFromHardware();
         _running = false;
+        _profileActive = false;
         TimerControl::stop();
         updatePositionFromHardware(); // Capture any final pulses
     }
@@ -180,6 +171,271 @@ namespace STM32Step
                           SystemConfig::RuntimeConfig::Z_Axis::enable_polarity_active_high ? GPIO_PIN_RESET : GPIO_PIN_SET);
     }
 
+    void Stepper::setStepDirection(bool direction)
+    {
+        if (direction != _currentDirection && _directionKnown)
+        {
+            // Whatever slack the old direction had not taken up yet is slack this way round
+            uint32_t left = (_takeUpRemaining < _backlashSteps) ? _takeUpRemaining : _backlashSteps;
+            _takeUpRemaining = _backlashSteps - left;
+        }
+        _directionKnown = true;
+        _currentDirection = direction;
+        applyDirectionPin(direction);
+    }
+
+    void Stepper::setBacklash(uint32_t steps, float takeUpHz)
+    {
+        _backlashSteps = steps;
+        _takeUpHz = (takeUpHz > 0.0f) ? takeUpHz : PlannerConfig::DEFAULT_START_SPEED_HZ;
+        if (_takeUpRemaining > steps)
+        {
+            _takeUpRemaining = steps;
+        }
+    }
+
+    void Stepper::applyDirectionPin(bool direction)
+    {
+        bool zAxisInvertDir = SystemConfig::RuntimeConfig::Z_Axis::invert_direction;
+        if ((direction && !zAxisInvertDir) || (!direction && zAxisInvertDir))
+        {
+            GPIO_SET_DIRECTION();
+        }
+        else
+        {
+            GPIO_CLEAR_DIRECTION();
+        }
+    }
+
+    bool Stepper::startExternalGearing(bool direction, uint32_t triggersPerStep, uint32_t stepsPerTrigger, uint32_t burstFrequencyHz)
+    {
+        if (!_enabled)
+            return false;
+
+        updatePositionFromHardware();
+        setStepDirection(direction);
+
+        if (!TimerControl::startExternalGearing(this, triggersPerStep, stepsPerTrigger, burstFrequencyHz))
+        {
+            return false;
+        }
+        // Any reload pulse seen while reconfiguring is not a step
+        _lastHardwarePulseCount = TimerControl::getPulseCount();
+        _running = true;
+        return true;
+    }
+
+    void Stepper::setExternalGearingDirection(bool direction)
+    {
+        if (direction == _currentDirection)
+            return;
+
+        // No pulse may be in flight while DIR changes, or it could be booked the wrong way
+        TimerControl::holdExternalGearing();
+        updatePositionFromHardware();
+        setStepDirection(direction);
+        delayMicroseconds(TimingConfig::DIR_SETUP);
+        TimerControl::resumeExternalGearing();
+    }
+
+    void Stepper::stopExternalGearing()
+    {
+        TimerControl::stopExternalGearing();
+        updatePositionFromHardware();
+        _running = false;
+        _targetPosition = _currentPosition;
+        _desiredPosition = _currentPosition;
+    }
+
+    bool Stepper::startNco(bool direction)
+    {
+        if (!_enabled)
+            return false;
+
+        updatePositionFromHardware();
+        setStepDirection(direction);
+
+        if (!TimerControl::startNco(this, 0.0f))
+        {
+            return false;
+        }
+        _lastHardwarePulseCount = TimerControl::getPulseCount();
+        _running = true;
+        return true;
+    }
+
+    void Stepper::setNcoFrequency(float frequency_hz)
+    {
+        _currentSpeedHz = (frequency_hz > 0.0f) ? frequency_hz : 0.0f;
+        TimerControl::setNcoFrequency(_currentSpeedHz);
+    }
+
+    bool Stepper::setNcoDirection(bool direction)
+    {
+        if (direction == _currentDirection)
+        {
+            if (TimerControl::isNcoHaltRequested())
+            {
+                TimerControl::resumeNco(); // Command swung back before the flip happened
+            }
+            return true;
+        }
+
+        if (!TimerControl::isNcoHalted())
+        {
+            TimerControl::setNcoFrequency(0.0f);
+            TimerControl::requestNcoHalt();
+            return false;
+        }
+
+        // Every pulse of the old direction has been counted by TIM5 now
+        updatePositionFromHardware();
+        setStepDirection(direction);
+        TimerControl::resumeNco();
+        return true;
+    }
+
+    void Stepper::stopNco()
+    {
+        TimerControl::stopNco();
+        updatePositionFromHardware();
+        _running = false;
+        _targetPosition = _currentPosition;
+        _desiredPosition = _currentPosition;
+    }
+
+    bool Stepper::startSegmentStream(bool direction, bool planned)
+    {
+        if (!_enabled)
+            return false;
+
+        updatePositionFromHardware();
+        setStepDirection(direction);
+
+        if (planned && _takeUpRemaining > 0)
+        {
+            // Played ahead of the profile at a rate the motor starts at without a ramp
+            StepSegment takeUp;
+            takeUp.frequency_hz = _takeUpHz;
+            takeUp.pulses = static_cast<uint16_t>((_takeUpRemaining < 65535u) ? _takeUpRemaining : 65535u);
+            TimerControl::queueSegments(&takeUp, 1);
+        }
+
+        // _lastHardwarePulseCount was synced above; the first pulse may follow start immediately
+        if (!TimerControl::startSegmentStream(this, planned))
+        {
+            return false;
+        }
+        _running = true;
+        return true;
+    }
+
+    void Stepper::setProfile(ProfileShape shape, float jerk_steps_per_s3)
+    {
+        _profileShape = shape;
+        _jerkStepsPerS3 = (jerk_steps_per_s3 > 0.0f) ? jerk_steps_per_s3 : 0.0f;
+    }
+
+    bool Stepper::moveProfiled(int32_t steps, float speedHz)
+    {
+        if (!_enabled || _running || steps == 0)
+            return false;
+
+        _planner.configure(_profileShape, _accelerationStepsPerS2, _jerkStepsPerS3, PlannerConfig::DEFAULT_START_SPEED_HZ);
+        _planner.startMove(static_cast<uint32_t>(std::abs(steps)), speedHz);
+        _profileActive = true;
+        _profileOrigin = _currentPosition;
+        if (!startSegmentStream(steps > 0, true))
+        {
+            _profileActive = false;
+            return false;
+        }
+        _targetPosition = _currentPosition + steps;
+        return true;
+    }
+
+    bool Stepper::jogProfiled(bool direction, float speedHz)
+    {
+        if (_profileActive && direction == _currentDirection)
+        {
+            _planner.setTargetSpeed(speedHz);
+            // Too late if the stop already ran out; the caller retries once the stream is released
+            return !_planner.isFinished();
+        }
+        if (!_enabled || _running)
+            return false;
+
+        _planner.configure(_profileShape, _accelerationStepsPerS2, _jerkStepsPerS3, PlannerConfig::DEFAULT_START_SPEED_HZ);
+        _planner.startJog(speedHz);
+        _profileActive = true;
+        _profileOrigin = _currentPosition;
+        if (!startSegmentStream(direction, true))
+        {
+            _profileActive = false;
+            return false;
+        }
+        return true;
+    }
+
+    void Stepper::setProfileSpeed(float speedHz)
+    {
+        _targetSpeedHz = (speedHz > 0.0f) ? speedHz : 0.0f;
+        if (_profileActive)
+        {
+            _planner.setTargetSpeed(_targetSpeedHz);
+        }
+    }
+
+    void Stepper::decelerateToStop()
+    {
+        if (_profileActive)
+        {
+            _planner.requestStop();
+        }
+    }
+
+    bool Stepper::endProfileAt(int32_t targetPosition)
+    {
+        if (!_profileActive || _planner.isFinished())
+            return false;
+
+        int32_t ahead = _currentDirection ? targetPosition - _profileOrigin : _profileOrigin - targetPosition;
+        if (ahead < 0 || static_cast<uint32_t>(ahead) < _planner.getGeneratedSteps())
+            return false; // Behind the move, or already planned past it
+
+        _planner.limitTo(static_cast<uint32_t>(ahead));
+        _targetPosition = targetPosition;
+        return true;
+    }
+
+    bool Stepper::updateProfile()
+    {
+        if (!_profileActive)
+            return false;
+        if (!_planner.isFinished() || !TimerControl::isSegmentStreamIdle())
+            return true;
+
+        stop();
+        _targetPosition = _currentPosition;
+        _desiredPosition = _currentPosition;
+        return false;
+    }
+
+    void Stepper::fillSegmentQueue(uint32_t wanted)
+    {
+        uint32_t queued = TimerConfig::SEGMENT_QUEUE_LENGTH - 1 - TimerControl::getSegmentQueueSpace();
+        if (queued >= wanted)
+            return;
+
+        StepSegment batch[TimerConfig::SEGMENT_RING_HALF];
+        uint32_t count = wanted - queued;
+        if (count > TimerConfig::SEGMENT_RING_HALF)
+            count = TimerConfig::SEGMENT_RING_HALF;
+        count = _planner.generate(batch, count);
+        TimerControl::queueSegments(batch, count, _planner.isFinished());
+        _currentSpeedHz = _planner.getCurrentSpeed();
+    }
+
     void Stepper::GPIO_SET_DIRECTION() { HAL_GPIO_WritePin(PinConfig::DirPin::PORT, PinConfig::DirPin::PIN, GPIO_PIN_SET); }
     void Stepper::GPIO_CLEAR_DIRECTION() { HAL_GPIO_WritePin(PinConfig::DirPin::PORT, PinConfig::DirPin::PIN, GPIO_PIN_RESET); }
 
@@ -204,6 +460,12 @@ namespace STM32Step
 
         if (delta != 0)
         {
+            // Slack take-up pulses turn the screw inside the nut; the carriage does not move
+            uint32_t takeUp = (delta < _takeUpRemaining) ? delta : _takeUpRemaining;
+            _takeUpRemaining -= takeUp;
+            _lastHardwarePulseCount = currentHardwareCount;
+            delta -= takeUp;
+
             // Determine direction for position update
             // If we are running, use _currentDirection.
             // If stopped, we assume no movement, but if delta > 0 it means pulses were generated.
@@ -229,8 +491,6 @@ namespace STM32Step
             {
                 _currentPosition -= delta;
             }
-
-            _lastHardwarePulseCount = currentHardwareCount;
         }
     }
 
@@ -4,6 +4,8 @@
 #include "Config/serial_debug.h"
 #include "stm32h7xx_hal.h"
 #include "Hardware/SystemClock.h"
+#include "Hardware/DCache.h"
+#include <cmath>
 
 namespace STM32Step
 {
@@ -22,6 +24,27 @@ namespace STM32Step
     Stepper *TimerControl::currentStepper = nullptr;
     volatile TimerControl::MotorState TimerControl::currentState = TimerControl::MotorState::IDLE;
     volatile bool TimerControl::emergencyStop = false;
+    volatile bool TimerControl::externalGearing = false;
+    uint32_t TimerControl::externalGearingSlaveMode = 0;
+    volatile bool TimerControl::ncoActive = false;
+    volatile bool TimerControl::segmentStreamActive = false;
+    volatile bool TimerControl::segmentStreamLast = false;
+    volatile bool TimerControl::segmentStreamPlanned = false;
+    volatile uint32_t TimerControl::segmentUnderruns = 0;
+    volatile uint32_t TimerControl::segmentQueueHead = 0;
+    volatile uint32_t TimerControl::segmentQueueTail = 0;
+    volatile bool TimerControl::segmentRingReal = false;
+    volatile uint32_t TimerControl::segmentPulsesQueued = 0;
+    uint32_t TimerControl::segmentStartPulseCount = 0;
+    TimerControl::SegmentRegisters TimerControl::segmentQueue[TimerConfig::SEGMENT_QUEUE_LENGTH];
+    TimerControl::SegmentRegisters TimerControl::segmentRing[2 * TimerConfig::SEGMENT_RING_HALF];
+    DMA_HandleTypeDef TimerControl::hdmaSegments = {};
+
+    // The segment stream uses DMA1 stream 1 (TIM1_UP request); stream 0 belongs to the encoder compares.
+    extern "C" void DMA1_Stream1_IRQHandler(void)
+    {
+        TimerControl::segmentDmaIrqHandler();
+    }
 
     void TimerControl::init()
     {
@@ -61,8 +84,10 @@ namespace STM32Step
         }
 
         // 5. Configure PWM Channel
+        // PWM2 keeps the output low at CNT = 0, so a one-pulse move that stops on its final
+        // update event leaves the line low and every pulse is a clean rising edge at CCR1.
         TIM_OC_InitTypeDef ocConfig = {0};
-        ocConfig.OCMode = TIM_OCMODE_PWM1;
+        ocConfig.OCMode = TIM_OCMODE_PWM2;
         ocConfig.Pulse = 5000; // Default to 50% duty, will be overwritten
         ocConfig.OCPolarity = TIM_OCPOLARITY_HIGH;
         ocConfig.OCNPolarity = TIM_OCNPOLARITY_HIGH;
@@ -85,8 +110,10 @@ namespace STM32Step
         }
 
         // 7. Configure TIM1 Master Mode Selection to Trigger TIM5
+        // TRGO follows OC1REF so TIM5 counts every pulse. An update-event TRGO only fires once
+        // per repetition-counter cycle and would count a whole RCR move as a single step.
         TIM_MasterConfigTypeDef sMasterConfig = {0};
-        sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE; // Generate TRGO on Update Event (Counter Overflow)
+        sMasterConfig.MasterOutputTrigger = TIM_TRGO_OC1REF; // Generate TRGO on each step pulse
         sMasterConfig.MasterOutputTrigger2 = TIM_TRGO2_RESET;
         sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_ENABLE;
         if (HAL_TIMEx_MasterConfigSynchronization(handle, &sMasterConfig) != HAL_OK)
@@ -97,6 +124,9 @@ namespace STM32Step
 
         // --- End of Known-Good Configuration ---
 
+        // Only a real counter overflow may raise UIF; setPulseCount() uses UG to load RCR/ARR.
+        handle->Instance->CR1 |= TIM_CR1_URS;
+
         // Attach the interrupt using the Arduino framework method for move completion.
         htim->attachInterrupt(TimerControl::pulse_isr);
 
@@ -145,7 +175,7 @@ namespace STM32Step
     uint32_t TimerControl::getPulseCount()
     {
         // Direct register access to TIM5 counter.
-        // TIM5 is configured as a slave to TIM1, so it counts pulses generated by TIM1.
+        // TIM5 is configured as a slave to TIM1 (TRGO = OC1REF), so it counts every pulse generated by TIM1.
         return TIM5->CNT;
     }
 
@@ -195,8 +225,10 @@ namespace STM32Step
 
         if (pulses > 0)
         {
-            // Set repetition counter for finite moves
+            // Set repetition counter for finite moves; one-pulse mode stops the counter
+            // on the update event that ends the last repetition.
             handle->Instance->RCR = pulses - 1;
+            handle->Instance->CR1 |= TIM_CR1_OPM;
             // Enable Update Interrupt to catch completion
             __HAL_TIM_ENABLE_IT(handle, TIM_IT_UPDATE);
         }
@@ -205,9 +237,453 @@ namespace STM32Step
             // Continuous mode (infinite pulses)
             // RCR doesn't matter much here for infinite, but set to 0
             handle->Instance->RCR = 0;
+            handle->Instance->CR1 &= ~TIM_CR1_OPM;
             // Disable Update Interrupt so it doesn't stop
             __HAL_TIM_DISABLE_IT(handle, TIM_IT_UPDATE);
         }
+
+        // RCR, ARR and CCR1 are preloaded; force them in now and restart the period from 0.
+        // URS is set, so this does not raise UIF (and PWM2 keeps OC1REF low, so TIM5 does not count it).
+        handle->Instance->EGR = TIM_EGR_UG;
+    }
+
+    bool TimerControl::startExternalGearing(Stepper *stepper, uint32_t triggersPerStep,
+                                            uint32_t stepsPerTrigger, uint32_t burstFrequencyHz)
+    {
+        if (!htim || !stepper || triggersPerStep == 0 || stepsPerTrigger == 0)
+            return false;
+        if (triggersPerStep > 1 && stepsPerTrigger > 1)
+            return false; // Either divide or multiply, not both
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        HAL_TIM_PWM_Stop(handle, TIM_CHANNEL_1);
+        __HAL_TIM_DISABLE_IT(handle, TIM_IT_UPDATE);
+
+        TIM_SlaveConfigTypeDef sSlaveConfig = {0};
+        sSlaveConfig.InputTrigger = TIM_TS_ITR1; // ITR1 connects TIM2 TRGO to TIM1 on STM32H7
+        sSlaveConfig.TriggerPolarity = TIM_TRIGGERPOLARITY_RISING;
+        sSlaveConfig.TriggerPrescaler = TIM_TRIGGERPRESCALER_DIV1;
+        sSlaveConfig.TriggerFilter = 0;
+
+        if (triggersPerStep == 1)
+        {
+            // Multiply: every encoder trigger starts a one-pulse run of stepsPerTrigger pulses.
+            sSlaveConfig.SlaveMode = TIM_SLAVEMODE_TRIGGER;
+            setFrequency(burstFrequencyHz);
+            handle->Instance->RCR = stepsPerTrigger - 1;
+            handle->Instance->CR1 |= TIM_CR1_OPM;
+        }
+        else
+        {
+            // Divide: TIM1 is clocked by the encoder triggers and wraps once per step.
+            // PWM2 with CCR1 = ARR raises the output on the last trigger of each cycle.
+            sSlaveConfig.SlaveMode = TIM_SLAVEMODE_EXTERNAL1;
+            __HAL_TIM_SET_AUTORELOAD(handle, triggersPerStep - 1);
+            __HAL_TIM_SET_COMPARE(handle, TIM_CHANNEL_1, triggersPerStep - 1);
+            handle->Instance->RCR = 0;
+            handle->Instance->CR1 &= ~TIM_CR1_OPM;
+        }
+
+        if (HAL_TIM_SlaveConfigSynchro(handle, &sSlaveConfig) != HAL_OK)
+        {
+            stopExternalGearing();
+            currentState = MotorState::ERROR;
+            return false;
+        }
+
+        handle->Instance->EGR = TIM_EGR_UG; // Load ARR/RCR/CCR1 and start from CNT = 0
+
+        currentStepper = stepper;
+        currentState = MotorState::RUNNING;
+        externalGearing = true;
+        externalGearingSlaveMode = handle->Instance->SMCR & TIM_SMCR_SMS;
+
+        __HAL_TIM_MOE_ENABLE(handle);
+        // In trigger mode HAL leaves CEN clear; the first encoder trigger starts the counter.
+        HAL_TIM_PWM_Start(handle, TIM_CHANNEL_1);
+        return true;
+    }
+
+    void TimerControl::holdExternalGearing()
+    {
+        if (!htim || !externalGearing)
+            return;
+
+        TIM_TypeDef *tim = htim->getHandle()->Instance;
+        if (tim->CR1 & TIM_CR1_OPM)
+        {
+            // Multiply: ignore further triggers; a burst already started runs out on the
+            // internal clock and one-pulse mode clears CEN at its end.
+            tim->SMCR &= ~TIM_SMCR_SMS;
+            uint32_t timerClock = SystemClock::GetInstance().GetPClk2Freq() / (tim->PSC + 1);
+            uint64_t ticks = static_cast<uint64_t>(tim->RCR + 1) * (tim->ARR + 1);
+            uint32_t budgetUs = static_cast<uint32_t>(ticks * 1000000ULL / (timerClock ? timerClock : 1)) + 1;
+            uint32_t start = micros();
+            while ((tim->CR1 & TIM_CR1_CEN) && (micros() - start) <= budgetUs)
+            {
+            }
+        }
+        else
+        {
+            // Divide: freeze the count. PWM2 with CCR1 = ARR means the step line is high while
+            // CNT sits on ARR; that pulse started at an unknown time, so give it a full width.
+            tim->CR1 &= ~TIM_CR1_CEN;
+            if (tim->CNT >= tim->CCR1)
+            {
+                delayMicroseconds(TimingConfig::PULSE_WIDTH);
+            }
+        }
+    }
+
+    void TimerControl::resumeExternalGearing()
+    {
+        if (!htim || !externalGearing)
+            return;
+
+        TIM_TypeDef *tim = htim->getHandle()->Instance;
+        tim->SMCR = (tim->SMCR & ~TIM_SMCR_SMS) | externalGearingSlaveMode;
+        if (!(tim->CR1 & TIM_CR1_OPM))
+        {
+            tim->CR1 |= TIM_CR1_CEN; // Divide: count triggers again; multiply waits for the next one
+        }
+    }
+
+    void TimerControl::stopExternalGearing()
+    {
+        if (!htim)
+            return;
+
+        // Never cut a pulse short: TIM5 has already counted it, the driver might not see it
+        holdExternalGearing();
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        HAL_TIM_PWM_Stop(handle, TIM_CHANNEL_1);
+
+        TIM_SlaveConfigTypeDef sSlaveConfig = {0};
+        sSlaveConfig.SlaveMode = TIM_SLAVEMODE_DISABLE;
+        sSlaveConfig.InputTrigger = TIM_TS_ITR1;
+        HAL_TIM_SlaveConfigSynchro(handle, &sSlaveConfig);
+
+        handle->Instance->RCR = 0;
+        handle->Instance->CR1 &= ~TIM_CR1_OPM;
+        externalGearing = false;
+
+        if (currentStepper)
+        {
+            currentStepper->_running = false;
+        }
+        currentState = MotorState::IDLE;
+    }
+
+    bool TimerControl::startNco(Stepper *stepper, float frequency_hz)
+    {
+        if (!htim || !stepper || externalGearing)
+            return false;
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        HAL_TIM_PWM_Stop(handle, TIM_CHANNEL_1);
+        __HAL_TIM_DISABLE_IT(handle, TIM_IT_UPDATE);
+        handle->Instance->RCR = 0;
+        handle->Instance->CR1 &= ~TIM_CR1_OPM;
+
+        ncoActive = true;
+        setNcoFrequency(frequency_hz);
+        handle->Instance->EGR = TIM_EGR_UG; // Load the first period from CNT = 0
+
+        currentStepper = stepper;
+        currentState = MotorState::RUNNING;
+
+        __HAL_TIM_MOE_ENABLE(handle);
+        HAL_TIM_PWM_Start(handle, TIM_CHANNEL_1);
+        return true;
+    }
+
+    void TimerControl::setNcoFrequency(float frequency_hz)
+    {
+        if (!htim || !ncoActive)
+            return;
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        uint32_t psc, arr;
+        computePeriod(frequency_hz, psc, arr);
+        // Parked: CCR1 past ARR keeps OC1REF low (PWM2), so the periods stay empty.
+        uint32_t ccr = (frequency_hz <= 0.0f) ? arr + 1 : (arr + 1) / 2;
+
+        // UDIS holds the shadow registers, so an update can never load a half-written set.
+        handle->Instance->CR1 |= TIM_CR1_UDIS;
+        handle->Instance->PSC = psc;
+        handle->Instance->ARR = arr;
+        handle->Instance->CCR1 = ccr;
+        handle->Instance->CR1 &= ~TIM_CR1_UDIS;
+    }
+
+    void TimerControl::requestNcoHalt()
+    {
+        if (!htim || !ncoActive)
+            return;
+        // One-pulse mode clears CEN at the next update, i.e. after the pulse of the current period.
+        htim->getHandle()->Instance->CR1 |= TIM_CR1_OPM;
+    }
+
+    bool TimerControl::isNcoHalted()
+    {
+        if (!htim || !ncoActive)
+            return true;
+        return (htim->getHandle()->Instance->CR1 & TIM_CR1_CEN) == 0;
+    }
+
+    void TimerControl::resumeNco()
+    {
+        if (!htim || !ncoActive)
+            return;
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        handle->Instance->CR1 &= ~TIM_CR1_OPM;
+        // A halt that has not taken effect yet is simply cancelled
+        if ((handle->Instance->CR1 & TIM_CR1_CEN) == 0)
+        {
+            handle->Instance->EGR = TIM_EGR_UG;
+            handle->Instance->CR1 |= TIM_CR1_CEN;
+        }
+    }
+
+    bool TimerControl::isNcoHaltRequested()
+    {
+        if (!htim || !ncoActive)
+            return false;
+        return (htim->getHandle()->Instance->CR1 & TIM_CR1_OPM) != 0;
+    }
+
+    void TimerControl::stopNco()
+    {
+        if (!htim)
+            return;
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        HAL_TIM_PWM_Stop(handle, TIM_CHANNEL_1);
+        handle->Instance->CR1 &= ~TIM_CR1_OPM;
+        handle->Instance->PSC = handle->Init.Prescaler; // Loaded by the UG in the next setPulseCount()
+        ncoActive = false;
+
+        if (currentStepper)
+        {
+            currentStepper->_running = false;
+        }
+        currentState = MotorState::IDLE;
+    }
+
+    void TimerControl::computePeriod(float frequency_hz, uint32_t &psc, uint32_t &arr)
+    {
+        uint32_t inputClock = SystemClock::GetInstance().GetPClk2Freq();
+
+        if (frequency_hz <= 0.0f)
+        {
+            psc = htim->getHandle()->Init.Prescaler;
+            arr = inputClock / (psc + 1) / TimerConfig::NCO_PARK_FREQ - 1;
+            return;
+        }
+
+        // Smallest prescaler that fits the period into 16 bits, for the finest ARR resolution.
+        float ticks = static_cast<float>(inputClock) / frequency_hz;
+        psc = static_cast<uint32_t>(ticks / 65536.0f);
+        if (psc > 0xFFFF)
+            psc = 0xFFFF;
+        arr = static_cast<uint32_t>(lroundf(ticks / static_cast<float>(psc + 1)));
+        arr = (arr < 2) ? 1 : arr - 1;
+        if (arr > 0xFFFF)
+            arr = 0xFFFF;
+    }
+
+    TimerControl::SegmentRegisters TimerControl::idleSegment()
+    {
+        SegmentRegisters idle;
+        computePeriod(0.0f, idle.psc, idle.arr);
+        idle.rcr = 0;
+        idle.ccr1 = idle.arr + 1;
+        return idle;
+    }
+
+    uint32_t TimerControl::getSegmentQueueSpace()
+    {
+        // One slot stays free to tell a full queue from an empty one
+        uint32_t used = (segmentQueueHead - segmentQueueTail + TimerConfig::SEGMENT_QUEUE_LENGTH) % TimerConfig::SEGMENT_QUEUE_LENGTH;
+        return TimerConfig::SEGMENT_QUEUE_LENGTH - 1 - used;
+    }
+
+    uint32_t TimerControl::queueSegments(const StepSegment *segments, uint32_t count, bool last)
+    {
+        if (!htim || !segments)
+            return 0;
+
+        uint32_t accepted = 0;
+        uint32_t head = segmentQueueHead;
+        for (uint32_t i = 0; i < count && getSegmentQueueSpace() > 0; ++i)
+        {
+            accepted++;
+            if (segments[i].pulses == 0)
+                continue;
+
+            SegmentRegisters &slot = segmentQueue[head];
+            computePeriod(segments[i].frequency_hz, slot.psc, slot.arr);
+            slot.rcr = segments[i].pulses - 1u;
+            slot.ccr1 = (slot.arr + 1) / 2;
+            segmentPulsesQueued = segmentPulsesQueued + segments[i].pulses;
+            head = (head + 1) % TimerConfig::SEGMENT_QUEUE_LENGTH;
+            segmentQueueHead = head; // Publish only complete slots to the refill interrupt
+        }
+        // Only a fully accepted batch can be the last one
+        segmentStreamLast = last && accepted == count;
+        return accepted;
+    }
+
+    void TimerControl::refillSegmentRing(SegmentRegisters *dest, uint32_t count)
+    {
+        if (segmentStreamPlanned && currentStepper)
+        {
+            currentStepper->fillSegmentQueue(count); // Plan just in time, one ring half ahead of the output
+        }
+
+        bool real = false;
+        bool padded = false;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t tail = segmentQueueTail;
+            if (tail != segmentQueueHead)
+            {
+                dest[i] = segmentQueue[tail];
+                segmentQueueTail = (tail + 1) % TimerConfig::SEGMENT_QUEUE_LENGTH;
+                real = true;
+            }
+            else
+            {
+                dest[i] = idleSegment();
+                padded = true;
+            }
+        }
+        // Running dry between real segments means the producer fell behind mid-move
+        if (padded && !segmentStreamLast && (real || segmentRingReal))
+        {
+            segmentUnderruns++;
+        }
+        segmentRingReal = real;
+        // The ring sits in cacheable AXI SRAM and DMA1 does not snoop the D-cache. This also covers
+        // the two halves startSegmentStream() primes before the stream starts.
+        DCache::cleanForDma(dest, count * sizeof(SegmentRegisters));
+    }
+
+    bool TimerControl::startSegmentStream(Stepper *stepper, bool planned)
+    {
+        if (!htim || !stepper || externalGearing || ncoActive)
+            return false;
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        HAL_TIM_PWM_Stop(handle, TIM_CHANNEL_1);
+        __HAL_TIM_DISABLE_IT(handle, TIM_IT_UPDATE);
+        handle->Instance->CR1 &= ~TIM_CR1_OPM;
+
+        if (hdmaSegments.Instance == nullptr)
+        {
+            __HAL_RCC_DMA1_CLK_ENABLE();
+            hdmaSegments.Instance = DMA1_Stream1;
+            hdmaSegments.Init.Request = DMA_REQUEST_TIM1_UP;
+            hdmaSegments.Init.Direction = DMA_MEMORY_TO_PERIPH;
+            hdmaSegments.Init.PeriphInc = DMA_PINC_DISABLE; // DMAR walks the burst registers itself
+            hdmaSegments.Init.MemInc = DMA_MINC_ENABLE;
+            hdmaSegments.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+            hdmaSegments.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+            hdmaSegments.Init.Mode = DMA_CIRCULAR;
+            hdmaSegments.Init.Priority = DMA_PRIORITY_HIGH;
+            hdmaSegments.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+            if (HAL_DMA_Init(&hdmaSegments) != HAL_OK)
+            {
+                hdmaSegments.Instance = nullptr;
+                return false;
+            }
+            hdmaSegments.XferHalfCpltCallback = [](DMA_HandleTypeDef *)
+            { refillSegmentRing(segmentRing, TimerConfig::SEGMENT_RING_HALF); };
+            hdmaSegments.XferCpltCallback = [](DMA_HandleTypeDef *)
+            { refillSegmentRing(segmentRing + TimerConfig::SEGMENT_RING_HALF, TimerConfig::SEGMENT_RING_HALF); };
+            HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 2, 0);
+        }
+
+        segmentUnderruns = 0;
+        segmentRingReal = false;
+        segmentStartPulseCount = getPulseCount();
+        segmentStreamPlanned = planned;
+        currentStepper = stepper; // The planner is asked for the first segments below
+
+        // The first segment goes straight into the shadow registers (UG), the second into the
+        // preload registers; the DMA burst on each update then always writes one segment ahead.
+        SegmentRegisters first[2];
+        refillSegmentRing(first, 2);
+        handle->Instance->PSC = first[0].psc;
+        handle->Instance->ARR = first[0].arr;
+        handle->Instance->RCR = first[0].rcr;
+        handle->Instance->CCR1 = first[0].ccr1;
+        handle->Instance->EGR = TIM_EGR_UG; // URS is set: no UIF, and UDE is still off: no DMA request
+        handle->Instance->PSC = first[1].psc;
+        handle->Instance->ARR = first[1].arr;
+        handle->Instance->RCR = first[1].rcr;
+        handle->Instance->CCR1 = first[1].ccr1;
+        refillSegmentRing(segmentRing, TimerConfig::SEGMENT_RING_HALF);
+        refillSegmentRing(segmentRing + TimerConfig::SEGMENT_RING_HALF, TimerConfig::SEGMENT_RING_HALF);
+
+        handle->Instance->DCR = TIM_DMABASE_PSC | TIM_DMABURSTLENGTH_4TRANSFERS;
+        if (HAL_DMA_Start_IT(&hdmaSegments, reinterpret_cast<uint32_t>(segmentRing),
+                             reinterpret_cast<uint32_t>(&handle->Instance->DMAR),
+                             2 * TimerConfig::SEGMENT_RING_HALF * (sizeof(SegmentRegisters) / sizeof(uint32_t))) != HAL_OK)
+        {
+            return false;
+        }
+        HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+        __HAL_TIM_ENABLE_DMA(handle, TIM_DMA_UPDATE);
+
+        segmentStreamActive = true;
+        currentStepper = stepper;
+        currentState = MotorState::RUNNING;
+
+        __HAL_TIM_MOE_ENABLE(handle);
+        HAL_TIM_PWM_Start(handle, TIM_CHANNEL_1);
+        return true;
+    }
+
+    bool TimerControl::isSegmentStreamIdle()
+    {
+        // TIM5 counts every pulse actually emitted, so this cannot report idle before the last pulse
+        return (getPulseCount() - segmentStartPulseCount) == segmentPulsesQueued;
+    }
+
+    void TimerControl::stopSegmentStream()
+    {
+        if (!htim)
+            return;
+
+        TIM_HandleTypeDef *handle = htim->getHandle();
+        HAL_TIM_PWM_Stop(handle, TIM_CHANNEL_1);
+        __HAL_TIM_DISABLE_DMA(handle, TIM_DMA_UPDATE);
+        if (segmentStreamActive)
+        {
+            HAL_DMA_Abort(&hdmaSegments);
+            HAL_NVIC_DisableIRQ(DMA1_Stream1_IRQn);
+        }
+        handle->Instance->RCR = 0;
+        handle->Instance->PSC = handle->Init.Prescaler; // Loaded by the UG in the next setPulseCount()
+        segmentStreamActive = false;
+        segmentStreamLast = false;
+        segmentStreamPlanned = false;
+        segmentQueueTail = segmentQueueHead; // Drop anything not yet played
+        segmentPulsesQueued = 0;
+
+        if (currentStepper)
+        {
+            currentStepper->_running = false;
+        }
+        currentState = MotorState::IDLE;
+    }
+
+    void TimerControl::segmentDmaIrqHandler()
+    {
+        HAL_DMA_IRQHandler(&hdmaSegments);
     }
 
     void TimerControl::start(Stepper *stepper)
@@ -218,6 +694,9 @@ namespace STM32Step
         currentStepper = stepper;
         currentState = MotorState::RUNNING;
 
+        if (externalGearing || ncoActive || segmentStreamActive)
+            return; // The trigger chain, NCO or segment stream owns TIM1 until it is stopped
+
         // For advanced timers like TIM1, the main output must be explicitly enabled.
         __HAL_TIM_MOE_ENABLE(htim->getHandle());
         HAL_TIM_PWM_Start(htim->getHandle(), TIM_CHANNEL_1);
@@ -228,6 +707,22 @@ namespace STM32Step
         if (!htim || currentState == MotorState::IDLE)
             return;
 
+        if (externalGearing)
+        {
+            stopExternalGearing();
+            return;
+        }
+        if (ncoActive)
+        {
+            stopNco();
+            return;
+        }
+        if (segmentStreamActive)
+        {
+            stopSegmentStream();
+            return;
+        }
+
         HAL_TIM_PWM_Stop(htim->getHandle(), TIM_CHANNEL_1);
 
         if (currentStepper)
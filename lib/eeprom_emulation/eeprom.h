@@ -78,7 +78,7 @@
 #define PAGE_FULL ((uint8_t)0x80)
 
 /* Variables' number */
-#define NB_OF_VAR ((uint8_t)38)
+#define NB_OF_VAR ((uint8_t)39)
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
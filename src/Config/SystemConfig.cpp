@@ -58,12 +58,19 @@ extern HardwareSerial SerialDebug; // Ensure SerialDebug is declared
 #define VIRT_ADDR_MAX_JOG_SPEED_L 0x0024             // Corresponds to RuntimeConfig::Z_Axis::max_jog_speed_mm_per_min (float L)
 #define VIRT_ADDR_MAX_JOG_SPEED_H 0x0025             // Corresponds to RuntimeConfig::Z_Axis::max_jog_speed_mm_per_min (float H)
 #define VIRT_ADDR_DEFAULT_JOG_SPEED_INDEX 0x0026     // Corresponds to RuntimeConfig::System::default_jog_speed_index (uint8_t)
-                                                     // Last address (35 + 2 = 37th)
+#define VIRT_ADDR_MOTION_SYNC_MODES 0x0027           // Bitmask of the optional RuntimeConfig::Motion sync modes (SYNC_MODE_*)
+                                                     // Last address (39th)
+
+// Bits of VIRT_ADDR_MOTION_SYNC_MODES
+#define SYNC_MODE_EDGE_TRIGGERED 0x0001   // RuntimeConfig::Motion::edge_triggered_sync
+#define SYNC_MODE_HARDWARE_GEARING 0x0002 // RuntimeConfig::Motion::hardware_gearing
+#define SYNC_MODE_COMPARE_DMA 0x0004      // RuntimeConfig::Motion::compare_dma_sync
+#define SYNC_MODE_NCO 0x0008              // RuntimeConfig::Motion::nco_sync
 
 // This array must be defined and accessible by eeprom.c (it's extern there)
 // It lists all unique virtual addresses used. The order here doesn't strictly
 // matter for the EEPROM lib, but it's good practice to list them.
-// The size of this array MUST match NB_OF_VAR in eeprom.h (which will be 37).
+// The size of this array MUST match NB_OF_VAR in eeprom.h (which will be 39).
 uint16_t VirtAddVarTab[NB_OF_VAR] = {
     VIRT_ADDR_ENCODER_PPR, VIRT_ADDR_ENCODER_MAX_RPM, VIRT_ADDR_ENCODER_FILTER, VIRT_ADDR_ENCODER_INV_DIR,
     VIRT_ADDR_STEPPER_MICROSTEPS_L, VIRT_ADDR_STEPPER_MICROSTEPS_H,
@@ -87,7 +94,8 @@ uint16_t VirtAddVarTab[NB_OF_VAR] = {
     VIRT_ADDR_Z_AXIS_ENABLE_POL_HIGH,
     VIRT_ADDR_JOG_SYSTEM_ENABLED,
     VIRT_ADDR_MAX_JOG_SPEED_L, VIRT_ADDR_MAX_JOG_SPEED_H,
-    VIRT_ADDR_DEFAULT_JOG_SPEED_INDEX};
+    VIRT_ADDR_DEFAULT_JOG_SPEED_INDEX,
+    VIRT_ADDR_MOTION_SYNC_MODES};
 
 namespace SystemConfig
 {
@@ -108,6 +116,19 @@ namespace SystemConfig
     // RuntimeConfig::Motion::leadscrew_pitch is removed, now part of Z_Axis
     uint32_t RuntimeConfig::Motion::sync_frequency = Limits::Motion::DEFAULT_SYNC_FREQ;
     bool RuntimeConfig::Motion::sync_enabled = false;
+    bool RuntimeConfig::Motion::edge_triggered_sync = Limits::Motion::DEFAULT_EDGE_TRIGGERED_SYNC;
+    bool RuntimeConfig::Motion::hardware_gearing = Limits::Motion::DEFAULT_HARDWARE_GEARING;
+    bool RuntimeConfig::Motion::compare_dma_sync = Limits::Motion::DEFAULT_COMPARE_DMA_SYNC;
+    bool RuntimeConfig::Motion::nco_sync = Limits::Motion::DEFAULT_NCO_SYNC;
+    bool RuntimeConfig::Motion::index_engage = Limits::Motion::DEFAULT_INDEX_ENGAGE;
+    bool RuntimeConfig::Motion::observer_feed_forward = Limits::Motion::DEFAULT_OBSERVER_FEED_FORWARD;
+    bool RuntimeConfig::Motion::soft_engage = Limits::Motion::DEFAULT_SOFT_ENGAGE;
+    float RuntimeConfig::Motion::following_error_limit_mm = Limits::Motion::DEFAULT_FOLLOWING_ERROR_LIMIT_MM;
+    bool RuntimeConfig::Motion::following_error_fault = Limits::Motion::DEFAULT_FOLLOWING_ERROR_FAULT;
+    bool RuntimeConfig::Motion::subcount_interpolation = Limits::Motion::DEFAULT_SUBCOUNT_INTERPOLATION;
+    uint32_t RuntimeConfig::Motion::cycle_return_delay_ms = Limits::Motion::DEFAULT_CYCLE_RETURN_DELAY_MS;
+    uint32_t RuntimeConfig::Motion::thread_cycle_retract_ms = Limits::Motion::DEFAULT_THREAD_CYCLE_RETRACT_MS;
+    uint8_t RuntimeConfig::Motion::spring_passes = Limits::Motion::DEFAULT_SPRING_PASSES;
 
     // Initialize Z_Axis Configuration
     volatile bool RuntimeConfig::Z_Axis::invert_direction = Limits::Z_Axis::DEFAULT_INVERT_DIRECTION; // Added volatile
@@ -118,6 +139,8 @@ namespace SystemConfig
     float RuntimeConfig::Z_Axis::max_feed_rate = Limits::Z_Axis::DEFAULT_MAX_FEED_RATE;
     float RuntimeConfig::Z_Axis::max_jog_speed_mm_per_min = Limits::Z_Axis::DEFAULT_MAX_JOG_SPEED_MM_PER_MIN;
     float RuntimeConfig::Z_Axis::acceleration = Limits::Z_Axis::DEFAULT_ACCELERATION;
+    float RuntimeConfig::Z_Axis::jerk = Limits::Z_Axis::DEFAULT_JERK;
+    bool RuntimeConfig::Z_Axis::s_curve_profile = Limits::Z_Axis::DEFAULT_S_CURVE_PROFILE;
     float RuntimeConfig::Z_Axis::backlash_compensation = Limits::Z_Axis::DEFAULT_BACKLASH_COMPENSATION;
     bool RuntimeConfig::Z_Axis::leadscrew_standard_is_metric = Limits::Z_Axis::DEFAULT_LEADSCREW_STANDARD_IS_METRIC;
     bool RuntimeConfig::Z_Axis::enable_polarity_active_high = Limits::Z_Axis::DEFAULT_ENABLE_POLARITY_ACTIVE_HIGH;
@@ -149,6 +172,7 @@ namespace SystemConfig
     bool RuntimeConfigDirtyFlags::Motion::thread_pitch = false;
     bool RuntimeConfigDirtyFlags::Motion::sync_frequency = false;
     bool RuntimeConfigDirtyFlags::Motion::sync_enabled = false;
+    bool RuntimeConfigDirtyFlags::Motion::sync_modes = false;
 
     bool RuntimeConfigDirtyFlags::Z_Axis::invert_direction = false;
     bool RuntimeConfigDirtyFlags::Z_Axis::motor_pulley_teeth = false;
@@ -309,6 +333,10 @@ namespace SystemConfig
         // RuntimeConfig::Motion::leadscrew_pitch removed
         RuntimeConfig::Motion::sync_frequency = Limits::Motion::DEFAULT_SYNC_FREQ;
         RuntimeConfig::Motion::sync_enabled = false;
+        RuntimeConfig::Motion::edge_triggered_sync = Limits::Motion::DEFAULT_EDGE_TRIGGERED_SYNC;
+        RuntimeConfig::Motion::hardware_gearing = Limits::Motion::DEFAULT_HARDWARE_GEARING;
+        RuntimeConfig::Motion::compare_dma_sync = Limits::Motion::DEFAULT_COMPARE_DMA_SYNC;
+        RuntimeConfig::Motion::nco_sync = Limits::Motion::DEFAULT_NCO_SYNC;
 
         // Reset Z_Axis configuration
         RuntimeConfig::Z_Axis::invert_direction = Limits::Z_Axis::DEFAULT_INVERT_DIRECTION;
@@ -345,6 +373,7 @@ namespace SystemConfig
         RuntimeConfigDirtyFlags::Motion::thread_pitch = true;
         RuntimeConfigDirtyFlags::Motion::sync_frequency = true;
         RuntimeConfigDirtyFlags::Motion::sync_enabled = true;
+        RuntimeConfigDirtyFlags::Motion::sync_modes = true;
         RuntimeConfigDirtyFlags::Z_Axis::invert_direction = true;
         RuntimeConfigDirtyFlags::Z_Axis::motor_pulley_teeth = true;
         RuntimeConfigDirtyFlags::Z_Axis::lead_screw_pulley_teeth = true;
@@ -476,6 +505,15 @@ namespace SystemConfig
         if (EE_ReadVariable(VIRT_ADDR_MOTION_SYNC_ENABLED, &temp_bool) != EE_OK)
             return false;
         RuntimeConfig::Motion::sync_enabled = (temp_bool != 0);
+        // Added after the first release: a store written before it has no such variable, so
+        // keep the defaults rather than failing the load and resetting every other setting.
+        if (EE_ReadVariable(VIRT_ADDR_MOTION_SYNC_MODES, &temp_bool) == EE_OK)
+        {
+            RuntimeConfig::Motion::edge_triggered_sync = (temp_bool & SYNC_MODE_EDGE_TRIGGERED) != 0;
+            RuntimeConfig::Motion::hardware_gearing = (temp_bool & SYNC_MODE_HARDWARE_GEARING) != 0;
+            RuntimeConfig::Motion::compare_dma_sync = (temp_bool & SYNC_MODE_COMPARE_DMA) != 0;
+            RuntimeConfig::Motion::nco_sync = (temp_bool & SYNC_MODE_NCO) != 0;
+        }
 
         // Z_Axis (All these are on Setup Page HMI)
         if (EE_ReadVariable(VIRT_ADDR_Z_AXIS_INV_DIR, &temp_bool) != EE_OK)
@@ -674,6 +712,7 @@ namespace SystemConfig
         RuntimeConfigDirtyFlags::Motion::thread_pitch = false;
         RuntimeConfigDirtyFlags::Motion::sync_frequency = false;
         RuntimeConfigDirtyFlags::Motion::sync_enabled = false;
+        RuntimeConfigDirtyFlags::Motion::sync_modes = false;
         RuntimeConfigDirtyFlags::Z_Axis::invert_direction = false;
         RuntimeConfigDirtyFlags::Z_Axis::motor_pulley_teeth = false;
         RuntimeConfigDirtyFlags::Z_Axis::lead_screw_pulley_teeth = false;
@@ -804,6 +843,11 @@ namespace SystemConfig
         SAVE_VAR_U32_IF_DIRTY(VIRT_ADDR_MOTION_SYNC_FREQ_L, VIRT_ADDR_MOTION_SYNC_FREQ_H, RuntimeConfig::Motion::sync_frequency, RuntimeConfigDirtyFlags::Motion::sync_frequency, "Motion Sync Freq");
         temp_bool = RuntimeConfig::Motion::sync_enabled ? 1 : 0;
         SAVE_VAR_IF_DIRTY(VIRT_ADDR_MOTION_SYNC_ENABLED, temp_bool, RuntimeConfigDirtyFlags::Motion::sync_enabled, u16, "Motion Sync Enabled");
+        temp_bool = (RuntimeConfig::Motion::edge_triggered_sync ? SYNC_MODE_EDGE_TRIGGERED : 0) |
+                    (RuntimeConfig::Motion::hardware_gearing ? SYNC_MODE_HARDWARE_GEARING : 0) |
+                    (RuntimeConfig::Motion::compare_dma_sync ? SYNC_MODE_COMPARE_DMA : 0) |
+                    (RuntimeConfig::Motion::nco_sync ? SYNC_MODE_NCO : 0);
+        SAVE_VAR_IF_DIRTY(VIRT_ADDR_MOTION_SYNC_MODES, temp_bool, RuntimeConfigDirtyFlags::Motion::sync_modes, u16, "Motion Sync Modes");
 
         // Z_Axis
         temp_bool = RuntimeConfig::Z_Axis::invert_direction ? 1 : 0;
@@ -1,22 +1,45 @@
 #include "Hardware/EncoderTimer.h"
 #include "Config/serial_debug.h" // For error printing
 #include "Config/SystemConfig.h" // For SystemConfig::RuntimeConfig::Encoder values
+#include "Hardware/DCache.h"     // For DCache::cleanForDma
 
 // Initialize static instance pointer for ISR callback
 EncoderTimer *EncoderTimer::instance = nullptr;
 
+// The compare table uses DMA1 stream 0; nothing else in the firmware claims it.
+extern "C" void DMA1_Stream0_IRQHandler(void)
+{
+    EncoderTimer::compareDmaIrqHandler();
+}
+
 /**
  * @brief Constructor for EncoderTimer.
  * Initializes member variables to default states.
  */
-EncoderTimer::EncoderTimer() : _currentCount(0), // Not strictly used for software extension currently
+EncoderTimer::EncoderTimer() : _timer(nullptr),
+                               _htim(nullptr),
+                               _hdmaCompare(),
+                               _compareTable(nullptr),
+                               _compareTableLength(0),
+                               _compareDmaInitialized(false),
+                               _compareTableActive(false),
+                               _speedTimer(nullptr),
+                               _hspeed(nullptr),
+                               _speedTicksPerSecond(1),
+                               _speedCapturePpr(0),
+                               _speedWindowPosition(0),
+                               _speedWindowStartUs(0),
+                               _speedWindowCountsPerSecond(0.0f),
+                               _epoch(0),
+                               _epochSequence(0),
+                               _origin(0),
                                _lastUpdateTime(0),
                                _error(false),
                                _initialized(false),
-                               _indexPulseOccurred(false) // Initialize new member
+                               _indexPulseOccurred(false), // Initialize new member
+                               _indexCount(0),
+                               _indexLatched(false)
 {
-    // Ensure htim2 structure is zeroed out before use by HAL
-    memset(static_cast<void *>(&htim2), 0, sizeof(htim2));
 }
 
 /**
@@ -59,15 +82,22 @@ bool EncoderTimer::begin()
         return false;
     }
 
-    // Enable timer update interrupt (for overflow/underflow, though not strictly used for count extension yet)
-    if (HAL_TIM_Base_Start_IT(&htim2) != HAL_OK)
+    // TIM2 interrupts are dispatched by the core's TIM2_IRQHandler to the HardwareTimer callbacks.
+    // Step-boundary compares are latency critical, so run them above the default timer priority.
+    _timer->setInterruptPriority(1, 0);
+    _timer->attachInterrupt(EncoderTimer::updateCallback); // Update (overflow/underflow)
+    _timer->attachInterrupt(STEP_BOUNDARY_FORWARD_CHANNEL, []()
+                            { if (instance) instance->handleStepBoundary(); });
+    _timer->attachInterrupt(STEP_BOUNDARY_BACKWARD_CHANNEL, []()
+                            { if (instance) instance->handleStepBoundary(); });
+    __HAL_TIM_DISABLE_IT(_htim, TIM_IT_CC3 | TIM_IT_CC4); // Armed on demand by armStepBoundaries()
+    __HAL_TIM_ENABLE_IT(_htim, TIM_IT_UPDATE);
+
+    if (!initSpeedCapture())
     {
-        _error = true;
-        // SerialDebug.println("CRITICAL: EncoderTimer failed to start TIM2 interrupts!");
-        return false;
+        // RPM falls back to counts per window; everything else is unaffected.
+        SerialDebug.println("EncoderTimer: TIM3 speed capture unavailable, using count windows only.");
     }
-    // __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_UPDATE); // Redundant if HAL_TIM_Base_Start_IT enables it. Check HAL docs.
-    // Typically HAL_TIM_Base_Start_IT is sufficient.
 
     _initialized = true;
     _error = false; // Clear error flag on successful initialization
@@ -114,12 +144,20 @@ bool EncoderTimer::initTimer()
 {
     __HAL_RCC_TIM2_CLK_ENABLE(); // Ensure TIM2 clock is enabled
 
-    htim2.Instance = TIM2;
-    htim2.Init.Prescaler = 0;                    // No prescaling, count every valid edge
-    htim2.Init.CounterMode = TIM_COUNTERMODE_UP; // Counter mode (UP or UP/DOWN, encoder mode overrides this)
-    htim2.Init.Period = 0xFFFFFFFF;              // Full 32-bit range for encoder count
-    htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-    htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE; // Not critical for encoder mode
+    // Owning TIM2 through HardwareTimer registers it with the core's TIM2_IRQHandler,
+    // which is what routes update and compare interrupts back to this class.
+    _timer = new HardwareTimer(TIM2);
+    if (!_timer)
+    {
+        return false;
+    }
+    _htim = _timer->getHandle();
+
+    _htim->Init.Prescaler = 0;                    // No prescaling, count every valid edge
+    _htim->Init.CounterMode = TIM_COUNTERMODE_UP; // Counter mode (UP or UP/DOWN, encoder mode overrides this)
+    _htim->Init.Period = 0xFFFFFFFF;              // Full 32-bit range for encoder count
+    _htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    _htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE; // Not critical for encoder mode
 
     TIM_Encoder_InitTypeDef encoder_config = {0};
     encoder_config.EncoderMode = TIM_ENCODERMODE_TI12;                             // Count on both TI1 and TI2 edges (x4 quadrature)
@@ -132,7 +170,7 @@ bool EncoderTimer::initTimer()
     encoder_config.IC2Prescaler = TIM_ICPSC_DIV1;                                  // No prescaler for input
     encoder_config.IC2Filter = SystemConfig::RuntimeConfig::Encoder::filter_level; // Input filter
 
-    if (HAL_TIM_Encoder_Init(&htim2, &encoder_config) != HAL_OK)
+    if (HAL_TIM_Encoder_Init(_htim, &encoder_config) != HAL_OK)
     {
         // SerialDebug.println("CRITICAL: HAL_TIM_Encoder_Init failed!");
         return false; // HAL encoder initialization failed
@@ -145,25 +183,104 @@ bool EncoderTimer::initTimer()
     // sSlaveConfig.TriggerPolarity = TIM_TRIGGERPOLARITY_FALLING; // Active LOW Z-pulse (NPN open-collector with pull-up)
     // sSlaveConfig.TriggerPrescaler = TIM_TRIGGERPRESCALER_DIV1;  // No prescaler
     // sSlaveConfig.TriggerFilter = 8;                             // Increased filter value (e.g., 8, range 0x0 to 0xF)
-    // if (HAL_TIM_SlaveConfigSynchronization(&htim2, &sSlaveConfig) != HAL_OK)
+    // if (HAL_TIM_SlaveConfigSynchronization(_htim, &sSlaveConfig) != HAL_OK)
     // {
     //     // SerialDebug.println("CRITICAL: HAL_TIM_SlaveConfigSynchronization for ETR failed!");
     //     return false;
     // }
 
-    if (HAL_TIM_Encoder_Start(&htim2, TIM_CHANNEL_ALL) != HAL_OK)
+    if (HAL_TIM_Encoder_Start(_htim, TIM_CHANNEL_ALL) != HAL_OK)
     {
         // SerialDebug.println("CRITICAL: HAL_TIM_Encoder_Start failed!");
         return false; // Failed to start encoder channels
     }
 
     // Enable the TIM2 Trigger interrupt for ETR // Keep this commented for Stage 1
-    // __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_TRIGGER);
+    // __HAL_TIM_ENABLE_IT(_htim, TIM_IT_TRIGGER);
     // SerialDebug.println("DEBUG: TIM2 Trigger Interrupt (ETR) enabled.");
 
+    // One TRGO pulse per encoder line (see class description)
+    MODIFY_REG(_htim->Instance->CR2, TIM_CR2_MMS, TIM_TRGO_OC1);
+
     return true;
 }
 
+/**
+ * @brief Sets up TIM3 to measure the encoder line period.
+ * Combined reset + trigger slave mode on ITR1 (TIM2 TRGO): each line edge captures the counter
+ * into CCR1 (IC1 on TRC) and restarts it from 0. One-pulse mode stops it at the 16-bit overflow.
+ * @return True if TIM3 was configured.
+ */
+bool EncoderTimer::initSpeedCapture()
+{
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    _speedTimer = new HardwareTimer(TIM3);
+    if (!_speedTimer)
+    {
+        return false;
+    }
+    _hspeed = _speedTimer->getHandle();
+
+    uint32_t prescaler = speedCapturePrescaler();
+    _speedTicksPerSecond = _speedTimer->getTimerClkFreq() / prescaler;
+    _speedCapturePpr = SystemConfig::RuntimeConfig::Encoder::ppr;
+
+    _hspeed->Init.Prescaler = prescaler - 1;
+    _hspeed->Init.CounterMode = TIM_COUNTERMODE_UP;
+    _hspeed->Init.Period = 0xFFFF;
+    _hspeed->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    _hspeed->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_IC_Init(_hspeed) != HAL_OK)
+    {
+        return false;
+    }
+
+    TIM_SlaveConfigTypeDef slaveConfig = {0};
+    slaveConfig.SlaveMode = TIM_SLAVEMODE_COMBINED_RESETTRIGGER;
+    slaveConfig.InputTrigger = TIM_TS_ITR1; // ITR1 connects TIM2 TRGO to TIM3 on STM32H7
+    if (HAL_TIM_SlaveConfigSynchro(_hspeed, &slaveConfig) != HAL_OK)
+    {
+        return false;
+    }
+
+    TIM_IC_InitTypeDef icConfig = {0};
+    icConfig.ICPolarity = TIM_ICPOLARITY_RISING;
+    icConfig.ICSelection = TIM_ICSELECTION_TRC;
+    icConfig.ICPrescaler = TIM_ICPSC_DIV1;
+    icConfig.ICFilter = 0;
+    if (HAL_TIM_IC_ConfigChannel(_hspeed, &icConfig, TIM_CHANNEL_1) != HAL_OK)
+    {
+        return false;
+    }
+
+    SET_BIT(_hspeed->Instance->CR1, TIM_CR1_OPM);
+    // The slave trigger sets CEN on the first line edge; HAL leaves the counter stopped until then.
+    return HAL_TIM_IC_Start(_hspeed, TIM_CHANNEL_1) == HAL_OK;
+}
+
+/**
+ * @brief Coarsest TIM3 tick that still resolves SPEED_CAPTURE_HZ, but no finer than lets one
+ * 16-bit period span a line at SPEED_CAPTURE_MIN_RPM (at 1 MHz that would only reach ~9 RPM
+ * with a 100 PPR disk).
+ */
+uint32_t EncoderTimer::speedCapturePrescaler() const
+{
+    using EncoderLimits = SystemConfig::Limits::Encoder;
+
+    uint32_t ppr = SystemConfig::RuntimeConfig::Encoder::ppr;
+    uint64_t tickHz = static_cast<uint64_t>(0xFFFF) * (ppr ? ppr : 1) * EncoderLimits::SPEED_CAPTURE_MIN_RPM / 60;
+    if (tickHz == 0 || tickHz > EncoderLimits::SPEED_CAPTURE_HZ)
+        tickHz = EncoderLimits::SPEED_CAPTURE_HZ;
+
+    uint32_t clock = _speedTimer->getTimerClkFreq();
+    uint32_t prescaler = static_cast<uint32_t>((clock + tickHz - 1) / tickHz); // Round up: the period must still fit
+    if (prescaler == 0)
+        prescaler = 1;
+    else if (prescaler > 0x10000)
+        prescaler = 0x10000;
+    return prescaler;
+}
+
 /**
  * @brief De-initializes the timer and GPIOs used by the encoder.
  * Stops the timer and disables its interrupt.
@@ -173,43 +290,80 @@ void EncoderTimer::end()
     if (!_initialized)
         return;
 
-    HAL_NVIC_DisableIRQ(TIM2_IRQn);                // Disable TIM2 interrupt in NVIC
-    HAL_TIM_Encoder_Stop(&htim2, TIM_CHANNEL_ALL); // Stop encoder channels
-    HAL_TIM_Base_DeInit(&htim2);                   // De-initialize TIM2 base
+    stopCompareTable();
+    disarmStepBoundaries();
+    _timer->detachInterrupt();
+    _timer->detachInterrupt(STEP_BOUNDARY_FORWARD_CHANNEL);
+    _timer->detachInterrupt(STEP_BOUNDARY_BACKWARD_CHANNEL);
+    HAL_TIM_Encoder_Stop(_htim, TIM_CHANNEL_ALL); // Stop encoder channels
+    delete _timer;                                // HardwareTimer de-initializes TIM2 and its IRQ
+    _timer = nullptr;
+    _htim = nullptr;
+    if (_speedTimer)
+    {
+        HAL_TIM_IC_Stop(_hspeed, TIM_CHANNEL_1);
+        delete _speedTimer;
+        _speedTimer = nullptr;
+        _hspeed = nullptr;
+    }
     // GPIO de-initialization could be added here if necessary
     _initialized = false;
 }
 
 /**
- * @brief Resets the software encoder count and error status.
- * Also resets the hardware timer's counter register to 0.
- * Interrupts are temporarily disabled during reset for atomicity.
+ * @brief Moves the relative-count origin to the current absolute position and clears the error status.
+ * The hardware counter is left alone.
  */
 void EncoderTimer::reset()
 {
     if (!_initialized)
         return;
 
-    __disable_irq();
-    _currentCount = 0; // Reset software state (though not primarily used for count)
+    _origin = getAbsolutePosition();
     _error = false;
-    __HAL_TIM_SET_COUNTER(&htim2, 0); // Reset hardware counter
-    _lastUpdateTime = HAL_GetTick();  // Reset time for RPM calculation
-    // Also reset static variables in calculateRPM if it's to be fully reset
-    // This requires a non-const method or a different approach for calculateRPM's statics.
-    // For now, calculateRPM will continue from its last state unless its statics are also reset.
-    __enable_irq();
+    _lastUpdateTime = HAL_GetTick();
 }
 
 /**
- * @brief Gets the current raw encoder count from the hardware timer.
- * @return The 32-bit value of TIM2's counter register.
+ * @brief Gets the encoder count relative to the last reset().
+ * @return Absolute position minus the reset() origin, truncated to 32 bits.
  */
 int32_t EncoderTimer::getCount() const
 {
     if (!_initialized)
         return 0;
-    return (int32_t)__HAL_TIM_GET_COUNTER(&htim2);
+    return static_cast<int32_t>(getAbsolutePosition() - _origin);
+}
+
+/**
+ * @brief Reads epoch and counter under the update interrupt's sequence count.
+ * If the update flag is pending, TIM2 has wrapped but the epoch does not show it yet; the
+ * counter is then re-read (so it is certainly past the wrap) and the half it lies in tells
+ * which way it wrapped.
+ */
+int64_t EncoderTimer::getAbsolutePosition() const
+{
+    if (!_initialized)
+        return 0;
+
+    uint32_t sequence;
+    int32_t epoch;
+    uint32_t count;
+    do
+    {
+        sequence = _epochSequence;
+        __DMB();
+        epoch = _epoch;
+        count = __HAL_TIM_GET_COUNTER(_htim);
+        if (__HAL_TIM_GET_FLAG(_htim, TIM_FLAG_UPDATE))
+        {
+            count = __HAL_TIM_GET_COUNTER(_htim);
+            epoch += (count < 0x80000000UL) ? 1 : -1;
+        }
+        __DMB();
+    } while ((sequence & 1) != 0 || sequence != _epochSequence);
+
+    return static_cast<int64_t>(epoch) * 0x100000000LL + count;
 }
 
 /**
@@ -225,29 +379,222 @@ void EncoderTimer::updateCallback() // Static
 }
 
 /**
- * @brief Handles the timer update interrupt (typically overflow/underflow).
- * This method is called from the ISR context via updateCallback.
- * It updates the _lastUpdateTime timestamp.
- * Note: With a 32-bit hardware counter, overflows are rare unless the spindle runs
- * at extremely high speeds for very long periods without the count being read or reset.
- * This ISR is primarily for future extension or specific overflow handling if needed.
+ * @brief Handles the timer update interrupt (overflow/underflow) from the ISR context.
+ * The counter is nowhere near the wrap point again for 2^31 counts, so the half it lies in
+ * says which way it wrapped; unlike the DIR bit, that stays right when the interrupt is late
+ * or the spindle dithers across the wrap.
  */
 void EncoderTimer::handleOverflow()
 {
     if (!_initialized)
         return;
+    _epochSequence = _epochSequence + 1;
+    __DMB();
+    _epoch = _epoch + ((__HAL_TIM_GET_COUNTER(_htim) < 0x80000000UL) ? 1 : -1);
+    __DMB();
+    _epochSequence = _epochSequence + 1;
     _lastUpdateTime = HAL_GetTick();
-    // Add any specific logic for handling a 32-bit counter overflow if necessary.
-    // For typical ELS usage, the 32-bit count range is usually sufficient.
+}
+
+bool EncoderTimer::isCountingDown() const
+{
+    if (!_initialized)
+        return false;
+    return __HAL_TIM_IS_TIM_COUNTING_DOWN(_htim);
+}
+
+/**
+ * @brief Arms TIM2 CH3/CH4 compares at the next forward/backward step boundary counts.
+ * Flags are cleared before the interrupts are enabled so a stale match cannot fire.
+ */
+void EncoderTimer::armStepBoundaries(uint32_t upCount, uint32_t downCount)
+{
+    if (!_initialized)
+        return;
+
+    __HAL_TIM_SET_COMPARE(_htim, TIM_CHANNEL_3, upCount);
+    __HAL_TIM_SET_COMPARE(_htim, TIM_CHANNEL_4, downCount);
+    __HAL_TIM_CLEAR_FLAG(_htim, TIM_FLAG_CC3 | TIM_FLAG_CC4);
+    __HAL_TIM_ENABLE_IT(_htim, TIM_IT_CC3 | TIM_IT_CC4);
+}
+
+/**
+ * @brief Disables both step-boundary compare interrupts.
+ */
+void EncoderTimer::disarmStepBoundaries()
+{
+    if (!_htim)
+        return;
+
+    __HAL_TIM_DISABLE_IT(_htim, TIM_IT_CC3 | TIM_IT_CC4);
+    __HAL_TIM_CLEAR_FLAG(_htim, TIM_FLAG_CC3 | TIM_FLAG_CC4);
+}
+
+void EncoderTimer::setStepBoundaryCallback(callback_function_t callback)
+{
+    __disable_irq();
+    _stepBoundaryCallback = callback;
+    __enable_irq();
+}
+
+/**
+ * @brief Called from the TIM2 CH3/CH4 compare interrupt.
+ * Both channels are disarmed before the consumer runs; it re-arms with new boundaries.
+ */
+void EncoderTimer::handleStepBoundary()
+{
+    disarmStepBoundaries();
+    if (_stepBoundaryCallback)
+    {
+        _stepBoundaryCallback();
+    }
+}
+
+/**
+ * @brief Configures DMA1 stream 0 for memory -> TIM2 CCR3 word transfers on the CC3 request.
+ * Circular, so the hardware wraps over the ring and only the refills need the CPU.
+ */
+bool EncoderTimer::initCompareDma()
+{
+    if (_compareDmaInitialized)
+        return true;
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    _hdmaCompare.Instance = DMA1_Stream0;
+    _hdmaCompare.Init.Request = COMPARE_DMA_REQUEST;
+    _hdmaCompare.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    _hdmaCompare.Init.PeriphInc = DMA_PINC_DISABLE;
+    _hdmaCompare.Init.MemInc = DMA_MINC_ENABLE;
+    _hdmaCompare.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    _hdmaCompare.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    _hdmaCompare.Init.Mode = DMA_CIRCULAR;
+    _hdmaCompare.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    _hdmaCompare.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&_hdmaCompare) != HAL_OK)
+    {
+        return false;
+    }
+
+    _hdmaCompare.XferHalfCpltCallback = [](DMA_HandleTypeDef *)
+    { if (instance) instance->handleCompareRefill(false); };
+    _hdmaCompare.XferCpltCallback = [](DMA_HandleTypeDef *)
+    { if (instance) instance->handleCompareRefill(true); };
+
+    // Same priority as the step-boundary compares: a late refill is a missed step.
+    HAL_NVIC_SetPriority(COMPARE_DMA_IRQ, 1, 0);
+    _compareDmaInitialized = true;
+    return true;
 }
 
 /**
- * @brief Internal callback called when an index pulse (ETR) occurs.
- * Sets a flag that can be checked by the main application.
- * This function is called from the HAL_TIM_TriggerCallback.
+ * @brief Starts streaming compare positions into CCR3.
+ * OC3REF is forced low first so the first match is a rising TRGO edge. CCR3 preload stays
+ * disabled (HAL_TIM_OC_ConfigChannel leaves OC3PE clear), so each DMA write takes effect at once.
  */
-void EncoderTimer::IndexPulse_Callback_Internal()
+bool EncoderTimer::startCompareTable(uint32_t *table, uint32_t length, CompareTableRefill refill)
 {
+    if (!_initialized || !table || !refill || length < 4 || (length & 1) != 0)
+        return false;
+    if (!initCompareDma())
+        return false;
+
+    stopCompareTable();
+    disarmStepBoundaries();
+
+    _compareTable = table;
+    _compareTableLength = length;
+    _compareRefill = refill;
+
+    uint32_t firstCompare = 0;
+    _compareRefill(&firstCompare, 1);
+    _compareRefill(_compareTable, _compareTableLength);
+    DCache::cleanForDma(_compareTable, _compareTableLength * sizeof(uint32_t));
+
+    TIM_OC_InitTypeDef ocConfig = {0};
+    ocConfig.OCMode = TIM_OCMODE_FORCED_INACTIVE;
+    ocConfig.Pulse = firstCompare;
+    ocConfig.OCPolarity = TIM_OCPOLARITY_HIGH;
+    ocConfig.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_OC_ConfigChannel(_htim, &ocConfig, TIM_CHANNEL_3) != HAL_OK)
+    {
+        return false;
+    }
+    MODIFY_REG(_htim->Instance->CCMR2, TIM_CCMR2_OC3M, TIM_OCMODE_TOGGLE);
+    __HAL_TIM_CLEAR_FLAG(_htim, TIM_FLAG_CC3);
+
+    if (HAL_DMA_Start_IT(&_hdmaCompare, reinterpret_cast<uint32_t>(_compareTable),
+                         reinterpret_cast<uint32_t>(&_htim->Instance->CCR3), _compareTableLength) != HAL_OK)
+    {
+        MODIFY_REG(_htim->Instance->CCMR2, TIM_CCMR2_OC3M, TIM_OCMODE_TIMING);
+        return false;
+    }
+    HAL_NVIC_EnableIRQ(COMPARE_DMA_IRQ);
+    __HAL_TIM_ENABLE_DMA(_htim, TIM_DMA_CC3);
+    MODIFY_REG(_htim->Instance->CR2, TIM_CR2_MMS, TIM_TRGO_OC3REF);
+    _compareTableActive = true;
+    return true;
+}
+
+/**
+ * @brief Stops the compare DMA. CH3 goes back to frozen compare so the step-boundary
+ * interrupts can reuse it, and TRGO goes back to line edges.
+ */
+void EncoderTimer::stopCompareTable()
+{
+    if (!_compareTableActive || !_htim)
+        return;
+
+    __HAL_TIM_DISABLE_DMA(_htim, TIM_DMA_CC3);
+    HAL_DMA_Abort(&_hdmaCompare);
+    HAL_NVIC_DisableIRQ(COMPARE_DMA_IRQ);
+    MODIFY_REG(_htim->Instance->CR2, TIM_CR2_MMS, TIM_TRGO_OC1);
+    MODIFY_REG(_htim->Instance->CCMR2, TIM_CCMR2_OC3M, TIM_OCMODE_TIMING);
+    __HAL_TIM_CLEAR_FLAG(_htim, TIM_FLAG_CC3);
+    _compareTableActive = false;
+}
+
+uint32_t EncoderTimer::getActiveCompare() const
+{
+    if (!_initialized)
+        return 0;
+    return __HAL_TIM_GET_COMPARE(_htim, TIM_CHANNEL_3);
+}
+
+void EncoderTimer::compareDmaIrqHandler() // Static
+{
+    if (instance)
+    {
+        HAL_DMA_IRQHandler(&instance->_hdmaCompare);
+    }
+}
+
+/**
+ * @brief The half that was just transferred is no longer needed by the DMA; the other half
+ * (at least length / 2 entries) keeps the compares going while it is rewritten.
+ */
+void EncoderTimer::handleCompareRefill(bool secondHalf)
+{
+    if (!_compareTableActive || !_compareRefill)
+        return;
+
+    uint32_t half = _compareTableLength / 2;
+    uint32_t *entries = secondHalf ? _compareTable + half : _compareTable;
+    _compareRefill(entries, half);
+    DCache::cleanForDma(entries, half * sizeof(uint32_t));
+}
+
+/**
+ * @brief Internal callback called when an index pulse occurs.
+ * Stores the count the PA5 EXTI handler latched on entry, then sets a flag that can be checked
+ * by the main application.
+ */
+void EncoderTimer::IndexPulse_Callback_Internal(uint32_t count)
+{
+    if (!_initialized)
+        return;
+    _indexCount = count;
+    _indexLatched = true;
     _indexPulseOccurred = true;
     // SerialDebug.println("DEBUG ISR: Index Pulse (TIM2_ETR) Detected!");
 }
@@ -267,6 +614,19 @@ bool EncoderTimer::hasIndexPulseOccurred()
     return false;
 }
 
+bool EncoderTimer::getIndexCount(uint32_t &count) const
+{
+    if (!_indexLatched)
+        return false;
+    count = _indexCount;
+    return true;
+}
+
+uint32_t EncoderTimer::getCountsPerRevolution() const
+{
+    return static_cast<uint32_t>(SystemConfig::RuntimeConfig::Encoder::ppr) * SystemConfig::Limits::Encoder::QUADRATURE_MULT;
+}
+
 /**
  * @brief Gets the complete current position and speed data from the encoder.
  * @return EncoderTimer::Position struct populated with current count, timestamp, RPM, direction, and validity.
@@ -279,66 +639,125 @@ EncoderTimer::Position EncoderTimer::getPosition() const
     if (!_initialized)
         return pos;
 
-    pos.count = getCount();                                 // Hardware count
+    pos.count = getCount();                                 // Count since reset()
     pos.timestamp = HAL_GetTick();                          // Current timestamp
-    pos.direction = __HAL_TIM_IS_TIM_COUNTING_DOWN(&htim2); // True if counting down
-    pos.rpm = calculateRPM();
+    pos.direction = __HAL_TIM_IS_TIM_COUNTING_DOWN(_htim); // True if counting down
+    pos.rpm = getRPM();
     pos.valid = !_error;
 
     return pos;
 }
 
 /**
- * @brief Calculates the current Revolutions Per Minute (RPM) of the spindle.
- * This method uses static local variables to store the previous count and time,
- * allowing calculation of RPM based on the change in count over the change in time.
- * It respects the `SystemConfig::RuntimeConfig::Encoder::invert_direction` flag.
- * @return Calculated RPM as a signed 16-bit integer. Returns 0 if deltaTime is too small.
+ * @brief Picks the period or the window estimate.
+ * TIM3 runs one-pulse: a full 16-bit period without a line edge stops it, which reads as standstill.
+ * The elapsed count since the last edge bounds the period from below, so a decelerating spindle
+ * is followed before its next edge arrives. While the compare table drives TRGO, TIM3 sees steps
+ * rather than lines, so only the window is used.
  */
-int16_t EncoderTimer::calculateRPM() const
+float EncoderTimer::getCountsPerSecond() const
 {
-    static uint32_t lastStaticCount = 0; // Renamed to avoid confusion with member _currentCount
-    static uint32_t lastStaticTime = 0;  // Using 'static' here means these persist across calls
+    using EncoderLimits = SystemConfig::Limits::Encoder;
 
-    uint32_t currentTime = HAL_GetTick();
-    uint32_t deltaTime = currentTime - lastStaticTime;
+    if (!_initialized)
+        return 0.0f;
 
-    // Prevent division by zero or noisy RPM from very small deltaTime
-    if (deltaTime < SystemConfig::Limits::Encoder::MIN_RPM_DELTA_TIME_MS) // e.g., 10ms
-        return 0;
+    if (_hspeed && _speedCapturePpr != SystemConfig::RuntimeConfig::Encoder::ppr)
+    {
+        // PPR changed in setup: the prescaler loads on the next line edge's reset. Until that edge
+        // the period in hand is read at the new rate, a one-line glitch that only happens in setup.
+        uint32_t prescaler = speedCapturePrescaler();
+        _hspeed->Instance->PSC = prescaler - 1;
+        _speedTicksPerSecond = _speedTimer->getTimerClkFreq() / prescaler;
+        _speedCapturePpr = SystemConfig::RuntimeConfig::Encoder::ppr;
+    }
+    if (_hspeed && !_compareTableActive)
+    {
+        if ((_hspeed->Instance->CR1 & TIM_CR1_CEN) == 0)
+        {
+            windowCountsPerSecond(); // Keep the window current for when the spindle picks up
+            return 0.0f;
+        }
+        uint32_t period = __HAL_TIM_GET_COMPARE(_hspeed, TIM_CHANNEL_1); // 0: first edge after a standstill
+        uint32_t elapsed = __HAL_TIM_GET_COUNTER(_hspeed);
+        if (period != 0 && elapsed > period)
+            period = elapsed;
+        if (period >= EncoderLimits::SPEED_PERIOD_MIN_TICKS)
+        {
+            windowCountsPerSecond();
+            float countsPerSecond = static_cast<float>(EncoderLimits::QUADRATURE_MULT) * static_cast<float>(_speedTicksPerSecond) / static_cast<float>(period);
+            return isCountingDown() ? -countsPerSecond : countsPerSecond;
+        }
+    }
+    return windowCountsPerSecond();
+}
 
-    int32_t currentHardwareCount = (int32_t)__HAL_TIM_GET_COUNTER(&htim2);
-    int32_t deltaCounts = currentHardwareCount - lastStaticCount;
+float EncoderTimer::windowCountsPerSecond() const
+{
+    uint32_t nowUs = micros();
+    uint32_t elapsedUs = nowUs - _speedWindowStartUs;
+    if (elapsedUs >= SystemConfig::Limits::Encoder::SPEED_WINDOW_US)
+    {
+        int64_t position = getAbsolutePosition();
+        _speedWindowCountsPerSecond = static_cast<float>(position - _speedWindowPosition) * 1000000.0f / static_cast<float>(elapsedUs);
+        _speedWindowPosition = position;
+        _speedWindowStartUs = nowUs;
+    }
+    return _speedWindowCountsPerSecond;
+}
 
-    // Update static variables for the next call
-    lastStaticCount = currentHardwareCount;
-    lastStaticTime = currentTime;
+/**
+ * @brief Interpolates between encoder counts from the last line edge and line period.
+ * TIM2 CCR1 holds the count captured on the channel A edge that also restarted TIM3.
+ */
+bool EncoderTimer::getSubCountFraction(uint32_t count, int32_t &fraction) const
+{
+    using EncoderLimits = SystemConfig::Limits::Encoder;
 
-    if (deltaCounts == 0) // No change in count, so RPM is 0
-        return 0;
+    fraction = 0;
+    if (!_initialized || !_hspeed || _compareTableActive || (_hspeed->Instance->CR1 & TIM_CR1_CEN) == 0)
+    {
+        return false;
+    }
+    uint32_t period = __HAL_TIM_GET_COMPARE(_hspeed, TIM_CHANNEL_1);
+    uint32_t elapsed = __HAL_TIM_GET_COUNTER(_hspeed);
+    uint32_t lineCount = __HAL_TIM_GET_COMPARE(_htim, TIM_CHANNEL_1);
+    if (period == 0)
+    {
+        return false;
+    }
+
+    bool down = isCountingDown();
+    int32_t countsSinceEdge = static_cast<int32_t>(down ? lineCount - count : count - lineCount);
+    if (countsSinceEdge < 0 || countsSinceEdge >= static_cast<int32_t>(EncoderLimits::QUADRATURE_MULT))
+    {
+        return false; // An edge landed between the reads, or the direction just changed
+    }
 
-    // Calculate RPM magnitude
-    // RPM = (deltaCounts / (PPR * QuadratureFactor)) / (deltaTime_seconds) * 60
-    // Note: TIM_ENCODERMODE_TI12 already provides x4 quadrature count.
-    // So, SystemConfig::RuntimeConfig::Encoder::ppr should be the true PPR of the encoder disk.
-    // The hardware counter gives (PPR * 4) counts per revolution.
-    // RPM = (deltaCounts_quad / (PPR_true * 4)) / (deltaTime_ms / 1000.0) * 60.0
-    // RPM = (deltaCounts_quad * 60000.0) / (PPR_true * 4 * deltaTime_ms)
-    // RPM = (deltaCounts_quad * 15000.0) / (PPR_true * deltaTime_ms)
-    // This matches the original scaling if SystemConfig::RuntimeConfig::Encoder::ppr is true PPR.
-
-    // Ensure PPR is not zero to avoid division by zero
+    // elapsed < 2^16, so this stays well inside 32 bits.
+    int32_t sinceEdge = static_cast<int32_t>(elapsed * EncoderLimits::QUADRATURE_MULT * EncoderLimits::SUBCOUNT_SCALE / period);
+    int32_t within = sinceEdge - countsSinceEdge * static_cast<int32_t>(EncoderLimits::SUBCOUNT_SCALE);
+    if (within < 0)
+        within = 0; // Spindle speeding up: the count arrived before the old period predicted
+    else if (within >= static_cast<int32_t>(EncoderLimits::SUBCOUNT_SCALE))
+        within = EncoderLimits::SUBCOUNT_SCALE - 1; // Slowing down: wait at the edge
+    fraction = down ? -within : within;
+    return true;
+}
+
+/**
+ * @brief Converts getCountsPerSecond() to encoder shaft RPM.
+ * RPM = counts/s * 60 / (PPR * QUADRATURE_MULT); ppr must be the true PPR of the encoder disk.
+ * @return Current RPM.
+ */
+int16_t EncoderTimer::getRPM() const
+{
     uint32_t ppr_val = SystemConfig::RuntimeConfig::Encoder::ppr;
     if (ppr_val == 0)
-        return 0; // Or handle as an error
-
-    // Use floating point for precision in intermediate calculation
-    double rpm_double = (static_cast<double>(deltaCounts) * 15000.0) / (static_cast<double>(ppr_val) * static_cast<double>(deltaTime));
-    int16_t rpmMagnitude = static_cast<int16_t>(round(rpm_double)); // Round to nearest integer
+        return 0;
 
-    // Apply direction based on timer counting direction
-    bool isCountingDown = __HAL_TIM_IS_TIM_COUNTING_DOWN(&htim2);
-    int16_t finalRpm = isCountingDown ? -rpmMagnitude : rpmMagnitude;
+    float rpm = getCountsPerSecond() * 60.0f / (static_cast<float>(ppr_val) * SystemConfig::Limits::Encoder::QUADRATURE_MULT);
+    int16_t finalRpm = static_cast<int16_t>(roundf(rpm));
 
     // Apply software inversion if configured
     if (SystemConfig::RuntimeConfig::Encoder::invert_direction)
@@ -348,33 +767,24 @@ int16_t EncoderTimer::calculateRPM() const
     return finalRpm;
 }
 
-/**
- * @brief Convenience method to get the calculated RPM.
- * @return Current RPM.
- */
-int16_t EncoderTimer::getRPM() const
-{
-    return calculateRPM();
-}
-
 // Implementation for new accessor methods from header
 uint32_t EncoderTimer::getRawCounter() const
 {
     if (!_initialized)
         return 0;
-    return __HAL_TIM_GET_COUNTER(&htim2);
+    return __HAL_TIM_GET_COUNTER(_htim);
 }
 
 uint32_t EncoderTimer::getTimerStatus() const
 {
     if (!_initialized)
         return 0;
-    return __HAL_TIM_GET_FLAG(&htim2, TIM_FLAG_UPDATE);
+    return __HAL_TIM_GET_FLAG(_htim, TIM_FLAG_UPDATE);
 }
 
 uint32_t EncoderTimer::getTimerCR1() const
 {
     if (!_initialized)
         return 0;
-    return htim2.Instance->CR1;
+    return _htim->Instance->CR1;
 }
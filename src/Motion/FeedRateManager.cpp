@@ -2,6 +2,7 @@
 #include <Arduino.h> // For String class
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 extern HardwareSerial SerialDebug; // Use SerialDebug directly
 
@@ -151,7 +152,7 @@ bool FeedRateManager::getCurrentWarning() const
     return table[currentIndex].warning;
 }
 
-void FeedRateManager::getDisplayString(char *buffer, size_t size) const
+void FeedRateManager::getDisplayString(char *buffer, size_t size, uint16_t overridePercent) const
 {
     const FeedRate *table = getCurrentTable();
     if (!table || currentIndex >= getCurrentTableSize())
@@ -165,17 +166,18 @@ void FeedRateManager::getDisplayString(char *buffer, size_t size) const
     // SerialDebug.println(this->isMetric ? "true (metric)" : "false (imperial)"); // Removed
     const char *unit = this->isMetric ? "mm/rev" : "in/rev";
     String float_str; // Arduino String object
+    double value = current.value * overridePercent / 100.0;
 
     // Format with appropriate precision based on unit system
     if (isMetric)
     {
-        float_str = String(current.value, 2); // Display all metric values with 2 decimal places
+        float_str = String(value, 2); // Display all metric values with 2 decimal places
         snprintf(buffer, size, "%s %s",       // Output: "VALUE UNIT"
                  float_str.c_str(), unit);
     }
     else // Imperial
     {
-        float_str = String(current.value, 4); // Display with 4 decimal places
+        float_str = String(value, 4); // Display with 4 decimal places
         // Trim trailing zeros
         while (float_str.length() > 1 &&
                float_str.charAt(float_str.length() - 1) == '0' &&
@@ -186,6 +188,11 @@ void FeedRateManager::getDisplayString(char *buffer, size_t size) const
         snprintf(buffer, size, "%s %s", // Output: "VALUE UNIT"
                  float_str.c_str(), unit);
     }
+    if (overridePercent != 100)
+    {
+        size_t len = strlen(buffer);
+        snprintf(buffer + len, size - len, " @%u%%", overridePercent); // Output: "VALUE UNIT @110%"
+    }
 }
 
 const FeedRateManager::FeedRate *FeedRateManager::getCurrentTable() const
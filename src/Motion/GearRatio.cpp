@@ -0,0 +1,231 @@
+#include "Motion/GearRatio.h"
+#include "Config/SystemConfig.h"
+#include <cmath>
+
+namespace
+{
+    // Feed and metric leadscrew pitches are taken to 0.1 um before being made rational.
+    constexpr uint32_t PITCH_RESOLUTION_PER_MM = 10000;
+    // Imperial thread and leadscrew TPI are taken to 0.01 TPI.
+    constexpr uint32_t TPI_RESOLUTION = 100;
+
+    uint64_t gcd64(uint64_t a, uint64_t b)
+    {
+        while (b != 0)
+        {
+            uint64_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    /**
+     * @brief Accumulates a product of small integer factors as num/den,
+     * cancelling common factors as it goes so the terms stay as small as possible.
+     */
+    struct RationalProduct
+    {
+        uint64_t num = 1;
+        uint64_t den = 1;
+        bool exact = true;
+
+        void multiply(uint64_t factor)
+        {
+            if (factor == 0)
+            {
+                num = 0;
+                den = 1;
+                return;
+            }
+            uint64_t g = gcd64(factor, den);
+            factor /= g;
+            den /= g;
+            while (num > UINT64_MAX / factor)
+            {
+                // Practically unreachable with real machine parameters; keep the ratio, lose the exactness.
+                num >>= 1;
+                den = (den >> 1) ? (den >> 1) : 1;
+                exact = false;
+            }
+            num *= factor;
+        }
+
+        void divide(uint64_t factor)
+        {
+            if (factor == 0)
+            {
+                return;
+            }
+            uint64_t g = gcd64(factor, num);
+            factor /= g;
+            num /= g;
+            while (den > UINT64_MAX / factor)
+            {
+                den >>= 1;
+                num >>= 1;
+                exact = false;
+            }
+            den *= factor;
+        }
+    };
+}
+
+GearRatio GearRatio::fromFraction(uint64_t num, uint64_t den)
+{
+    if (den == 0)
+    {
+        return GearRatio(0, 1, false);
+    }
+    if (num == 0)
+    {
+        return GearRatio(0, 1, true);
+    }
+
+    uint64_t g = gcd64(num, den);
+    num /= g;
+    den /= g;
+    if (num <= MAX_TERM && den <= MAX_TERM)
+    {
+        return GearRatio(static_cast<uint32_t>(num), static_cast<uint32_t>(den), true);
+    }
+
+    // Walk the continued-fraction convergents of num/den and keep the last one that fits.
+    uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    uint64_t n = num, d = den;
+    while (d != 0)
+    {
+        uint64_t a = n / d;
+        if (p1 != 0 && a > (MAX_TERM - p0) / p1)
+            break;
+        if (q1 != 0 && a > (MAX_TERM - q0) / q1)
+            break;
+        uint64_t p2 = a * p1 + p0;
+        uint64_t q2 = a * q1 + q0;
+        p0 = p1;
+        q0 = q1;
+        p1 = p2;
+        q1 = q2;
+        uint64_t r = n - a * d;
+        n = d;
+        d = r;
+    }
+
+    if (q1 == 0)
+    {
+        // More than MAX_TERM steps per count; not a meaningful machine setup.
+        return GearRatio(MAX_TERM, 1, false);
+    }
+    return GearRatio(static_cast<uint32_t>(p1), static_cast<uint32_t>(q1), false);
+}
+
+GearRatio GearRatio::forFeed(float pitch_mm, float pitch_tpi)
+{
+    using namespace SystemConfig;
+
+    RationalProduct r;
+
+    // Feed per spindle revolution (mm/rev).
+    float abs_pitch_mm = fabsf(pitch_mm);
+    long tpi_scaled = lroundf(pitch_tpi * TPI_RESOLUTION);
+    if (tpi_scaled > 0)
+    {
+        // 25.4 * starts / TPI, exact. Multi-start leads arrive as starts x single pitch.
+        long starts = lroundf(abs_pitch_mm * pitch_tpi / 25.4f);
+        if (starts < 1)
+            starts = 1;
+        r.multiply(254UL * TPI_RESOLUTION / 10UL * static_cast<uint64_t>(starts));
+        r.divide(static_cast<uint64_t>(tpi_scaled));
+    }
+    else
+    {
+        r.multiply(static_cast<uint64_t>(lroundf(abs_pitch_mm * PITCH_RESOLUTION_PER_MM)));
+        r.divide(PITCH_RESOLUTION_PER_MM);
+    }
+
+    // Steps per mm of carriage travel: driver pulses / (motor:leadscrew pulley ratio x leadscrew pitch).
+    uint32_t driver_pulses = RuntimeConfig::Z_Axis::driver_pulses_per_rev;
+    r.multiply(driver_pulses > 0 ? driver_pulses : 1);
+
+    uint16_t motor_teeth = RuntimeConfig::Z_Axis::motor_pulley_teeth;
+    uint16_t leadscrew_teeth = RuntimeConfig::Z_Axis::lead_screw_pulley_teeth;
+    if (motor_teeth > 0 && leadscrew_teeth > 0)
+    {
+        r.multiply(leadscrew_teeth);
+        r.divide(motor_teeth);
+    }
+
+    float ls_pitch_val = RuntimeConfig::Z_Axis::lead_screw_pitch;
+    if (RuntimeConfig::Z_Axis::leadscrew_standard_is_metric)
+    {
+        long ls_pitch_scaled = lroundf(ls_pitch_val * PITCH_RESOLUTION_PER_MM);
+        if (ls_pitch_scaled > 0)
+        {
+            r.multiply(PITCH_RESOLUTION_PER_MM);
+            r.divide(static_cast<uint64_t>(ls_pitch_scaled));
+        }
+    }
+    else
+    {
+        // Imperial leadscrews are specified in TPI: mm per rev = 25.4 / TPI.
+        long ls_tpi_scaled = lroundf(ls_pitch_val * TPI_RESOLUTION);
+        if (ls_tpi_scaled > 0)
+        {
+            r.multiply(static_cast<uint64_t>(ls_tpi_scaled));
+            r.divide(254UL * TPI_RESOLUTION / 10UL);
+        }
+    }
+
+    // Encoder counts per spindle revolution: PPR x quadrature x chuck/encoder pulley ratio.
+    uint16_t ppr = RuntimeConfig::Encoder::ppr;
+    r.divide(static_cast<uint64_t>(ppr > 0 ? ppr : 1) * Limits::Encoder::QUADRATURE_MULT);
+
+    uint16_t chuck_teeth = RuntimeConfig::Spindle::chuck_pulley_teeth;
+    uint16_t encoder_teeth = RuntimeConfig::Spindle::encoder_pulley_teeth;
+    if (chuck_teeth > 0 && encoder_teeth > 0)
+    {
+        r.multiply(encoder_teeth);
+        r.divide(chuck_teeth);
+    }
+
+    GearRatio ratio = fromFraction(r.num, r.den);
+    ratio.exact = ratio.exact && r.exact;
+    return ratio;
+}
+
+GearRatio GearRatio::scaled(uint32_t mul, uint32_t div) const
+{
+    RationalProduct r;
+    r.multiply(numerator);
+    r.multiply(mul);
+    r.divide(denominator ? denominator : 1);
+    r.divide(div ? div : 1);
+
+    GearRatio result = fromFraction(r.num, r.den);
+    result.exact = result.exact && r.exact && exact;
+    return result;
+}
+
+GearRatio::Reach GearRatio::reach(int32_t steps, int32_t phase) const
+{
+    Reach result = {0, 0, 0};
+    if (numerator == 0 || denominator == 0)
+    {
+        return result; // No gearing: nothing is ever demanded
+    }
+    int64_t num = numerator;
+    int64_t den = denominator;
+    // In units of 1/den step: how far the relation still has to go from the point.
+    int64_t behind = static_cast<int64_t>(steps) * den - phase;
+    // First count at which it has got there (ceil division)...
+    result.counts = behind / num;
+    if (result.counts * num < behind)
+    {
+        result.counts++;
+    }
+    // ...and how far it is past it there: a fraction of a count's worth of steps.
+    int64_t excess = result.counts * num - behind;
+    result.phase = static_cast<int32_t>(excess % den);
+    result.catchUpSteps = static_cast<int32_t>(excess / den);
+    return result;
+}
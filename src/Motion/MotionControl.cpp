@@ -4,32 +4,63 @@
 #include <STM32Step.h>
 #include "Hardware/EncoderTimer.h"
 #include "Motion/SyncTimer.h"
+#include "Motion/GearRatio.h"
 #include <cmath>
 
 MotionControl::MotionControl() : _stepper(nullptr),
                                  _currentMode(Mode::IDLE),
+                                 _feedOverrideTarget(100),
+                                 _feedOverrideApplied(100),
+                                 _lastFeedOverrideSlewMs(0),
+                                 _threadLock(),
+                                 _softEngaging(false),
                                  _running(false),
                                  _jogActive(false),
+                                 _jogStopping(false),
+                                 _pendingJogDirection(JogDirection::JOG_NONE),
+                                 _pendingJogSpeed(0.0f),
+                                 _positioningActive(false),
+                                 _positioningTargetSteps(0),
+                                 _positioningResumesSync(true),
+                                 _feedPerMinute(SystemConfig::Limits::Motion::DEFAULT_FEED_PER_MINUTE_MM),
+                                 _feedStopping(false),
+                                 _feedRestartPending(false),
                                  _error(false),
                                  _errorMsg(nullptr),
                                  _currentFeedDirection(FeedDirection::UNKNOWN),
                                  _targetStopFeatureEnabledForMotion(false),
                                  _absoluteTargetStopStepsForMotion(0),
-                                 _targetStopReached(false)
+                                 _targetStopReached(false),
+                                 _lastStopOvershootSteps(0)
 {
 }
 
 MotionControl::MotionControl(const MotionPins &pins) : _pins(pins),
                                                        _stepper(nullptr),
                                                        _currentMode(Mode::IDLE),
+                                                       _feedOverrideTarget(100),
+                                                       _feedOverrideApplied(100),
+                                                       _lastFeedOverrideSlewMs(0),
+                                                       _threadLock(),
+                                                       _softEngaging(false),
                                                        _running(false),
                                                        _jogActive(false),
+                                                       _jogStopping(false),
+                                                       _pendingJogDirection(JogDirection::JOG_NONE),
+                                                       _pendingJogSpeed(0.0f),
+                                                       _positioningActive(false),
+                                                       _positioningTargetSteps(0),
+                                                       _positioningResumesSync(true),
+                                                       _feedPerMinute(SystemConfig::Limits::Motion::DEFAULT_FEED_PER_MINUTE_MM),
+                                                       _feedStopping(false),
+                                                       _feedRestartPending(false),
                                                        _error(false),
                                                        _errorMsg(nullptr),
                                                        _currentFeedDirection(FeedDirection::UNKNOWN),
                                                        _targetStopFeatureEnabledForMotion(false),
                                                        _absoluteTargetStopStepsForMotion(0),
-                                                       _targetStopReached(false)
+                                                       _targetStopReached(false),
+                                                       _lastStopOvershootSteps(0)
 {
 }
 
@@ -70,11 +101,7 @@ bool MotionControl::begin(EncoderTimer *encoder)
 void MotionControl::end()
 {
     stopMotion();
-    if (_jogActive && _stepper)
-    {
-        _stepper->stop();
-        _jogActive = false;
-    }
+    haltManualMove();
     if (_stepper)
     {
         _stepper->disable();
@@ -98,6 +125,10 @@ void MotionControl::setMode(Mode mode)
     }
 
     stopMotion();
+    if (_feedStopping && mode != Mode::FEEDING)
+    {
+        haltManualMove(); // The sync must not start under a feed that is still running down
+    }
     _currentMode = mode;
     configureForMode(mode);
 }
@@ -105,6 +136,29 @@ void MotionControl::setMode(Mode mode)
 void MotionControl::setConfig(const Config &config)
 {
     bool was_running = _running;
+    // A pitch profile is rebuilt in place, so it is never swapped under a running ISR.
+    if (was_running && config.microsteps == _config.microsteps && !config.pitch_table && !_config.pitch_table)
+    {
+        // Feed/pitch change mid-cut: SyncTimer picks the new ratio up at its next period,
+        // keeping the encoder origin and step phase, so no position is lost.
+        _config = config;
+        if (_currentMode == Mode::FEEDING)
+        {
+            // Only the sign matters to a timed feed; turning round runs down and starts again
+            FeedDirection before = _currentFeedDirection;
+            updateFeedDirection();
+            if (_currentFeedDirection != before)
+            {
+                stopMotion();
+                startMotion();
+            }
+            return;
+        }
+        calculateAndSetSyncTimerConfig();
+        updateFeedDirection();
+        return;
+    }
+
     if (was_running)
     {
         stopMotion();
@@ -119,12 +173,131 @@ void MotionControl::setConfig(const Config &config)
     }
 }
 
+void MotionControl::setFeedOverride(uint16_t percent)
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+    if (percent < MotionLimits::FEED_OVERRIDE_MIN_PERCENT)
+        percent = MotionLimits::FEED_OVERRIDE_MIN_PERCENT;
+    if (percent > MotionLimits::FEED_OVERRIDE_MAX_PERCENT)
+        percent = MotionLimits::FEED_OVERRIDE_MAX_PERCENT;
+    _feedOverrideTarget = percent;
+
+    if (!_running)
+    {
+        // Nothing to slew; the next startMotion() picks it up.
+        _feedOverrideApplied = percent;
+    }
+}
+
+void MotionControl::slewFeedOverride()
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+    if (!_running || _currentMode == Mode::THREADING)
+    {
+        // Nothing to hand over: the override only scales turning feeds.
+        _feedOverrideApplied = _feedOverrideTarget;
+        return;
+    }
+    if (millis() - _lastFeedOverrideSlewMs < MotionLimits::FEED_OVERRIDE_SLEW_INTERVAL_MS)
+    {
+        return;
+    }
+    _lastFeedOverrideSlewMs = millis();
+
+    uint16_t step = MotionLimits::FEED_OVERRIDE_SLEW_PERCENT;
+    if (_feedOverrideApplied < _feedOverrideTarget)
+        _feedOverrideApplied = (_feedOverrideTarget - _feedOverrideApplied > step) ? _feedOverrideApplied + step : _feedOverrideTarget;
+    else
+        _feedOverrideApplied = (_feedOverrideApplied - _feedOverrideTarget > step) ? _feedOverrideApplied - step : _feedOverrideTarget;
+
+    if (_currentMode == Mode::FEEDING)
+    {
+        _stepper->setProfileSpeed(feedPerMinuteStepHz(zStepsPerMm())); // The planner ramps to it
+        return;
+    }
+    // Live hand-off: takes effect within one sync period, no stop/restart.
+    calculateAndSetSyncTimerConfig();
+}
+
+void MotionControl::setFeedPerMinute(float speed_mm_per_min)
+{
+    float maxSpeed = SystemConfig::RuntimeConfig::Z_Axis::max_feed_rate;
+    if (speed_mm_per_min < 0.0f)
+        speed_mm_per_min = 0.0f;
+    if (speed_mm_per_min > maxSpeed)
+        speed_mm_per_min = maxSpeed;
+    _feedPerMinute = speed_mm_per_min;
+
+    if (_running && _currentMode == Mode::FEEDING && _stepper)
+    {
+        // The profile ramps to the new rate; the move carries on
+        _stepper->setProfileSpeed(feedPerMinuteStepHz(zStepsPerMm()));
+    }
+}
+
+float MotionControl::feedPerMinuteStepHz(float stepsPerMm) const
+{
+    return _feedPerMinute * static_cast<float>(_feedOverrideApplied) / 100.0f / 60.0f * stepsPerMm;
+}
+
+void MotionControl::startTimedFeed()
+{
+    if (_jogActive || _jogStopping || _positioningActive)
+    {
+        haltManualMove();
+    }
+    if (_running || _error)
+    {
+        return;
+    }
+    if (_feedStopping)
+    {
+        _feedRestartPending = true; // update() starts it once the previous run-down has finished
+        return;
+    }
+    if (!_stepper)
+    {
+        handleError("Cannot start feed: Stepper not initialized.");
+        return;
+    }
+
+    float stepsPerMm = zStepsPerMm();
+    float speedHz = feedPerMinuteStepHz(stepsPerMm);
+    if (stepsPerMm <= 0.0f || speedHz <= 0.0f)
+    {
+        return;
+    }
+
+    _syncTimer.enable(false);
+    _stepper->enable();
+    _stepper->updatePositionFromHardware();
+    updateFeedDirection();
+    bool increase = (_currentFeedDirection == FeedDirection::AWAY_FROM_CHUCK);
+
+    applyZProfile(stepsPerMm);
+    // An auto-stop ahead makes it a bounded move that decelerates onto the target exactly
+    int32_t toGo = _absoluteTargetStopStepsForMotion - _stepper->getCurrentPosition();
+    bool stopAhead = _targetStopFeatureEnabledForMotion && toGo != 0 && ((toGo > 0) == increase);
+    bool started = stopAhead ? _stepper->moveProfiled(toGo, speedHz) : _stepper->jogProfiled(increase, speedHz);
+    if (!started)
+    {
+        SerialDebug.println("MotionControl: timed feed could not start, stepper busy.");
+        return;
+    }
+
+    _running = true;
+    _error = false;
+}
+
 void MotionControl::startMotion()
 {
-    if (_jogActive && _stepper)
+    if (_currentMode == Mode::FEEDING)
     {
-        endContinuousJog();
+        startTimedFeed(); // Spindle-independent: the planner runs the feed, not the SyncTimer
+        return;
     }
+
+    haltManualMove();
     if (_running || _error)
     {
         return;
@@ -136,12 +309,236 @@ void MotionControl::startMotion()
         return;
     }
 
+    _softEngaging = SystemConfig::RuntimeConfig::Motion::soft_engage;
     calculateAndSetSyncTimerConfig();
+    if (_softEngaging)
+    {
+        float acceleration = SystemConfig::RuntimeConfig::Z_Axis::acceleration * zStepsPerMm();
+        _syncTimer.requestEngageRamp(acceleration, _encoder->getCountsPerSecond());
+    }
 
     _encoder->reset();
     _stepper->enable();
     _syncTimer.enable(true);
 
+    updateFeedDirection();
+
+    _running = true;
+    _error = false;
+}
+
+bool MotionControl::startMotionAtIndex(uint32_t indexPhaseCounts)
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+
+    haltManualMove();
+    if (_running || _error)
+    {
+        return false;
+    }
+
+    if (!_stepper || !_encoder->isValid() || !_syncTimer.isInitialized())
+    {
+        handleError("Cannot start motion: Components not initialized.");
+        return false;
+    }
+
+    uint32_t indexCount;
+    uint32_t encoderCountsPerRev = _encoder->getCountsPerRevolution();
+    if (!_encoder->getIndexCount(indexCount) || encoderCountsPerRev == 0)
+    {
+        return false; // No index seen yet; the caller decides whether to start unlocked
+    }
+    // The index marks one spindle angle only if an encoder revolution is whole spindle revolutions;
+    // an encoder geared up to the spindle sees its index at several spindle angles.
+    uint32_t countsPerRev;
+    if (!getCountsPerSpindleRevolution(countsPerRev) || countsPerRev == 0 || encoderCountsPerRev % countsPerRev != 0)
+    {
+        SerialDebug.println("MotionControl: index engage needs whole spindle revolutions per encoder revolution.");
+        return false;
+    }
+
+    calculateAndSetSyncTimerConfig();
+
+    _encoder->reset();
+    _stepper->enable();
+
+    // First count at the requested phase that lies ahead in the spindle's counting direction.
+    bool countingDown = _encoder->isCountingDown();
+    uint32_t phase = indexPhaseCounts % countsPerRev;
+    uint32_t target = countingDown ? indexCount - phase : indexCount + phase;
+    int32_t lead = static_cast<int32_t>(target - _encoder->getRawCounter());
+    if (countingDown)
+    {
+        lead = -lead;
+    }
+    if (lead < static_cast<int32_t>(MotionLimits::INDEX_ENGAGE_MIN_LEAD_COUNTS))
+    {
+        uint32_t revs = static_cast<uint32_t>(static_cast<int32_t>(MotionLimits::INDEX_ENGAGE_MIN_LEAD_COUNTS) - lead + countsPerRev - 1) / countsPerRev;
+        target = countingDown ? target - revs * countsPerRev : target + revs * countsPerRev;
+    }
+
+    if (!armEngage(target, countsPerRev, countingDown))
+    {
+        // Not a fault: the caller falls back to an unlocked start, which handleError() would block.
+        SerialDebug.println("MotionControl: index engage overran, not armed.");
+        return false;
+    }
+
+    updateFeedDirection();
+
+    _running = true;
+    _error = false;
+    return true;
+}
+
+bool MotionControl::startMotionLocked()
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+
+    haltManualMove();
+    if (_running || _error || !_threadLock.valid)
+    {
+        return false;
+    }
+
+    if (!_stepper || !_encoder->isValid() || !_syncTimer.isInitialized())
+    {
+        handleError("Cannot start motion: Components not initialized.");
+        return false;
+    }
+
+    calculateAndSetSyncTimerConfig(true);
+    const SyncTimer::SyncConfig &sync = _syncTimer.getConfig();
+    if (sync.ratio_numerator == 0 || sync.pitch_segment_count > 0 ||
+        sync.ratio_numerator != _threadLock.numerator || sync.ratio_denominator != _threadLock.denominator ||
+        sync.reverse_direction != _threadLock.reverse)
+    {
+        _threadLock.valid = false; // A different thread; it starts over
+        return false;
+    }
+
+    // Where along the locked relation is the carriage now?
+    _stepper->updatePositionFromHardware();
+    GearRatio ratio; // As the sync path runs it; the lock's phase is in these units
+    ratio.numerator = sync.ratio_numerator;
+    ratio.denominator = sync.ratio_denominator;
+    GearRatio::Reach reach = ratio.reach(_stepper->getCurrentPosition() - _threadLock.position, _threadLock.phase);
+    int64_t countOffset = reach.counts;
+    int32_t phase = reach.phase;
+    int32_t catchUpSteps = reach.catchUpSteps;
+
+    // That count recurs every whole spindle revolution; take the first one far enough ahead.
+    uint32_t period = spindlePeriodCounts();
+    bool countingDown = _encoder->isCountingDown();
+    int64_t direction = countingDown ? -1 : 1;
+    int64_t relationSign = sync.reverse_direction ? -1 : 1;
+    int64_t now = _encoder->getAbsolutePosition();
+    int64_t lead = direction * (_threadLock.count - now + relationSign * countOffset);
+    int64_t minLead = MotionLimits::INDEX_ENGAGE_MIN_LEAD_COUNTS;
+    int64_t span = period;
+    lead = ((lead - minLead) % span + span) % span + minLead;
+    uint32_t target = static_cast<uint32_t>(now + direction * lead); // Compares run on the low word
+
+    _stepper->enable();
+    if (!armEngage(target, period, countingDown, phase, catchUpSteps))
+    {
+        SerialDebug.println("MotionControl: thread lock overran, not armed.");
+        return false;
+    }
+
+    updateFeedDirection();
+
+    _running = true;
+    _error = false;
+    return true;
+}
+
+bool MotionControl::armEngage(uint32_t target, uint32_t period, bool countingDown, int32_t phase, int32_t catchUpSteps)
+{
+    // Armed from the main loop, so the spindle may still overtake it; then take the next period.
+    for (int attempt = 0; attempt < 3; ++attempt)
+    {
+        if (_syncTimer.engageAt(target, phase, catchUpSteps))
+        {
+            return true;
+        }
+        target = countingDown ? target - period : target + period;
+    }
+    return false;
+}
+
+void MotionControl::captureThreadLock()
+{
+    SyncTimer::SyncState state;
+    if (_currentMode != Mode::THREADING || !_syncTimer.getSyncState(state))
+    {
+        return; // Not threading, or a lock re-engagement still pending: the old lock stands
+    }
+    const SyncTimer::SyncConfig &sync = _syncTimer.getConfig();
+    // The sync path works on the 32-bit counter; place its count on the absolute position.
+    int64_t now = _encoder->getAbsolutePosition();
+    _threadLock.count = now - static_cast<int32_t>(static_cast<uint32_t>(now) - state.count);
+    _threadLock.position = state.position;
+    _threadLock.phase = state.phase;
+    _threadLock.numerator = sync.ratio_numerator;
+    _threadLock.denominator = sync.ratio_denominator;
+    _threadLock.reverse = sync.reverse_direction;
+    _threadLock.valid = true;
+}
+
+uint32_t MotionControl::spindlePeriodCounts() const
+{
+    uint32_t counts;
+    if (getCountsPerSpindleRevolution(counts))
+    {
+        return counts > 0 ? counts : 1;
+    }
+    // encoder_teeth / gcd spindle revolutions make a whole number of counts.
+    uint32_t chuck_teeth = SystemConfig::RuntimeConfig::Spindle::chuck_pulley_teeth;
+    uint32_t encoder_teeth = SystemConfig::RuntimeConfig::Spindle::encoder_pulley_teeth;
+    uint32_t a = chuck_teeth, b = encoder_teeth;
+    while (b != 0)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return static_cast<uint32_t>(SystemConfig::RuntimeConfig::Encoder::ppr) * SystemConfig::Limits::Encoder::QUADRATURE_MULT * (chuck_teeth / a);
+}
+
+bool MotionControl::shiftSpindlePhase(uint32_t counts)
+{
+    if (!_running && _threadLock.valid)
+    {
+        _threadLock.count += counts;
+        return true;
+    }
+    if (!_running || !_encoder)
+    {
+        return false;
+    }
+    int32_t rawCounts = static_cast<int32_t>(counts);
+    return _syncTimer.shiftPhaseOrigin(_encoder->isCountingDown() ? -rawCounts : rawCounts);
+}
+
+bool MotionControl::getCountsPerSpindleRevolution(uint32_t &counts) const
+{
+    uint32_t encoderCounts = static_cast<uint32_t>(SystemConfig::RuntimeConfig::Encoder::ppr) * SystemConfig::Limits::Encoder::QUADRATURE_MULT;
+    uint16_t chuck_teeth = SystemConfig::RuntimeConfig::Spindle::chuck_pulley_teeth;
+    uint16_t encoder_teeth = SystemConfig::RuntimeConfig::Spindle::encoder_pulley_teeth;
+    if (chuck_teeth == 0 || encoder_teeth == 0)
+    {
+        counts = encoderCounts;
+        return true;
+    }
+    uint64_t scaled = static_cast<uint64_t>(encoderCounts) * chuck_teeth;
+    counts = static_cast<uint32_t>(scaled / encoder_teeth);
+    return scaled % encoder_teeth == 0;
+}
+
+void MotionControl::updateFeedDirection()
+{
     bool steps_will_increase = (_config.thread_pitch >= 0.0f) ^ _config.reverse_direction;
     if (steps_will_increase)
     {
@@ -151,9 +548,6 @@ void MotionControl::startMotion()
     {
         _currentFeedDirection = FeedDirection::TOWARDS_CHUCK;
     }
-
-    _running = true;
-    _error = false;
 }
 
 void MotionControl::stopMotion()
@@ -163,6 +557,20 @@ void MotionControl::stopMotion()
         return;
     }
 
+    if (_currentMode == Mode::FEEDING)
+    {
+        // A timed feed runs down along its profile; update() releases TIM1 once it has stopped
+        if (_stepper)
+        {
+            _stepper->decelerateToStop();
+        }
+        _feedStopping = true;
+        _running = false;
+        return;
+    }
+
+    captureThreadLock();
+    _softEngaging = false;
     _syncTimer.enable(false);
     if (_stepper)
     {
@@ -173,16 +581,23 @@ void MotionControl::stopMotion()
 
 void MotionControl::emergencyStop()
 {
-    if (_jogActive && _stepper)
+    if ((_jogActive || _jogStopping) && _stepper)
     {
         _stepper->emergencyStop();
-        _jogActive = false;
     }
+    _jogActive = false;
+    _jogStopping = false;
+    _pendingJogDirection = JogDirection::JOG_NONE;
+    _positioningActive = false;
+    _feedStopping = false;
+    _feedRestartPending = false;
     _syncTimer.enable(false);
     if (_stepper)
     {
         _stepper->emergencyStop();
     }
+    _threadLock.valid = false; // Steps may have been lost
+    _softEngaging = false;
     _running = false;
     handleError("Emergency stop triggered");
 }
@@ -194,6 +609,17 @@ MotionControl::Status MotionControl::getStatus() const
     status.encoder_position = encPos.count;
 
     float encoderRpm = static_cast<float>(encPos.rpm);
+    // While a software sync path runs, its observer is the smoother and more current velocity source.
+    SyncTimer::ObserverState observer = _syncTimer.getObserverState();
+    uint16_t ppr = SystemConfig::RuntimeConfig::Encoder::ppr;
+    if (observer.valid && ppr > 0)
+    {
+        encoderRpm = observer.velocity * 60.0f / (static_cast<float>(ppr) * SystemConfig::Limits::Encoder::QUADRATURE_MULT);
+        if (SystemConfig::RuntimeConfig::Encoder::invert_direction)
+        {
+            encoderRpm = -encoderRpm;
+        }
+    }
     float chuckPulleyTeeth = static_cast<float>(SystemConfig::RuntimeConfig::Spindle::chuck_pulley_teeth);
     float encoderPulleyTeeth = static_cast<float>(SystemConfig::RuntimeConfig::Spindle::encoder_pulley_teeth);
     float actualSpindleRpm = 0.0f;
@@ -243,11 +669,7 @@ void MotionControl::handleError(const char *msg)
 {
     _error = true;
     _errorMsg = msg;
-    if (_jogActive && _stepper)
-    {
-        _stepper->stop();
-        _jogActive = false;
-    }
+    haltManualMove();
     stopMotion();
 }
 
@@ -265,97 +687,282 @@ void MotionControl::update()
     // Debug: Uncomment to monitor sync stats
     // _syncTimer.printDebugInfo();
 
-    // Auto-stop logic needs rework due to stepper position not being live-updated by ISR.
-    // This will be addressed in a separate task.
-    /*
-    if (_running && _targetStopFeatureEnabledForMotion && !_targetStopReached)
+    if (_feedOverrideApplied != _feedOverrideTarget)
     {
-        if (!_stepper)
-            return;
-        int32_t currentAbsoluteSteps = _stepper->getCurrentPosition();
+        slewFeedOverride();
+    }
 
-        bool movingTowardsIncreasingSteps = (_currentFeedDirection == FeedDirection::AWAY_FROM_CHUCK);
+    if (_jogStopping && _stepper && !_stepper->updateProfile())
+    {
+        // The jog has run down and TIM1 is free again
+        _jogStopping = false;
+        JogDirection pending = _pendingJogDirection;
+        _pendingJogDirection = JogDirection::JOG_NONE;
+        if (pending != JogDirection::JOG_NONE)
+        {
+            _jogActive = false;
+            beginContinuousJog(pending, _pendingJogSpeed);
+        }
+        else if (!_jogActive &&
+                 (_currentMode == Mode::TURNING || _currentMode == Mode::THREADING || _currentMode == Mode::FEEDING))
+        {
+            startMotion();
+        }
+    }
 
-        if (movingTowardsIncreasingSteps)
+    if (_feedStopping && _stepper && !_stepper->updateProfile())
+    {
+        _feedStopping = false;
+        if (_feedRestartPending)
         {
-            if (currentAbsoluteSteps >= _absoluteTargetStopStepsForMotion)
-            {
-                requestImmediateStop(StopType::CONTROLLED_DECELERATION);
-                _targetStopReached = true;
-                _targetStopFeatureEnabledForMotion = false;
-            }
+            _feedRestartPending = false;
+            startMotion();
         }
-        else
+    }
+
+    if (_running && _currentMode == Mode::FEEDING && _stepper && !_stepper->updateProfile())
+    {
+        // The timed feed ended by itself: it was bounded by the auto-stop target (or ramped to 0)
+        _running = false;
+        if (_targetStopFeatureEnabledForMotion)
         {
-            if (currentAbsoluteSteps <= _absoluteTargetStopStepsForMotion)
-            {
-                requestImmediateStop(StopType::CONTROLLED_DECELERATION);
-                _targetStopReached = true;
-                _targetStopFeatureEnabledForMotion = false;
-            }
+            _lastStopOvershootSteps = _stepper->getCurrentPosition() - _absoluteTargetStopStepsForMotion;
+            SerialDebug.print("MotionControl: timed feed stopped at target, error ");
+            SerialDebug.print(_lastStopOvershootSteps);
+            SerialDebug.println(" steps.");
+            _targetStopFeatureEnabledForMotion = false;
+            _syncTimer.disarmStop();
+            _targetStopReached = true;
         }
     }
-    */
-}
 
-void MotionControl::calculateAndSetSyncTimerConfig()
-{
-    if (!_stepper || !_syncTimer.isInitialized())
+    if (_positioningActive && _stepper && !_stepper->updateProfile())
     {
+        _positioningActive = false;
+        int32_t missed = _positioningTargetSteps - _stepper->getCurrentPosition();
+        if (missed != 0)
+        {
+            SerialDebug.print("MotionControl: positioning move ended ");
+            SerialDebug.print(missed);
+            SerialDebug.println(" steps short of its target.");
+        }
+        if (_positioningResumesSync &&
+            (_currentMode == Mode::TURNING || _currentMode == Mode::THREADING || _currentMode == Mode::FEEDING))
+        {
+            startMotion();
+        }
+    }
+
+    if (_running && _syncTimer.hasFollowingErrorTrip())
+    {
+        // Steps were queued or lost: the stepper no longer knows where the thread is.
+        _threadLock.valid = false;
+        SerialDebug.println("MotionControl: following error limit exceeded, stopping feed.");
+        if (SystemConfig::RuntimeConfig::Motion::following_error_fault)
+        {
+            emergencyStop();
+        }
+        else
+        {
+            requestImmediateStop(StopType::CONTROLLED_DECELERATION);
+            _softEngaging = false;
+        }
         return;
     }
-    double target_feed_mm_spindle_rev = std::abs(static_cast<double>(_config.thread_pitch));
-    double enc_ppr = static_cast<double>(SystemConfig::RuntimeConfig::Encoder::ppr);
-    double quad_mult = static_cast<double>(SystemConfig::Limits::Encoder::QUADRATURE_MULT);
-    double spindle_pulley_teeth = static_cast<double>(SystemConfig::RuntimeConfig::Spindle::chuck_pulley_teeth);
-    double encoder_pulley_teeth = static_cast<double>(SystemConfig::RuntimeConfig::Spindle::encoder_pulley_teeth);
 
-    double enc_counts_per_spindle_rev = 1.0;
-    if (spindle_pulley_teeth > 0.000001 && encoder_pulley_teeth > 0.000001 && enc_ppr > 0.000001)
+    if (_softEngaging && _running && !_syncTimer.isEngageRampActive())
     {
-        enc_counts_per_spindle_rev = (enc_ppr * quad_mult) * (encoder_pulley_teeth / spindle_pulley_teeth);
+        // Locked to the spindle. Only the edge-triggered path can take over a running gearing (the
+        // hardware paths start from a fresh engagement only); it restarts from the count the ticked
+        // path has geared up to, so no counts are lost. Anything else keeps running as it is.
+        _softEngaging = false;
+        if (SystemConfig::RuntimeConfig::Motion::edge_triggered_sync && !_targetStopFeatureEnabledForMotion)
+        {
+            calculateAndSetSyncTimerConfig();
+        }
     }
-    else if (enc_ppr > 0.000001)
+
+    if (_running && _currentMode != Mode::FEEDING && _targetStopFeatureEnabledForMotion && _syncTimer.isStopSettled())
     {
-        enc_counts_per_spindle_rev = enc_ppr * quad_mult;
+        // The SyncTimer braked onto the target in its ISR; all that is left is to report and release.
+        int32_t overshoot = _syncTimer.getStopOvershoot();
+        _lastStopOvershootSteps = overshoot;
+        SerialDebug.print("MotionControl: auto-stop settled, overshoot ");
+        SerialDebug.print(overshoot);
+        SerialDebug.println(" steps.");
+        _targetStopFeatureEnabledForMotion = false;
+        _syncTimer.disarmStop();
+        stopMotion();
+        _targetStopReached = true;
     }
-    if (std::abs(enc_counts_per_spindle_rev) < 0.000001)
-        enc_counts_per_spindle_rev = 1.0;
-    double s_motor_total_usteps = static_cast<double>(SystemConfig::RuntimeConfig::Z_Axis::driver_pulses_per_rev);
-    if (std::abs(s_motor_total_usteps) < 0.000001)
-        s_motor_total_usteps = 1.0;
-    double motor_pulley_z_teeth = static_cast<double>(SystemConfig::RuntimeConfig::Z_Axis::motor_pulley_teeth);
-    double leadscrew_pulley_z_teeth = static_cast<double>(SystemConfig::RuntimeConfig::Z_Axis::lead_screw_pulley_teeth);
-    double G_ls_rev_per_motor_rev = 1.0;
-    if (leadscrew_pulley_z_teeth > 0.000001 && motor_pulley_z_teeth > 0.000001)
+}
+
+void MotionControl::calculateAndSetSyncTimerConfig(bool softwareOnly)
+{
+    if (!_stepper || !_syncTimer.isInitialized())
     {
-        G_ls_rev_per_motor_rev = motor_pulley_z_teeth / leadscrew_pulley_z_teeth;
+        return;
     }
-    if (std::abs(G_ls_rev_per_motor_rev) < 0.000001 && (leadscrew_pulley_z_teeth > 0.000001 || motor_pulley_z_teeth > 0.000001))
+    applyZBacklash(zStepsPerMm()); // Spindle reversals take the slack up too
+    GearRatio ratio = GearRatio::forFeed(_config.thread_pitch, _config.thread_tpi);
+    bool overriding = _currentMode != Mode::THREADING &&
+                      (_feedOverrideApplied != 100 || _feedOverrideTarget != _feedOverrideApplied);
+    if (overriding)
     {
-        G_ls_rev_per_motor_rev = 1.0;
+        ratio = ratio.scaled(_feedOverrideApplied, 100);
     }
-    double ls_pitch_val = static_cast<double>(SystemConfig::RuntimeConfig::Z_Axis::lead_screw_pitch);
-    bool ls_is_metric = SystemConfig::RuntimeConfig::Z_Axis::leadscrew_standard_is_metric;
-    double ls_pitch_mm_per_ls_rev = ls_is_metric ? ls_pitch_val : ls_pitch_val * 25.4;
-    if (std::abs(ls_pitch_mm_per_ls_rev) < 0.000001)
-        ls_pitch_mm_per_ls_rev = 1.0;
-    double mm_travel_per_motor_rev = G_ls_rev_per_motor_rev * ls_pitch_mm_per_ls_rev;
-    if (std::abs(mm_travel_per_motor_rev) < 0.000001)
-        mm_travel_per_motor_rev = 1.0;
-    double usteps_per_mm_travel = s_motor_total_usteps / mm_travel_per_motor_rev;
-    double calculated_steps_per_encoder_tick = (target_feed_mm_spindle_rev / enc_counts_per_spindle_rev) * usteps_per_mm_travel;
 
     SyncTimer::SyncConfig newSyncTimerConfig;
-    newSyncTimerConfig.scaling_factor = 1000000;
-    newSyncTimerConfig.steps_per_encoder_tick_scaled = static_cast<uint32_t>(calculated_steps_per_encoder_tick * newSyncTimerConfig.scaling_factor);
+    newSyncTimerConfig.ratio_numerator = ratio.numerator;
+    newSyncTimerConfig.ratio_denominator = ratio.denominator;
     newSyncTimerConfig.update_freq = _config.sync_frequency;
+    // An engagement ramp and a precise stop only run in the ticked paths.
+    bool tickedOnly = _softEngaging || _targetStopFeatureEnabledForMotion;
+    // An overridden feed is re-geared on every slew step, which only the software paths take live.
+    softwareOnly = softwareOnly || tickedOnly || overriding;
+    newSyncTimerConfig.mode = SystemConfig::RuntimeConfig::Motion::edge_triggered_sync && !tickedOnly ? SyncTimer::Mode::EDGE_TRIGGERED
+                              : SystemConfig::RuntimeConfig::Motion::nco_sync           ? SyncTimer::Mode::NCO
+                                                                                        : SyncTimer::Mode::PERIODIC;
+    // Variable pitch changes the ratio with every step, so only the software paths apply.
+    bool variablePitch = _config.pitch_table && buildPitchProfile(newSyncTimerConfig);
+    if (!variablePitch && !softwareOnly && !planHardwareGearing(ratio, newSyncTimerConfig))
+    {
+        planCompareDma(ratio, newSyncTimerConfig);
+    }
     // Combine pitch sign and config reversal to determine final direction
     // pitch < 0 means "towards chuck" (reverse), unless reversed by config.
     newSyncTimerConfig.reverse_direction = (_config.thread_pitch < 0.0f) ^ _config.reverse_direction;
+    _syncTimer.setFollowingErrorLimit(static_cast<int32_t>(lroundf(SystemConfig::RuntimeConfig::Motion::following_error_limit_mm * zStepsPerMm())));
     _syncTimer.setConfig(newSyncTimerConfig);
 }
 
+bool MotionControl::buildPitchProfile(SyncTimer::SyncConfig &syncConfig)
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+    uint8_t count = _config.pitch_table_size;
+    if (count < 2 || count > MotionLimits::MAX_PITCH_PROFILE_POINTS)
+    {
+        return false;
+    }
+    float stepsPerMm = zStepsPerMm();
+    GearRatio perMm = GearRatio::forFeed(1.0f); // Steps per count at 1 mm/rev
+    if (stepsPerMm <= 0.0f || perMm.numerator == 0)
+    {
+        return false;
+    }
+
+    // One denominator for the whole profile so the ISR phase never needs rescaling. Start from the
+    // 1 mm/rev denominator and refine it by decades while it fits, giving ~0.1 um pitch resolution.
+    uint64_t den = perMm.denominator;
+    for (int i = 0; i < 4 && den * 10 <= MotionLimits::PITCH_PROFILE_MAX_DENOMINATOR; ++i)
+    {
+        den *= 10;
+    }
+    double numeratorPerMm = static_cast<double>(perMm.numerator) * static_cast<double>(den) / perMm.denominator;
+
+    const PitchPoint *table = _config.pitch_table;
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        double numerator = table[i].pitch_mm * numeratorPerMm;
+        if (table[i].pitch_mm <= 0.0f || numerator > GearRatio::MAX_TERM)
+        {
+            return false;
+        }
+        uint32_t rounded = static_cast<uint32_t>(llround(numerator));
+        if (i == 0)
+        {
+            syncConfig.ratio_numerator = rounded;
+            continue;
+        }
+        long length = lroundf((table[i].z_mm - table[i - 1].z_mm) * stepsPerMm);
+        if (length <= 0)
+        {
+            return false;
+        }
+        _pitchSegments[i - 1].length_steps = static_cast<uint32_t>(length);
+        _pitchSegments[i - 1].end_numerator = rounded;
+    }
+
+    syncConfig.ratio_denominator = static_cast<uint32_t>(den);
+    syncConfig.pitch_segments = _pitchSegments;
+    syncConfig.pitch_segment_count = count - 1;
+    return true;
+}
+
+bool MotionControl::planHardwareGearing(const GearRatio &ratio, SyncTimer::SyncConfig &syncConfig) const
+{
+    using namespace SystemConfig;
+
+    if (!RuntimeConfig::Motion::hardware_gearing || !ratio.exact || ratio.numerator == 0)
+        return false;
+
+    // TIM2 TRGO pulses once per encoder line, i.e. every QUADRATURE_MULT counts.
+    uint64_t stepsPerLineNum = static_cast<uint64_t>(ratio.numerator) * Limits::Encoder::QUADRATURE_MULT;
+    uint32_t triggersPerStep = 1;
+    uint32_t stepsPerTrigger = 1;
+    if (stepsPerLineNum % ratio.denominator == 0)
+    {
+        stepsPerTrigger = static_cast<uint32_t>(stepsPerLineNum / ratio.denominator);
+    }
+    else if (ratio.denominator % stepsPerLineNum == 0)
+    {
+        triggersPerStep = static_cast<uint32_t>(ratio.denominator / stepsPerLineNum);
+    }
+    else
+    {
+        return false;
+    }
+
+    if (triggersPerStep == 1)
+    {
+        // Each line starts a burst that must be finished before the next line at top spindle speed.
+        if (maxEncoderLinesPerSecond() * stepsPerTrigger > static_cast<float>(Limits::Motion::HARDWARE_GEARING_BURST_HZ))
+            return false;
+    }
+
+    syncConfig.mode = SyncTimer::Mode::HARDWARE_GEARING;
+    syncConfig.chain_triggers_per_step = triggersPerStep;
+    syncConfig.chain_steps_per_trigger = stepsPerTrigger;
+    syncConfig.chain_burst_freq = Limits::Motion::HARDWARE_GEARING_BURST_HZ;
+    return true;
+}
+
+bool MotionControl::planCompareDma(const GearRatio &ratio, SyncTimer::SyncConfig &syncConfig) const
+{
+    using namespace SystemConfig;
+
+    if (!RuntimeConfig::Motion::compare_dma_sync || ratio.numerator == 0)
+        return false;
+    // Each step needs a rising and a falling compare on consecutive counts.
+    if (static_cast<uint64_t>(ratio.numerator) * 2 > ratio.denominator)
+        return false;
+
+    // Every step is one triggered pulse of 1 / HARDWARE_GEARING_BURST_HZ.
+    float maxCountsPerSecond = maxEncoderLinesPerSecond() * Limits::Encoder::QUADRATURE_MULT;
+    if (maxCountsPerSecond * ratio.toFloat() > static_cast<float>(Limits::Motion::HARDWARE_GEARING_BURST_HZ))
+        return false;
+
+    syncConfig.mode = SyncTimer::Mode::COMPARE_DMA;
+    syncConfig.chain_triggers_per_step = 1;
+    syncConfig.chain_steps_per_trigger = 1;
+    syncConfig.chain_burst_freq = Limits::Motion::HARDWARE_GEARING_BURST_HZ;
+    return true;
+}
+
+float MotionControl::maxEncoderLinesPerSecond() const
+{
+    using namespace SystemConfig;
+
+    float encoderMaxRpm = static_cast<float>(RuntimeConfig::Encoder::max_rpm);
+    uint16_t chuckTeeth = RuntimeConfig::Spindle::chuck_pulley_teeth;
+    uint16_t encoderTeeth = RuntimeConfig::Spindle::encoder_pulley_teeth;
+    if (chuckTeeth > 0 && encoderTeeth > 0)
+    {
+        encoderMaxRpm = encoderMaxRpm * chuckTeeth / encoderTeeth;
+    }
+    return static_cast<float>(RuntimeConfig::Encoder::ppr) * encoderMaxRpm / 60.0f;
+}
+
 bool MotionControl::isMotorEnabled() const
 {
     if (_stepper)
@@ -381,11 +988,8 @@ void MotionControl::enableMotor()
 
 void MotionControl::disableMotor()
 {
-    if (_jogActive && _stepper)
-    {
-        endContinuousJog();
-    }
     stopMotion();
+    haltManualMove(); // Also cuts short a timed feed stopMotion() left running down
     if (_stepper)
     {
         _stepper->disable();
@@ -398,9 +1002,14 @@ void MotionControl::beginContinuousJog(JogDirection direction, float speed_mm_pe
         return;
     if (!SystemConfig::RuntimeConfig::System::jog_system_enabled)
         return;
+    if (_positioningActive)
+        return; // The planned move owns the stepper until it has finished
     if (_running)
         stopMotion();
     _syncTimer.enable(false);
+    // A timed feed still running down is the jog's to take over or reverse
+    _feedStopping = false;
+    _feedRestartPending = false;
 
     if (direction == JogDirection::JOG_NONE)
     {
@@ -418,37 +1027,35 @@ void MotionControl::beginContinuousJog(JogDirection direction, float speed_mm_pe
         target_speed_mm_per_min = SystemConfig::RuntimeConfig::Z_Axis::max_jog_speed_mm_per_min;
     }
 
-    float z_motor_total_usteps = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::driver_pulses_per_rev);
-    float z_motor_pulley_teeth = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::motor_pulley_teeth);
-    if (z_motor_pulley_teeth < 1.0f)
-        z_motor_pulley_teeth = 1.0f;
-    float z_leadscrew_pulley_teeth = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::lead_screw_pulley_teeth);
-    if (z_leadscrew_pulley_teeth < 1.0f)
-        z_leadscrew_pulley_teeth = 1.0f;
-
-    float z_ls_pitch_val = SystemConfig::RuntimeConfig::Z_Axis::lead_screw_pitch;
-    bool z_ls_is_metric = SystemConfig::RuntimeConfig::Z_Axis::leadscrew_standard_is_metric;
-    float z_ls_pitch_mm_per_ls_rev = z_ls_is_metric ? z_ls_pitch_val : z_ls_pitch_val * 25.4f;
-    if (fabsf(z_ls_pitch_mm_per_ls_rev) < 0.00001f)
-        z_ls_pitch_mm_per_ls_rev = 1.0f;
-
-    float z_mm_travel_per_motor_rev = (z_motor_pulley_teeth / z_leadscrew_pulley_teeth) * z_ls_pitch_mm_per_ls_rev;
-    if (fabsf(z_mm_travel_per_motor_rev) < 0.00001f)
-        z_mm_travel_per_motor_rev = 1.0f;
-
-    float z_usteps_per_mm_travel = z_motor_total_usteps / z_mm_travel_per_motor_rev;
+    float stepsPerMm = zStepsPerMm(); // Same conversion as the gearing (an imperial screw is in TPI)
+    if (stepsPerMm <= 0.0f)
+        return;
 
     float speed_mm_per_sec = target_speed_mm_per_min / 60.0f;
-    float target_freq_hz = speed_mm_per_sec * z_usteps_per_mm_travel;
-
-    float accel_mm_per_s2 = SystemConfig::RuntimeConfig::Z_Axis::acceleration;
-    float accel_steps_per_s2 = accel_mm_per_s2 * z_usteps_per_mm_travel;
+    float target_freq_hz = speed_mm_per_sec * stepsPerMm;
 
     bool stepper_lib_direction = (direction == JogDirection::JOG_AWAY_FROM_CHUCK);
 
-    _stepper->setAcceleration(accel_steps_per_s2);
+    applyZProfile(stepsPerMm);
     _stepper->setSpeedHz(target_freq_hz);
-    _stepper->runContinuous(stepper_lib_direction);
+    if (_stepper->jogProfiled(stepper_lib_direction, target_freq_hz))
+    {
+        _jogStopping = false;
+        _pendingJogDirection = JogDirection::JOG_NONE;
+    }
+    else if (_stepper->isProfileActive())
+    {
+        // Still moving the other way: run that down first, update() starts this jog after it
+        _stepper->decelerateToStop();
+        _jogStopping = true;
+        _pendingJogDirection = direction;
+        _pendingJogSpeed = speed_mm_per_min;
+    }
+    else
+    {
+        _stepper->stop();
+        _stepper->jogProfiled(stepper_lib_direction, target_freq_hz);
+    }
 
     _jogActive = true;
 }
@@ -460,16 +1067,101 @@ void MotionControl::endContinuousJog()
         return;
     }
 
-    _stepper->stop();
+    _stepper->decelerateToStop();
     _jogActive = false;
+    _jogStopping = true; // update() resumes the ELS modes once the carriage has stopped
+    _pendingJogDirection = JogDirection::JOG_NONE;
+}
 
-    if (_currentMode == Mode::TURNING || _currentMode == Mode::THREADING || _currentMode == Mode::FEEDING)
+void MotionControl::haltManualMove()
+{
+    if ((_jogActive || _jogStopping || _positioningActive || _feedStopping) && _stepper)
     {
-        startMotion();
+        _stepper->stop();
+    }
+    _jogActive = false;
+    _jogStopping = false;
+    _pendingJogDirection = JogDirection::JOG_NONE;
+    _positioningActive = false;
+    _feedStopping = false;
+    _feedRestartPending = false;
+}
+
+void MotionControl::applyZProfile(float stepsPerMm)
+{
+    _stepper->setAcceleration(SystemConfig::RuntimeConfig::Z_Axis::acceleration * stepsPerMm);
+    _stepper->setProfile(SystemConfig::RuntimeConfig::Z_Axis::s_curve_profile ? STM32Step::ProfileShape::S_CURVE
+                                                                             : STM32Step::ProfileShape::TRAPEZOIDAL,
+                         SystemConfig::RuntimeConfig::Z_Axis::jerk * stepsPerMm);
+    applyZBacklash(stepsPerMm);
+}
+
+void MotionControl::applyZBacklash(float stepsPerMm)
+{
+    // Entered in the leadscrew's unit, like the other Z-axis mechanics; 0 turns the take-up off
+    float backlashMm = SystemConfig::RuntimeConfig::Z_Axis::backlash_compensation;
+    if (!SystemConfig::RuntimeConfig::Z_Axis::leadscrew_standard_is_metric)
+    {
+        backlashMm *= 25.4f;
+    }
+    float steps = backlashMm * stepsPerMm;
+    _stepper->setBacklash((steps > 0.0f) ? static_cast<uint32_t>(lroundf(steps)) : 0u);
+}
+
+bool MotionControl::moveToPositionSteps(int32_t absoluteSteps, float speed_mm_per_min, bool resumeSync)
+{
+    if (_error || !_stepper || _jogActive || _jogStopping || _positioningActive || _feedStopping)
+        return false;
+    if (_running && _currentMode == Mode::FEEDING)
+        return false; // Stop the timed feed first; it needs its run-down
+
+    float stepsPerMm = zStepsPerMm();
+    if (stepsPerMm <= 0.0f)
+        return false;
+
+    bool wasRunning = _running;
+    if (_running)
+        stopMotion();
+    _syncTimer.enable(false);
+    _stepper->enable();
+
+    // Exact target against the TIM5-tracked position
+    _stepper->updatePositionFromHardware();
+    _positioningTargetSteps = absoluteSteps;
+    int32_t delta = absoluteSteps - _stepper->getCurrentPosition();
+    if (delta == 0)
+    {
+        if (wasRunning)
+            startMotion();
+        return true;
+    }
+
+    float maxSpeed = SystemConfig::RuntimeConfig::Z_Axis::max_feed_rate;
+    if (speed_mm_per_min <= 0.0f || speed_mm_per_min > maxSpeed)
+        speed_mm_per_min = maxSpeed;
+
+    applyZProfile(stepsPerMm);
+    if (!_stepper->moveProfiled(delta, speed_mm_per_min / 60.0f * stepsPerMm))
+    {
+        SerialDebug.println("MotionControl: positioning move could not start, stepper busy.");
+        if (wasRunning)
+            startMotion();
+        return false;
+    }
+    _positioningResumesSync = resumeSync;
+    _positioningActive = true;
+    return true;
+}
+
+void MotionControl::abortPositioning()
+{
+    if (_positioningActive && _stepper)
+    {
+        _stepper->decelerateToStop();
     }
 }
 
-void MotionControl::configureAbsoluteTargetStop(int32_t absoluteSteps, bool enable)
+void MotionControl::configureAbsoluteTargetStop(int32_t absoluteSteps, bool enable, bool startFeed)
 {
     _absoluteTargetStopStepsForMotion = absoluteSteps;
     _targetStopFeatureEnabledForMotion = enable;
@@ -477,16 +1169,35 @@ void MotionControl::configureAbsoluteTargetStop(int32_t absoluteSteps, bool enab
 
     if (enable)
     {
-        if (isMotorEnabled() && !_running &&
+        float deceleration = SystemConfig::RuntimeConfig::Z_Axis::acceleration * zStepsPerMm();
+        _syncTimer.armStopAt(absoluteSteps, deceleration);
+        if (_running && _currentMode == Mode::FEEDING)
+        {
+            _stepper->endProfileAt(absoluteSteps); // Ignored if the target is not ahead, as in the sync ISR
+        }
+        else if (_running)
+        {
+            SyncTimer::Mode mode = _syncTimer.getActiveMode();
+            if (mode != SyncTimer::Mode::PERIODIC && mode != SyncTimer::Mode::NCO)
+            {
+                calculateAndSetSyncTimerConfig(); // Move onto a path that can brake
+            }
+        }
+        if (startFeed && isMotorEnabled() && !_running &&
             (_currentMode == Mode::TURNING || _currentMode == Mode::THREADING || _currentMode == Mode::FEEDING))
         {
             startMotion();
         }
     }
+    else
+    {
+        _syncTimer.disarmStop();
+    }
 }
 
 void MotionControl::clearAbsoluteTargetStop()
 {
+    _syncTimer.disarmStop();
     _targetStopFeatureEnabledForMotion = false;
     _absoluteTargetStopStepsForMotion = 0;
     _targetStopReached = false;
@@ -511,14 +1222,19 @@ int32_t MotionControl::getCurrentPositionSteps() const
 {
     if (_stepper)
     {
-        return _stepper->getCurrentPosition();
+        return _stepper->getCurrentPosition(); // Take-up pulses are never booked here
     }
     return 0;
 }
 
+uint32_t MotionControl::getBacklashTakeUpSteps() const
+{
+    return _stepper ? _stepper->getTakeUpRemaining() : 0;
+}
+
 void MotionControl::requestImmediateStop(StopType type)
 {
-    if (_jogActive && _stepper)
+    if ((_jogActive || _jogStopping || _positioningActive || _feedStopping) && _stepper)
     {
         if (type == StopType::IMMEDIATE_HALT)
         {
@@ -529,6 +1245,11 @@ void MotionControl::requestImmediateStop(StopType type)
             _stepper->stop();
         }
         _jogActive = false;
+        _jogStopping = false;
+        _pendingJogDirection = JogDirection::JOG_NONE;
+        _positioningActive = false;
+        _feedStopping = false;
+        _feedRestartPending = false;
     }
 
     if (_running)
@@ -570,14 +1291,8 @@ bool MotionControl::isElsActive() const
     return _running && (_currentMode == Mode::THREADING || _currentMode == Mode::TURNING || _currentMode == Mode::FEEDING);
 }
 
-int32_t MotionControl::convertUnitsToSteps(float units) const
+float MotionControl::zStepsPerMm() const
 {
-    float valueInMm = units;
-    if (!SystemConfig::RuntimeConfig::System::measurement_unit_is_metric)
-    {
-        valueInMm = units * 25.4f;
-    }
-
     float z_motor_total_usteps = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::driver_pulses_per_rev);
     float z_motor_pulley_teeth = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::motor_pulley_teeth);
     if (z_motor_pulley_teeth < 1.0f)
@@ -590,38 +1305,33 @@ int32_t MotionControl::convertUnitsToSteps(float units) const
     bool z_ls_is_metric = SystemConfig::RuntimeConfig::Z_Axis::leadscrew_standard_is_metric;
     float z_ls_pitch_mm_per_ls_rev = z_ls_is_metric ? z_ls_pitch_val : (z_ls_pitch_val > 0 ? 25.4f / z_ls_pitch_val : 0.0f);
     if (fabsf(z_ls_pitch_mm_per_ls_rev) < 0.00001f)
-        return 0;
+        return 0.0f;
 
     float z_mm_travel_per_motor_rev = (z_motor_pulley_teeth / z_leadscrew_pulley_teeth) * z_ls_pitch_mm_per_ls_rev;
     if (fabsf(z_mm_travel_per_motor_rev) < 0.00001f)
-        return 0;
-
-    float z_usteps_per_mm_travel = z_motor_total_usteps / z_mm_travel_per_motor_rev;
+        return 0.0f;
 
-    return static_cast<int32_t>(roundf(valueInMm * z_usteps_per_mm_travel));
+    return z_motor_total_usteps / z_mm_travel_per_motor_rev;
 }
 
-float MotionControl::convertStepsToUnits(int32_t steps) const
+int32_t MotionControl::convertUnitsToSteps(float units) const
 {
-    float z_motor_total_usteps = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::driver_pulses_per_rev);
-    float z_motor_pulley_teeth = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::motor_pulley_teeth);
-    if (z_motor_pulley_teeth < 1.0f)
-        z_motor_pulley_teeth = 1.0f;
-    float z_leadscrew_pulley_teeth = static_cast<float>(SystemConfig::RuntimeConfig::Z_Axis::lead_screw_pulley_teeth);
-    if (z_leadscrew_pulley_teeth < 1.0f)
-        z_leadscrew_pulley_teeth = 1.0f;
+    float valueInMm = units;
+    if (!SystemConfig::RuntimeConfig::System::measurement_unit_is_metric)
+    {
+        valueInMm = units * 25.4f;
+    }
 
-    float z_ls_pitch_val = SystemConfig::RuntimeConfig::Z_Axis::lead_screw_pitch;
-    bool z_ls_is_metric = SystemConfig::RuntimeConfig::Z_Axis::leadscrew_standard_is_metric;
-    float z_ls_pitch_mm_per_ls_rev = z_ls_is_metric ? z_ls_pitch_val : (z_ls_pitch_val > 0 ? 25.4f / z_ls_pitch_val : 0.0f);
-    if (fabsf(z_ls_pitch_mm_per_ls_rev) < 0.00001f)
-        return 0.0f;
+    return static_cast<int32_t>(roundf(valueInMm * zStepsPerMm()));
+}
 
-    float z_mm_travel_per_motor_rev = (z_motor_pulley_teeth / z_leadscrew_pulley_teeth) * z_ls_pitch_mm_per_ls_rev;
-    if (fabsf(z_mm_travel_per_motor_rev) < 0.00001f)
+float MotionControl::convertStepsToUnits(int32_t steps) const
+{
+    float z_usteps_per_mm_travel = zStepsPerMm();
+    if (z_usteps_per_mm_travel <= 0.0f)
         return 0.0f;
 
-    float valueInMm = static_cast<float>(steps) * (z_mm_travel_per_motor_rev / z_motor_total_usteps);
+    float valueInMm = static_cast<float>(steps) / z_usteps_per_mm_travel;
 
     if (!SystemConfig::RuntimeConfig::System::measurement_unit_is_metric)
     {
@@ -1,8 +1,11 @@
 #include "Motion/Positioning.h"
+#include "Motion/MotionControl.h"
 #include "Config/serial_debug.h"
 
-Positioning::Positioning()
-    : _startPosition(0.0f),
+Positioning::Positioning(MotionControl *motionControl)
+    : _motionControl(motionControl),
+      _zeroOffsetSteps(0),
+      _startPosition(0.0f),
       _endPosition(0.0f),
       _backlashAmount(0.0f),
       _backlashMode(BacklashMode::NONE),
@@ -95,4 +98,75 @@ float Positioning::getCompensatedPosition(float position, bool movingPositive) c
     }
     
     return position;
-}
\ No newline at end of file
+}
+
+bool Positioning::goToAbsolute(float position, float speedMmPerMin)
+{
+    if (!_motionControl)
+    {
+        return false;
+    }
+    int32_t target = _zeroOffsetSteps + _motionControl->convertUnitsToSteps(position);
+    _endPosition = position;
+    return _motionControl->moveToPositionSteps(target, speedMmPerMin);
+}
+
+bool Positioning::moveBy(float distance, float speedMmPerMin)
+{
+    if (!_motionControl || isMoving())
+    {
+        return false;
+    }
+    int32_t target = _motionControl->getStatus().stepper_position + _motionControl->convertUnitsToSteps(distance);
+    _endPosition = _motionControl->convertStepsToUnits(target - _zeroOffsetSteps);
+    return _motionControl->moveToPositionSteps(target, speedMmPerMin);
+}
+
+bool Positioning::returnToStart(float speedMmPerMin)
+{
+    return goToAbsolute(_startPosition, speedMmPerMin);
+}
+
+void Positioning::stopMove()
+{
+    if (_motionControl)
+    {
+        _motionControl->abortPositioning();
+    }
+}
+
+bool Positioning::isMoving() const
+{
+    return _motionControl && _motionControl->isPositioning();
+}
+
+bool Positioning::isTakingUpBacklash() const
+{
+    return _motionControl && _motionControl->getBacklashTakeUpSteps() != 0;
+}
+
+void Positioning::setZeroPosition()
+{
+    if (!_motionControl)
+    {
+        return;
+    }
+    _zeroOffsetSteps = _motionControl->getStatus().stepper_position;
+    SerialDebug.print("Positioning: Z zero set at step ");
+    SerialDebug.println(_zeroOffsetSteps);
+}
+
+void Positioning::setStartHere()
+{
+    _startPosition = getCurrentPosition();
+}
+
+float Positioning::getCurrentPosition() const
+{
+    if (!_motionControl)
+    {
+        return 0.0f;
+    }
+    // getStatus() reads the live TIM5 pulse count
+    return _motionControl->convertStepsToUnits(_motionControl->getStatus().stepper_position - _zeroOffsetSteps);
+}
@@ -0,0 +1,53 @@
+#include "Motion/SpindleObserver.h"
+#include "Config/SystemConfig.h"
+#include <cmath>
+
+SpindleObserver::SpindleObserver() : _measured(0),
+                                     _offset(0),
+                                     _velocity(0),
+                                     _acceleration(0),
+                                     _gainPosition(0),
+                                     _gainVelocity(0),
+                                     _gainAcceleration(0)
+{
+}
+
+void SpindleObserver::configure(uint32_t tickHz)
+{
+    // Critically damped g-h-k filter: all three poles at theta, i.e. OBSERVER_BANDWIDTH_HZ.
+    float theta = expf(-2.0f * 3.14159265f * SystemConfig::Limits::Motion::OBSERVER_BANDWIDTH_HZ / static_cast<float>(tickHz));
+    float oneMinus = 1.0f - theta;
+    const float Q30 = 1073741824.0f;
+    _gainPosition = static_cast<int32_t>(lroundf((1.0f - theta * theta * theta) * Q30));
+    _gainVelocity = static_cast<int32_t>(lroundf(1.5f * (1.0f - theta * theta) * oneMinus * Q30));
+    _gainAcceleration = static_cast<int32_t>(lroundf(oneMinus * oneMinus * oneMinus * Q30));
+}
+
+void SpindleObserver::reset(uint32_t count)
+{
+    _measured = count;
+    _offset = 0;
+    _velocity = 0;
+    _acceleration = 0;
+}
+
+void SpindleObserver::update(int32_t rawDelta)
+{
+    _measured += rawDelta;
+
+    // Predict one tick ahead, relative to the count just measured...
+    _offset += _velocity + (_acceleration >> 1) - (static_cast<int64_t>(rawDelta) << 32);
+    _velocity += _acceleration;
+
+    // ...and correct with the residual. It is taken to Q16 and clamped so the Q30 products fit an
+    // int64; Q16 is still fine enough that the loop has no dead zone at high tick rates.
+    int64_t residual = (-_offset) >> 16;
+    if (residual > INT32_MAX)
+        residual = INT32_MAX;
+    else if (residual < INT32_MIN)
+        residual = INT32_MIN;
+    const int64_t round = 1LL << 13;
+    _offset += (residual * _gainPosition + round) >> 14;
+    _velocity += (residual * _gainVelocity + round) >> 14;
+    _acceleration += (residual * _gainAcceleration + round) >> 14;
+}
@@ -1,9 +1,12 @@
 #include "Motion/SyncTimer.h"
 #include "Config/serial_debug.h"
 #include "Hardware/EncoderTimer.h"
+#include "Config/SystemConfig.h"
+#include "Motion/GearRatio.h"
 #include <cmath>
 
-#define ENCODER_MAX_COUNT 0xFFFFFFFF
+// Edge-triggered bursts run this much faster than the spindle-derived rate
+static constexpr float EDGE_SYNC_RATE_MARGIN = 2.0f;
 
 SyncTimer *SyncTimer::instance = nullptr;
 
@@ -15,8 +18,72 @@ SyncTimer::SyncTimer() : _timer(nullptr),
                          _timerFrequency(1000),
                          _encoder(nullptr),
                          _stepper(nullptr),
-                         _desiredSteps_scaled_accumulated(0),
+                         _stepsPerCountWhole(0),
+                         _stepsPerCountRemainder(0),
+                         _ratioDenominator(1),
+                         _stepAccumulator(0),
+                         _commandedPosition(0),
+                         _subCountSteps(0),
                          _isr_lastEncoderCount(0),
+                         _previousSpindlePosition(0),
+                         _lastBoundaryMicros(0),
+                         _hwOriginCount(0),
+                         _hwOriginSteps(0),
+                         _hwCountingDown(false),
+                         _hwErrorToleranceSteps(0),
+                         _hardwareGearingFallbacks(0),
+                         _compareTable(),
+                         _compareStepCount(0),
+                         _compareAccumulator(0),
+                         _comparePendingFall(false),
+                         _ncoDemandedSteps(0),
+                         _ncoVelocity(0.0f),
+                         _ncoStepsPerCount(0.0f),
+                         _profileSegment(0),
+                         _profileStepInSegment(0),
+                         _profileBeyond(0),
+                         _profileNumerator(0),
+                         _profileSlopeWhole(0),
+                         _profileSlopeRemainder(0),
+                         _profileSlopeAccumulator(0),
+                         _observer(),
+                         _obsLeadCounts(0),
+                         _obsRunning(false),
+                         _followingErrorLimit(0),
+                         _followingError(0),
+                         _followingErrorMin(0),
+                         _followingErrorMax(0),
+                         _followingErrorSumSquares(0),
+                         _followingErrorSamples(0),
+                         _followingErrorTripped(false),
+                         _stopArmed(false),
+                         _stopTarget(0),
+                         _stopDeceleration(0.0f),
+                         _braking(false),
+                         _stopReached(false),
+                         _stopSettled(false),
+                         _brakePosition(0),
+                         _brakeDirection(1),
+                         _brakeVelocity(0.0f),
+                         _brakeCarry(0.0f),
+                         _stopLastDelivered(0),
+                         _stopQuietTicks(0),
+                         _stopOvershoot(0),
+                         _rampRequested(false),
+                         _rampAcceleration(0.0f),
+                         _rampSeedCountsPerSecond(0.0f),
+                         _rampActive(false),
+                         _rampVelocity(0.0f),
+                         _rampCarry(0.0f),
+                         _rampDeficit(0),
+                         _engagePending(false),
+                         _engageCount(0),
+                         _engagePhase(0),
+                         _catchUpSteps(0),
+                         _phaseShiftRemaining(0),
+                         _configSlots(),
+                         _configSequence(0),
+                         _appliedSequence(0),
                          _debug_interrupt_count(0),
                          _debug_last_steps(0),
                          _debug_isr_spindle_pos(0),
@@ -127,45 +194,541 @@ void SyncTimer::enable(bool enable)
         return;
     }
 
-    _enabled = enable;
     if (enable)
     {
+        _catchUpSteps = 0;
+        _subCountSteps = 0;
+        _rampDeficit = 0;
+        resetFollowingErrorStats();
+        _followingErrorTripped = false;
+        if (_stepper)
+        {
+            _stepper->updatePositionFromHardware();
+            _commandedPosition = _stepper->getCurrentPosition();
+        }
+        engage(0, _encoder ? _encoder->getRawCounter() : 0);
+    }
+    else
+    {
+        _enabled = false;
+        _obsRunning = false;
+        _rampActive = false;
+        _engagePending = false;
+        _timer->pause();
         if (_encoder)
         {
-            _isr_lastEncoderCount = _encoder->getCount();
+            _encoder->disarmStepBoundaries();
+            _encoder->setStepBoundaryCallback(nullptr);
+        }
+        if (STM32Step::TimerControl::isExternalGearingActive())
+        {
+            stopHardwareGearing();
+        }
+        if (_stepper && STM32Step::TimerControl::isNcoActive())
+        {
+            _stepper->stopNco();
+        }
+    }
+}
+
+bool SyncTimer::engageAt(uint32_t count, int32_t initialPhase, int32_t catchUpSteps)
+{
+    if (!_initialized || !_encoder || !_stepper || _enabled)
+    {
+        return false;
+    }
+    if (initialPhase < 0 || initialPhase >= _ratioDenominator)
+    {
+        initialPhase = 0;
+    }
+
+    _stepper->updatePositionFromHardware();
+    resetFollowingErrorStats();
+    _followingErrorTripped = false;
+    _encoder->setStepBoundaryCallback([this]()
+                                      { this->handleStepBoundary(); });
+    __disable_irq();
+    _engageCount = count;
+    _engagePhase = initialPhase;
+    _catchUpSteps = catchUpSteps;
+    _subCountSteps = 0;
+    _rampDeficit = 0;
+    _commandedPosition = _stepper->getCurrentPosition();
+    _engagePending = true;
+    _encoder->armStepBoundaries(count, count);
+    // Compares fire on equality only; make sure the spindle has not already passed the count.
+    int32_t lead = static_cast<int32_t>(count - _encoder->getRawCounter());
+    if (_encoder->isCountingDown())
+    {
+        lead = -lead;
+    }
+    if (lead <= 0)
+    {
+        _encoder->disarmStepBoundaries();
+        _engagePending = false;
+    }
+    __enable_irq();
+    return _engagePending;
+}
+
+void SyncTimer::armStopAt(int32_t position, float deceleration)
+{
+    __disable_irq();
+    _stopTarget = position;
+    _stopDeceleration = deceleration;
+    _stopArmed = deceleration > 0.0f;
+    __enable_irq();
+}
+
+void SyncTimer::requestEngageRamp(float acceleration, float spindleCountsPerSecond)
+{
+    _rampRequested = acceleration > 0.0f;
+    _rampAcceleration = acceleration;
+    _rampSeedCountsPerSecond = spindleCountsPerSecond;
+    _rampVelocity = 0.0f;
+    _rampCarry = 0.0f;
+    _rampDeficit = 0;
+}
+
+bool SyncTimer::shiftPhaseOrigin(int32_t counts)
+{
+    if (!_initialized || !_encoder)
+    {
+        return false;
+    }
+
+    bool shifted = true;
+    __disable_irq();
+    if (_engagePending)
+    {
+        // Not engaged yet: simply engage that much later.
+        _engageCount += static_cast<uint32_t>(counts);
+        _encoder->armStepBoundaries(_engageCount, _engageCount);
+    }
+    else if (_enabled && (_config.mode == Mode::PERIODIC || _config.mode == Mode::EDGE_TRIGGERED || _config.mode == Mode::NCO))
+    {
+        _phaseShiftRemaining += counts;
+    }
+    else
+    {
+        shifted = false; // Idle, or the step train is generated in hardware
+    }
+    __enable_irq();
+    return shifted;
+}
+
+int32_t SyncTimer::absorbPhaseShift(int32_t countDelta)
+{
+    if (_phaseShiftRemaining == 0 || countDelta == 0 || (countDelta > 0) != (_phaseShiftRemaining > 0))
+    {
+        return 0;
+    }
+    int32_t taken = (countDelta > 0) ? (countDelta < _phaseShiftRemaining ? countDelta : _phaseShiftRemaining)
+                                     : (countDelta > _phaseShiftRemaining ? countDelta : _phaseShiftRemaining);
+    _phaseShiftRemaining -= taken;
+    return taken;
+}
+
+void SyncTimer::handleEngageCompare()
+{
+    _engagePending = false;
+    _debug_interrupt_count++;
+    if (_config.mode != Mode::EDGE_TRIGGERED)
+    {
+        // The hardware and NCO starts re-initialise TIM1 through HAL; keep that out of this ISR.
+        _config.mode = Mode::PERIODIC;
+    }
+    engage(_engagePhase, _engageCount, true);
+}
+
+bool SyncTimer::getSyncState(SyncState &state) const
+{
+    if (!_enabled || !_encoder || _config.pitch_segment_count > 0)
+    {
+        return false;
+    }
+
+    __disable_irq();
+    if (_rampActive)
+    {
+        __enable_irq();
+        return false; // The stepper is not on the relation yet
+    }
+    if (_config.mode == Mode::HARDWARE_GEARING || _config.mode == Mode::COMPARE_DMA)
+    {
+        // Same exact demand as the supervisor, taken at the live count.
+        state.count = _encoder->getRawCounter();
+        int32_t countDelta = static_cast<int32_t>(state.count - _hwOriginCount);
+        if (_config.reverse_direction)
+        {
+            countDelta = -countDelta;
+        }
+        int64_t scaled = static_cast<int64_t>(countDelta) * _config.ratio_numerator;
+        int64_t den = static_cast<int64_t>(_config.ratio_denominator);
+        int64_t demanded = scaled / den;
+        if (scaled % den != 0 && scaled < 0)
+        {
+            demanded--; // floor
+        }
+        state.position = _hwOriginSteps + static_cast<int32_t>(demanded);
+        state.phase = static_cast<int32_t>(scaled - demanded * den);
+    }
+    else
+    {
+        // Counts still to be absorbed have not moved the gearing, and PERIODIC gears the observer lead ahead.
+        state.count = _previousSpindlePosition + static_cast<uint32_t>(_phaseShiftRemaining + _obsLeadCounts);
+        state.position = _commandedPosition + _catchUpSteps;
+        state.phase = _stepAccumulator;
+    }
+    __enable_irq();
+    return true;
+}
+
+void SyncTimer::engage(int32_t initialPhase, uint32_t origin, bool fromCompare)
+{
+    _enabled = true;
+    if (_encoder)
+    {
+        _isr_lastEncoderCount = _encoder->getCount();
+    }
+    else
+    {
+        _error = true;
+        return;
+    }
+    _previousSpindlePosition = origin;
+    _stepAccumulator = initialPhase;
+    _phaseShiftRemaining = 0;
+    _obsRunning = false;
+    // A new engagement starts from the stepper as it stands; an armed stop applies afresh.
+    _braking = false;
+    _stopReached = false;
+    _stopSettled = false;
+    // Steps a restarted ramp still owed are demanded again from the new origin.
+    _catchUpSteps += _rampDeficit;
+    _rampDeficit = 0;
+    if (_config.mode != Mode::PERIODIC)
+    {
+        // Only PERIODIC carries the sub-count target over; the others take the stepper as it stands.
+        _catchUpSteps -= _subCountSteps;
+        _subCountSteps = 0;
+    }
+    if (_config.mode == Mode::EDGE_TRIGGERED)
+    {
+        _timer->pause();
+        _lastBoundaryMicros = micros();
+        // Command what is due since the origin and arm. The origin lies behind the live count after
+        // an engage compare or a mode change, and those counts must not be dropped.
+        if (fromCompare)
+        {
+            handleStepBoundary(); // Already in the boundary callback
         }
         else
         {
-            _error = true;
-            return;
+            _encoder->setStepBoundaryCallback([this]()
+                                              { this->handleStepBoundary(); });
+            __disable_irq();
+            handleStepBoundary();
+            __enable_irq();
+        }
+    }
+    else if (_config.mode == Mode::HARDWARE_GEARING)
+    {
+        _catchUpSteps = 0; // Hardware paths start in phase from the stepper's position
+        if (startHardwareGearing())
+        {
+            setSyncFrequency(SystemConfig::Limits::Motion::HARDWARE_GEARING_SUPERVISOR_HZ);
+        }
+        else
+        {
+            _config.mode = Mode::PERIODIC;
+            setSyncFrequency(_config.update_freq);
+        }
+        _timer->resume();
+    }
+    else if (_config.mode == Mode::COMPARE_DMA)
+    {
+        _catchUpSteps = 0;
+        if (startCompareDmaGearing())
+        {
+            setSyncFrequency(SystemConfig::Limits::Motion::HARDWARE_GEARING_SUPERVISOR_HZ);
+        }
+        else
+        {
+            _config.mode = Mode::PERIODIC;
+            _previousSpindlePosition = origin; // The failed start may have taken the live count
+            setSyncFrequency(_config.update_freq);
+        }
+        _timer->resume();
+    }
+    else if (_config.mode == Mode::NCO)
+    {
+        if (startNco())
+        {
+            setSyncFrequency(SystemConfig::Limits::Motion::NCO_UPDATE_HZ);
+        }
+        else
+        {
+            _config.mode = Mode::PERIODIC;
+            setSyncFrequency(_config.update_freq);
         }
-        _previousSpindlePosition = _encoder->getRawCounter();
-        _desiredSteps_scaled_accumulated = 0;
         _timer->resume();
     }
     else
     {
-        _timer->pause();
+        _timer->resume();
+    }
+    resetObserver(_previousSpindlePosition);
+    _obsRunning = _config.mode == Mode::PERIODIC || _config.mode == Mode::NCO;
+    if (_rampRequested && _obsRunning)
+    {
+        // Start the observer at the spindle's speed so the ramp aims at it from the first tick.
+        _observer.setVelocity(static_cast<int64_t>(_rampSeedCountsPerSecond / static_cast<float>(_timerFrequency) * 4294967296.0f));
+        _rampCarry = 0.0f;
+        _rampActive = true;
     }
+    _rampRequested = false;
 }
 
 void SyncTimer::setConfig(const SyncConfig &new_config)
 {
+    SyncConfig next = new_config;
+    if (next.ratio_denominator == 0)
+    {
+        next.ratio_numerator = 0;
+        next.ratio_denominator = 1;
+    }
+    if (_enabled && (next.mode == Mode::HARDWARE_GEARING || next.mode == Mode::COMPARE_DMA))
+    {
+        // The hardware paths start from the live count and the stepper as it stands, which would
+        // drop whatever the running path still owes; they are only entered from a fresh engage.
+        next.mode = Mode::PERIODIC;
+    }
+
+    if (_enabled && next.mode == _config.mode &&
+        (_config.mode == Mode::PERIODIC || _config.mode == Mode::EDGE_TRIGGERED || _config.mode == Mode::NCO))
+    {
+        // Live hand-off: publish into the slot the ISR is not reading, then bump the sequence.
+        // The ISR cannot be pre-empted by this writer, so it never sees a half-written slot.
+        uint32_t sequence = _configSequence + 1;
+        _configSlots[sequence & 1] = next;
+        __DMB();
+        _configSequence = sequence;
+
+        if (_config.mode == Mode::EDGE_TRIGGERED)
+        {
+            // The next boundary might be far away at low RPM; run one now so the new ratio
+            // is in effect immediately and the compares are re-armed for it.
+            __disable_irq();
+            _encoder->disarmStepBoundaries();
+            handleStepBoundary();
+            __enable_irq();
+        }
+        return;
+    }
+
+    // The mode itself changes: restart from the count the old path has geared up to, so no
+    // counts are lost in between, and carry the phase over.
     bool was_enabled = _enabled;
+    Mode previousMode = _config.mode;
+    if (_rampActive)
+    {
+        // Carry on ramping from the current speed once the new path is engaged.
+        _rampRequested = true;
+        _rampSeedCountsPerSecond = getObserverState().velocity;
+    }
+    uint32_t origin = 0;
     if (was_enabled)
     {
+        // Counts still to be absorbed have not moved the gearing, and PERIODIC gears the observer lead ahead.
+        origin = _previousSpindlePosition + static_cast<uint32_t>(_phaseShiftRemaining + _obsLeadCounts);
         this->enable(false);
+        if (previousMode == Mode::HARDWARE_GEARING || previousMode == Mode::COMPARE_DMA)
+        {
+            origin = settleHardwareDemand();
+        }
+        else if (previousMode == Mode::NCO)
+        {
+            // The NCO was stopped where it stood; what it still owed is demanded again.
+            _stepper->updatePositionFromHardware();
+            int32_t owed = _hwOriginSteps + _ncoDemandedSteps - _stepper->getCurrentPosition();
+            _commandedPosition -= owed;
+            _catchUpSteps += owed;
+        }
     }
 
-    _config = new_config;
+    int32_t phase = rescalePhase(next.ratio_denominator);
+    _config = next;
+    applyRatio();
+    _configSequence = _appliedSequence;
     setSyncFrequency(_config.update_freq);
 
     if (was_enabled)
     {
-        this->enable(true);
+        engage(phase, origin);
     }
 }
 
+uint32_t SyncTimer::settleHardwareDemand()
+{
+    // The chain is stopped, so the live count is final: take the exact demand there (the same
+    // division as the supervisor), and owe the stepper whatever it had not delivered yet.
+    uint32_t count = _encoder->getRawCounter();
+    int32_t countDelta = static_cast<int32_t>(count - _hwOriginCount);
+    if (_config.reverse_direction)
+    {
+        countDelta = -countDelta;
+    }
+    int64_t scaled = static_cast<int64_t>(countDelta) * _config.ratio_numerator;
+    int64_t den = static_cast<int64_t>(_config.ratio_denominator);
+    int64_t demanded = scaled / den;
+    if (scaled % den != 0 && scaled < 0)
+    {
+        demanded--; // floor
+    }
+
+    _stepper->updatePositionFromHardware();
+    int32_t delivered = _stepper->getCurrentPosition();
+    _stepAccumulator = static_cast<int32_t>(scaled - demanded * den);
+    _commandedPosition = delivered;
+    _catchUpSteps += _hwOriginSteps + static_cast<int32_t>(demanded) - delivered;
+    _subCountSteps = 0;
+    return count;
+}
+
+void SyncTimer::applyRatio()
+{
+    _stepsPerCountWhole = static_cast<int32_t>(_config.ratio_numerator / _config.ratio_denominator);
+    _stepsPerCountRemainder = static_cast<int32_t>(_config.ratio_numerator % _config.ratio_denominator);
+    _ratioDenominator = static_cast<int32_t>(_config.ratio_denominator);
+    _ncoStepsPerCount = static_cast<float>(_config.ratio_numerator) / static_cast<float>(_config.ratio_denominator);
+    resetPitchProfile();
+}
+
+void SyncTimer::resetPitchProfile()
+{
+    _profileSegment = 0;
+    _profileStepInSegment = 0;
+    _profileBeyond = 0;
+    _profileNumerator = static_cast<int32_t>(_config.ratio_numerator);
+    if (_config.pitch_segments && _config.pitch_segment_count > 0)
+    {
+        loadPitchSegment(0);
+    }
+}
+
+void SyncTimer::loadPitchSegment(uint8_t index)
+{
+    const PitchSegment &segment = _config.pitch_segments[index];
+    int32_t start = index > 0 ? static_cast<int32_t>(_config.pitch_segments[index - 1].end_numerator)
+                              : static_cast<int32_t>(_config.ratio_numerator);
+    int32_t length = static_cast<int32_t>(segment.length_steps);
+    int32_t delta = static_cast<int32_t>(segment.end_numerator) - start;
+    _profileSlopeWhole = delta / length;
+    _profileSlopeRemainder = delta % length;
+    if (_profileSlopeRemainder < 0)
+    {
+        _profileSlopeRemainder += length;
+        --_profileSlopeWhole;
+    }
+    _profileSlopeAccumulator = 0;
+}
+
+void SyncTimer::advancePitchProfile(int32_t steps)
+{
+    int32_t numerator = _profileNumerator;
+    while (steps > 0)
+    {
+        --steps;
+        int32_t length = static_cast<int32_t>(_config.pitch_segments[_profileSegment].length_steps);
+        if (_profileBeyond < 0 || _profileStepInSegment == length)
+        {
+            if (_profileBeyond < 0)
+            {
+                ++_profileBeyond;
+                continue;
+            }
+            if (_profileSegment + 1 >= _config.pitch_segment_count)
+            {
+                ++_profileBeyond; // Past the end: hold the last pitch
+                continue;
+            }
+            loadPitchSegment(++_profileSegment);
+            _profileStepInSegment = 0;
+        }
+        ++_profileStepInSegment;
+        _profileNumerator += _profileSlopeWhole;
+        _profileSlopeAccumulator += _profileSlopeRemainder;
+        if (_profileSlopeAccumulator >= static_cast<int32_t>(_config.pitch_segments[_profileSegment].length_steps))
+        {
+            _profileSlopeAccumulator -= static_cast<int32_t>(_config.pitch_segments[_profileSegment].length_steps);
+            ++_profileNumerator;
+        }
+    }
+    while (steps < 0)
+    {
+        ++steps;
+        if (_profileBeyond > 0 || _profileStepInSegment == 0)
+        {
+            if (_profileBeyond > 0)
+            {
+                --_profileBeyond;
+                continue;
+            }
+            if (_profileSegment == 0)
+            {
+                --_profileBeyond; // Before the start: hold the first pitch
+                continue;
+            }
+            // Step back into the previous segment at its end; the numerator there is exact.
+            loadPitchSegment(--_profileSegment);
+            _profileStepInSegment = static_cast<int32_t>(_config.pitch_segments[_profileSegment].length_steps);
+        }
+        --_profileStepInSegment;
+        _profileNumerator -= _profileSlopeWhole;
+        _profileSlopeAccumulator -= _profileSlopeRemainder;
+        if (_profileSlopeAccumulator < 0)
+        {
+            _profileSlopeAccumulator += static_cast<int32_t>(_config.pitch_segments[_profileSegment].length_steps);
+            --_profileNumerator;
+        }
+    }
+
+    if (_profileNumerator != numerator)
+    {
+        // The denominator is fixed for the whole profile, so the Bresenham phase stays valid.
+        _stepsPerCountWhole = _profileNumerator / _ratioDenominator;
+        _stepsPerCountRemainder = _profileNumerator % _ratioDenominator;
+        _ncoStepsPerCount = static_cast<float>(_profileNumerator) / static_cast<float>(_ratioDenominator);
+    }
+}
+
+int32_t SyncTimer::rescalePhase(uint32_t newDenominator) const
+{
+    // Same fraction of a step under the new denominator; stays in [0, newDenominator).
+    return static_cast<int32_t>(static_cast<int64_t>(_stepAccumulator) * newDenominator / _ratioDenominator);
+}
+
+void SyncTimer::applyPendingConfig()
+{
+    uint32_t sequence = _configSequence;
+    if (sequence == _appliedSequence)
+    {
+        return;
+    }
+
+    const SyncConfig &next = _configSlots[sequence & 1];
+    _stepAccumulator = rescalePhase(next.ratio_denominator);
+    uint32_t previousFrequency = _config.update_freq;
+    _config = next;
+    applyRatio();
+    if (_config.mode == Mode::PERIODIC && _config.update_freq != previousFrequency)
+    {
+        setSyncFrequency(_config.update_freq);
+    }
+    _appliedSequence = sequence;
+}
+
 void SyncTimer::setSyncFrequency(uint32_t freq)
 {
     if (!_initialized || !_timer || freq == 0)
@@ -180,12 +743,50 @@ void SyncTimer::setSyncFrequency(uint32_t freq)
     _timer->setPrescaleFactor(prescaler);
     _timer->setOverflow(period);
     _timerFrequency = freq;
+    _observer.configure(freq);
+}
+
+void SyncTimer::resetObserver(uint32_t count)
+{
+    _observer.reset(count);
+    _obsLeadCounts = 0;
+}
+
+SyncTimer::ObserverState SyncTimer::getObserverState() const
+{
+    ObserverState state;
+    __disable_irq();
+    int64_t measured = _observer.measured();
+    int64_t offset = _observer.offset();
+    int64_t velocity = _observer.velocity();
+    int64_t acceleration = _observer.acceleration();
+    state.valid = _enabled && _obsRunning;
+    __enable_irq();
+
+    const float Q32 = 4294967296.0f;
+    float rate = static_cast<float>(_timerFrequency);
+    state.position = static_cast<float>(measured) + static_cast<float>(offset) / Q32;
+    state.velocity = static_cast<float>(velocity) / Q32 * rate;
+    state.acceleration = static_cast<float>(acceleration) / Q32 * rate * rate;
+    return state;
 }
 
 void SyncTimer::handleInterrupt()
 {
-    if (!_enabled || !_encoder || !_stepper)
+    if (!_enabled || !_encoder || !_stepper || _config.mode == Mode::EDGE_TRIGGERED)
+    {
+        return;
+    }
+
+    if (_config.mode == Mode::HARDWARE_GEARING || _config.mode == Mode::COMPARE_DMA)
     {
+        superviseHardwareGearing();
+        return;
+    }
+
+    if (_config.mode == Mode::NCO)
+    {
+        updateNco();
         return;
     }
 
@@ -197,24 +798,18 @@ void SyncTimer::handleInterrupt()
     _debug_isr_spindle_pos = spindlePosition;
     _debug_isr_previous_pos = _previousSpindlePosition;
 
-    // Calculate encoder delta with rollover handling
-    int64_t delta_encoder = static_cast<int64_t>(spindlePosition) - static_cast<int64_t>(_previousSpindlePosition);
+    // Unsigned subtraction followed by a signed cast handles 32-bit counter rollover
+    int32_t rawDelta = static_cast<int32_t>(spindlePosition - _previousSpindlePosition);
+    int32_t delta_encoder = rawDelta;
+    _observer.update(delta_encoder);
+    delta_encoder -= absorbPhaseShift(delta_encoder);
 
-    // Handle overflow/underflow (rollover)
-    // Cast to int64_t first to ensure signed arithmetic works correctly
-    const int64_t MAX_ENC_VAL = static_cast<int64_t>(ENCODER_MAX_COUNT);
-    const int64_t HALF_MAX_ENC_VAL = MAX_ENC_VAL / 2;
-
-    // If change is very large negative, it wrapped forward (e.g. MAX -> 0) -> Add MAX
-    if (delta_encoder < -HALF_MAX_ENC_VAL)
-    {
-        delta_encoder += (MAX_ENC_VAL + 1);
-    }
-    // If change is very large positive, it wrapped backward (e.g. 0 -> MAX) -> Subtract MAX
-    else if (delta_encoder > HALF_MAX_ENC_VAL)
-    {
-        delta_encoder -= (MAX_ENC_VAL + 1);
-    }
+    // Gear to the count predicted for the end of the coming period, when these steps will have been
+    // emitted, rather than the count just read. Only the change in lead is fed in, so the step
+    // position stays exact to the encoder once the spindle stops.
+    int32_t lead = SystemConfig::RuntimeConfig::Motion::observer_feed_forward ? static_cast<int32_t>((_observer.velocity() + (1LL << 31)) >> 32) : 0;
+    delta_encoder += lead - _obsLeadCounts;
+    _obsLeadCounts = lead;
 
     // Apply direction
     if (_config.reverse_direction)
@@ -222,14 +817,21 @@ void SyncTimer::handleInterrupt()
         delta_encoder = -delta_encoder;
     }
 
-    // Scale
-    int64_t delta_scaled = delta_encoder * _config.steps_per_encoder_tick_scaled;
+    // Everything commanded up to the last tick should have gone out by now.
+    _stepper->updatePositionFromHardware();
+    recordFollowingError(emittedPosition() - _stepper->getCurrentPosition());
+
+    int32_t stepsToMove = advanceGearing(delta_encoder);
+
+    // remember values for next time
+    _previousSpindlePosition = spindlePosition;
 
-    // Add to accumulator
-    _desiredSteps_scaled_accumulated += delta_scaled;
+    // Counts up to here belong to the old ratio; a new one starts with the next period.
+    applyPendingConfig();
 
-    // calculate the number of whole steps to move
-    int32_t stepsToMove = static_cast<int32_t>(_desiredSteps_scaled_accumulated / _config.scaling_factor);
+    // Between counts, step on to the interpolated position within the coming one.
+    stepsToMove += interpolateSubCount(spindlePosition, rawDelta);
+    stepsToMove = brakeSteps(rampSteps(stepsToMove));
     _debug_last_steps = stepsToMove;
 
     if (stepsToMove != 0)
@@ -244,20 +846,666 @@ void SyncTimer::handleInterrupt()
 
         _stepper->setSpeedHz(speedHz);
 
-        // remove the steps we are about to command from the accumulator
-        _desiredSteps_scaled_accumulated -= static_cast<int64_t>(stepsToMove) * _config.scaling_factor;
-
         // command the move
         _stepper->setRelativePosition(stepsToMove);
     }
 
-    // remember values for next time
-    _previousSpindlePosition = spindlePosition;
-
     _lastUpdateTime = HAL_GetTick();
 
     // Kick the stepper if needed
     _stepper->ISR();
+    superviseStop();
+}
+
+int32_t SyncTimer::advanceGearing(int32_t countDelta)
+{
+    int32_t steps = _catchUpSteps;
+    _catchUpSteps = 0;
+    if (_config.pitch_segment_count > 0)
+    {
+        if (steps != 0)
+        {
+            advancePitchProfile(_config.reverse_direction ? -steps : steps);
+        }
+        steps += advanceProfileGearing(countDelta);
+    }
+    else
+    {
+        // The whole delta at once, so the cost does not grow with spindle speed
+        int64_t numerator = static_cast<int64_t>(_stepsPerCountWhole) * _ratioDenominator + _stepsPerCountRemainder;
+        steps += static_cast<int32_t>(GearRatio::advance(countDelta, numerator, _ratioDenominator, _stepAccumulator));
+    }
+    _commandedPosition += steps;
+    return steps;
+}
+
+int32_t SyncTimer::advanceProfileGearing(int32_t countDelta)
+{
+    // Each count is geared at the pitch where it starts, so the result does not depend on how the
+    // counts fall into ticks. The pitch only changes with a step, so the counts up to the next step
+    // go in one run: the loops turn once per step, not once per count.
+    int32_t travel = _config.reverse_direction ? -1 : 1;
+    int32_t steps = 0;
+    while (countDelta > 0)
+    {
+        int32_t run = static_cast<int32_t>(countsToNextStep(_stepAccumulator, true));
+        if (run == 0 || run > countDelta)
+        {
+            run = countDelta; // No step in what is left
+        }
+        int32_t due = static_cast<int32_t>(GearRatio::advance(run, _profileNumerator, _ratioDenominator, _stepAccumulator));
+        countDelta -= run;
+        if (due != 0)
+        {
+            advancePitchProfile(travel * due);
+            steps += due;
+        }
+    }
+    while (countDelta < 0)
+    {
+        // Counts that undo no step...
+        int32_t run = -countDelta;
+        if (_profileNumerator > 0 && _stepAccumulator / _profileNumerator < run)
+        {
+            run = _stepAccumulator / _profileNumerator;
+        }
+        _stepAccumulator -= run * _profileNumerator;
+        countDelta += run;
+        if (countDelta == 0)
+        {
+            break;
+        }
+
+        // ...then one that does, undone at the pitch its steps were taken at. This lands on a state
+        // the forward count leads straight back from, so rocking the spindle never walks the thread off.
+        int64_t accumulator = _stepAccumulator;
+        while (accumulator < _profileNumerator)
+        {
+            accumulator += _ratioDenominator;
+            advancePitchProfile(-travel);
+            --steps;
+        }
+        accumulator -= _profileNumerator;
+        if (accumulator >= _ratioDenominator)
+        {
+            // No forward count ends here (the pitch rose across the step): take the nearest phase
+            accumulator = _ratioDenominator - 1;
+        }
+        _stepAccumulator = static_cast<int32_t>(accumulator);
+        ++countDelta;
+    }
+    return steps;
+}
+
+int32_t SyncTimer::emittedPosition() const
+{
+    return _braking ? _brakePosition : _commandedPosition + _subCountSteps - _rampDeficit;
+}
+
+int32_t SyncTimer::brakeSteps(int32_t steps)
+{
+    if (_stopReached)
+    {
+        return 0; // Holding on the target until the owner stops the sync path
+    }
+    float dt = 1.0f / static_cast<float>(_timerFrequency);
+    if (!_braking)
+    {
+        if (!_stopArmed)
+        {
+            return steps;
+        }
+        int32_t before = emittedPosition() - steps;
+        int32_t toGo = _stopTarget - before;
+        float rate = _rampActive ? _rampVelocity : observerStepRate();
+        int32_t direction = toGo != 0 ? (toGo > 0 ? 1 : -1) : (steps != 0 ? (steps > 0 ? 1 : -1) : (rate > 0.0f ? 1 : -1));
+        bool approaching = (direction > 0 && (steps > 0 || rate > 0.0f)) || (direction < 0 && (steps < 0 || rate < 0.0f));
+        if (!approaching)
+        {
+            return steps;
+        }
+        float speed = fabsf(rate);
+        if (speed < static_cast<float>(std::abs(steps)) / dt)
+            speed = static_cast<float>(std::abs(steps)) / dt; // Observer still settling: go by what the gearing asked for
+        float distance = fabsf(static_cast<float>(toGo));
+        float brakingDistance = speed * speed / (2.0f * _stopDeceleration) + speed * dt + static_cast<float>(std::abs(steps));
+        if (distance > brakingDistance)
+        {
+            return steps;
+        }
+        // Leave the gearing here; it keeps counting so the relation survives the stop.
+        _braking = true;
+        _brakePosition = before;
+        _brakeDirection = direction;
+        _brakeVelocity = speed;
+        _brakeCarry = 0.0f;
+        _rampActive = false;
+        _rampDeficit = 0;
+    }
+
+    // Never faster than on entry, and never faster than still allows stopping on the target.
+    int32_t remaining = (_stopTarget - _brakePosition) * _brakeDirection;
+    float limit = sqrtf(2.0f * _stopDeceleration * static_cast<float>(remaining));
+    if (_brakeVelocity > limit)
+        _brakeVelocity = limit;
+    _brakeCarry += _brakeVelocity * dt;
+    int32_t n = static_cast<int32_t>(_brakeCarry);
+    if (n > remaining)
+        n = remaining;
+    _brakeCarry -= static_cast<float>(n);
+    _brakePosition += n * _brakeDirection;
+    if (_brakePosition == _stopTarget)
+    {
+        _brakeVelocity = 0.0f;
+        _stopReached = true;
+        _stopLastDelivered = _stepper->getCurrentPosition();
+        _stopQuietTicks = 0;
+    }
+    return n * _brakeDirection;
+}
+
+void SyncTimer::superviseStop()
+{
+    if (!_stopReached || _stopSettled)
+    {
+        return;
+    }
+    _stepper->updatePositionFromHardware();
+    int32_t delivered = _stepper->getCurrentPosition();
+    // The last steps were only just commanded, so an unchanged position alone proves nothing yet.
+    bool pending = (_config.mode == Mode::NCO)
+                       ? _hwOriginSteps + _ncoDemandedSteps != delivered // Its output never stops running
+                       : _stepper->isRunning() || _stepper->getDesiredPosition() != _stepper->getTargetPosition();
+    bool quiet = delivered == _stopLastDelivered && !pending;
+    _stopQuietTicks = quiet ? _stopQuietTicks + 1 : 0;
+    _stopLastDelivered = delivered;
+    if (delivered == _stopTarget || _stopQuietTicks >= SystemConfig::Limits::Motion::STOP_SETTLE_QUIET_TICKS)
+    {
+        _stopOvershoot = (delivered - _stopTarget) * _brakeDirection;
+        _stopSettled = true;
+    }
+}
+
+void SyncTimer::recordFollowingError(int32_t error)
+{
+    _followingError = error;
+    if (_followingErrorSamples == 0 || error < _followingErrorMin)
+        _followingErrorMin = error;
+    if (_followingErrorSamples == 0 || error > _followingErrorMax)
+        _followingErrorMax = error;
+    _followingErrorSumSquares += static_cast<uint64_t>(static_cast<int64_t>(error) * error);
+    _followingErrorSamples++;
+
+    // Slack still being taken up after a reversal is a planned lag, not lost steps
+    int32_t limit = _followingErrorLimit + (_stepper ? static_cast<int32_t>(_stepper->getTakeUpRemaining()) : 0);
+    if (_followingErrorLimit > 0 && (error > limit || error < -limit))
+    {
+        _followingErrorTripped = true;
+    }
+}
+
+SyncTimer::FollowingErrorStats SyncTimer::getFollowingErrorStats() const
+{
+    FollowingErrorStats stats;
+    __disable_irq();
+    stats.current = _followingError;
+    stats.min = _followingErrorMin;
+    stats.max = _followingErrorMax;
+    stats.samples = _followingErrorSamples;
+    uint64_t sumSquares = _followingErrorSumSquares;
+    __enable_irq();
+    stats.rms = stats.samples ? sqrtf(static_cast<float>(sumSquares) / static_cast<float>(stats.samples)) : 0.0f;
+    return stats;
+}
+
+void SyncTimer::resetFollowingErrorStats()
+{
+    __disable_irq();
+    _followingError = 0;
+    _followingErrorMin = 0;
+    _followingErrorMax = 0;
+    _followingErrorSumSquares = 0;
+    _followingErrorSamples = 0;
+    __enable_irq();
+}
+
+float SyncTimer::observerStepRate() const
+{
+    float countsPerSecond = static_cast<float>(_observer.velocity()) / 4294967296.0f * static_cast<float>(_timerFrequency);
+    return (_config.reverse_direction ? -countsPerSecond : countsPerSecond) * _ncoStepsPerCount;
+}
+
+int32_t SyncTimer::rampSteps(int32_t dueSteps)
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+
+    if (!_rampActive)
+    {
+        return dueSteps;
+    }
+    _rampDeficit += dueSteps;
+
+    float dt = 1.0f / static_cast<float>(_timerFrequency);
+    float dv = _rampAcceleration * dt;
+    float syncRate = observerStepRate();
+
+    // Aim at the synchronous speed plus what still allows stopping exactly on the owed steps,
+    // with the catch-up part bounded.
+    float owed = static_cast<float>(_rampDeficit);
+    float catchUp = sqrtf(2.0f * _rampAcceleration * fabsf(owed));
+    float bound = MotionLimits::ENGAGE_CATCHUP_FRACTION * fabsf(syncRate);
+    if (bound < MotionLimits::ENGAGE_CATCHUP_MIN_HZ)
+        bound = MotionLimits::ENGAGE_CATCHUP_MIN_HZ;
+    if (catchUp > bound)
+        catchUp = bound;
+    float target = syncRate + (owed < 0.0f ? -catchUp : catchUp);
+
+    float change = target - _rampVelocity;
+    if (change > dv)
+        change = dv;
+    else if (change < -dv)
+        change = -dv;
+    _rampVelocity += change;
+
+    // Emit whole steps of the ramp's travel, never past what is owed.
+    _rampCarry += _rampVelocity * dt;
+    int32_t steps = static_cast<int32_t>(_rampCarry);
+    int32_t low = _rampDeficit < 0 ? _rampDeficit : 0;
+    int32_t high = _rampDeficit > 0 ? _rampDeficit : 0;
+    if (steps < low || steps > high)
+    {
+        steps = steps < low ? low : high;
+        _rampCarry = 0.0f;
+    }
+    else
+    {
+        _rampCarry -= static_cast<float>(steps);
+    }
+    _rampDeficit -= steps;
+
+    // Locked: at most a tick's worth owed and at synchronous speed. The remainder goes out with
+    // this tick and the gearing output is passed straight through from here on.
+    float tolerance = MotionLimits::ENGAGE_LOCK_VELOCITY_FRACTION * fabsf(syncRate);
+    if (tolerance < 2.0f * dv)
+        tolerance = 2.0f * dv;
+    if (fabsf(static_cast<float>(_rampDeficit)) <= fabsf(syncRate) * dt + 1.0f &&
+        fabsf(_rampVelocity - syncRate) <= tolerance)
+    {
+        steps += _rampDeficit;
+        _rampDeficit = 0;
+        _rampActive = false;
+    }
+    return steps;
+}
+
+int32_t SyncTimer::interpolateSubCount(uint32_t spindlePosition, int32_t countDelta)
+{
+    using EncoderLimits = SystemConfig::Limits::Encoder;
+
+    if (!SystemConfig::RuntimeConfig::Motion::subcount_interpolation || _phaseShiftRemaining != 0 ||
+        _obsLeadCounts != 0 || _config.pitch_segment_count > 0)
+    {
+        int32_t delta = -_subCountSteps;
+        _subCountSteps = 0;
+        return delta;
+    }
+
+    int32_t fraction;
+    if (!_encoder->getSubCountFraction(spindlePosition, fraction))
+    {
+        if (countDelta == 0)
+        {
+            return 0; // Stopped between counts: hold rather than step back
+        }
+        fraction = 0;
+    }
+    if (_config.reverse_direction)
+    {
+        fraction = -fraction;
+    }
+
+    // Step position `fraction` of a count on from the current phase, floored (fraction may be negative).
+    int64_t numerator = static_cast<int64_t>(_stepsPerCountWhole) * _ratioDenominator + _stepsPerCountRemainder;
+    int64_t scaled = static_cast<int64_t>(_stepAccumulator) * EncoderLimits::SUBCOUNT_SCALE + static_cast<int64_t>(fraction) * numerator;
+    int64_t den = static_cast<int64_t>(_ratioDenominator) * EncoderLimits::SUBCOUNT_SCALE;
+    int64_t target = scaled / den;
+    if (scaled % den != 0 && scaled < 0)
+    {
+        target--;
+    }
+
+    int32_t delta = static_cast<int32_t>(target) - _subCountSteps;
+    _subCountSteps = static_cast<int32_t>(target);
+    return delta;
+}
+
+uint32_t SyncTimer::countsToNextStep(int32_t accumulator, bool stepForward) const
+{
+    if (_stepsPerCountWhole > 0)
+    {
+        return 1; // Every count yields at least one step
+    }
+    if (_stepsPerCountRemainder == 0)
+    {
+        return 0; // Zero ratio
+    }
+    if (stepForward)
+    {
+        // Smallest k with accumulator + k * rem >= den
+        uint32_t needed = static_cast<uint32_t>(_ratioDenominator - accumulator);
+        uint32_t rem = static_cast<uint32_t>(_stepsPerCountRemainder);
+        return (needed + rem - 1) / rem;
+    }
+    // Smallest k with accumulator - k * rem < 0
+    return static_cast<uint32_t>(accumulator) / static_cast<uint32_t>(_stepsPerCountRemainder) + 1;
+}
+
+bool SyncTimer::armNextStepBoundaries()
+{
+    uint32_t forwardCounts = countsToNextStep(_stepAccumulator, true);
+    uint32_t backwardCounts = countsToNextStep(_stepAccumulator, false);
+    if (forwardCounts == 0 || backwardCounts == 0)
+    {
+        _encoder->disarmStepBoundaries();
+        return true;
+    }
+
+    // With reverse_direction, step-forward counts are the ones that make the counter go down.
+    uint32_t upCounts = _config.reverse_direction ? backwardCounts : forwardCounts;
+    uint32_t downCounts = _config.reverse_direction ? forwardCounts : backwardCounts;
+    uint32_t upBoundary = _previousSpindlePosition + upCounts;
+    uint32_t downBoundary = _previousSpindlePosition - downCounts;
+    _encoder->armStepBoundaries(upBoundary, downBoundary);
+
+    // A compare only fires on equality, so a boundary already passed would never be reported.
+    uint32_t now = _encoder->getRawCounter();
+    return static_cast<int32_t>(now - upBoundary) < 0 && static_cast<int32_t>(downBoundary - now) < 0;
+}
+
+void SyncTimer::handleStepBoundary()
+{
+    if (_engagePending)
+    {
+        handleEngageCompare();
+        return;
+    }
+    if (!_enabled || !_encoder || !_stepper || _config.mode != Mode::EDGE_TRIGGERED)
+    {
+        return;
+    }
+
+    _debug_interrupt_count++;
+
+    _stepper->updatePositionFromHardware();
+    recordFollowingError(_commandedPosition - _stepper->getCurrentPosition());
+
+    int32_t stepsToMove = 0;
+    do
+    {
+        uint32_t spindlePosition = _encoder->getRawCounter();
+        int32_t delta_encoder = static_cast<int32_t>(spindlePosition - _previousSpindlePosition);
+        delta_encoder -= absorbPhaseShift(delta_encoder);
+        if (_config.reverse_direction)
+        {
+            delta_encoder = -delta_encoder;
+        }
+        stepsToMove += advanceGearing(delta_encoder);
+        _debug_isr_previous_pos = _previousSpindlePosition;
+        _previousSpindlePosition = spindlePosition;
+        _debug_isr_spindle_pos = spindlePosition;
+        applyPendingConfig(); // Boundaries are armed for the ratio in effect from here on
+    } while (!armNextStepBoundaries());
+
+    uint32_t nowUs = micros();
+    uint32_t elapsedUs = nowUs - _lastBoundaryMicros;
+    _lastBoundaryMicros = nowUs;
+
+    _debug_last_steps = stepsToMove;
+    if (stepsToMove != 0)
+    {
+        // Emit the burst in a fraction of the time the spindle took to reach this boundary,
+        // so it is finished before the next one is due.
+        float speedHz = static_cast<float>(SystemConfig::Limits::Motion::MAX_EDGE_SYNC_STEP_HZ);
+        if (elapsedUs > 0)
+        {
+            speedHz = static_cast<float>(std::abs(stepsToMove)) * 1000000.0f * EDGE_SYNC_RATE_MARGIN / static_cast<float>(elapsedUs);
+        }
+        if (speedHz < 10.0f)
+            speedHz = 10.0f;
+        if (speedHz > SystemConfig::Limits::Motion::MAX_EDGE_SYNC_STEP_HZ)
+            speedHz = SystemConfig::Limits::Motion::MAX_EDGE_SYNC_STEP_HZ;
+
+        _stepper->setSpeedHz(speedHz);
+        _stepper->setRelativePosition(stepsToMove);
+    }
+
+    _lastUpdateTime = HAL_GetTick();
+    _stepper->ISR();
+}
+
+bool SyncTimer::stepDirectionFor(bool encoderCountingDown) const
+{
+    bool forward = !encoderCountingDown;
+    return _config.reverse_direction ? !forward : forward;
+}
+
+bool SyncTimer::startHardwareGearing()
+{
+    _hwCountingDown = _encoder->isCountingDown();
+    if (!_stepper->startExternalGearing(stepDirectionFor(_hwCountingDown),
+                                        _config.chain_triggers_per_step,
+                                        _config.chain_steps_per_trigger,
+                                        _config.chain_burst_freq))
+    {
+        return false;
+    }
+
+    _hwOriginCount = _encoder->getRawCounter();
+    _hwOriginSteps = _stepper->getCurrentPosition();
+    _previousSpindlePosition = _hwOriginCount;
+    // A line edge falls anywhere within QUADRATURE_MULT counts of the count-exact step position,
+    // and the supervisor may sample mid-burst, so allow two triggers' worth of steps plus margin.
+    _hwErrorToleranceSteps = static_cast<int32_t>(2 * _config.chain_steps_per_trigger) +
+                             SystemConfig::Limits::Motion::HARDWARE_GEARING_ERROR_MARGIN_STEPS;
+    return true;
+}
+
+bool SyncTimer::startCompareDmaGearing()
+{
+    // One rising and one falling compare per step need at least two counts per step.
+    if (_stepsPerCountWhole != 0 || _stepsPerCountRemainder == 0 ||
+        2 * _stepsPerCountRemainder > _ratioDenominator)
+    {
+        return false;
+    }
+
+    // Steps only ever go forward; a reversal shows up as phase error and falls back.
+    if (!_stepper->startExternalGearing(true, 1, 1, _config.chain_burst_freq))
+    {
+        return false;
+    }
+
+    __disable_irq();
+    _hwOriginCount = _encoder->getRawCounter();
+    _hwOriginSteps = _stepper->getCurrentPosition();
+    _previousSpindlePosition = _hwOriginCount;
+    _compareStepCount = _hwOriginCount;
+    _compareAccumulator = 0;
+    _comparePendingFall = false;
+    bool started = _encoder->startCompareTable(_compareTable, COMPARE_TABLE_LENGTH,
+                                               [this](uint32_t *entries, uint32_t count)
+                                               { this->fillCompareTable(entries, count); });
+    if (started)
+    {
+        // A compare only fires on equality, so the live counter must still be short of the
+        // pending compare or the table would stall. Read the counter first: a match in between
+        // only moves the compare further ahead.
+        uint32_t now = _encoder->getRawCounter();
+        int32_t ahead = static_cast<int32_t>(_encoder->getActiveCompare() - now);
+        if (_config.reverse_direction)
+        {
+            ahead = -ahead;
+        }
+        started = ahead > 0;
+    }
+    __enable_irq();
+
+    if (!started)
+    {
+        stopHardwareGearing();
+        return false;
+    }
+    // Steps are count-exact; only TIM1's pulse latency and the sampling instant separate
+    // the demanded and delivered positions.
+    _hwErrorToleranceSteps = 1 + SystemConfig::Limits::Motion::HARDWARE_GEARING_ERROR_MARGIN_STEPS;
+    return true;
+}
+
+void SyncTimer::fillCompareTable(uint32_t *entries, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (_comparePendingFall)
+        {
+            entries[i] = _config.reverse_direction ? _compareStepCount - 1 : _compareStepCount + 1;
+            _comparePendingFall = false;
+            continue;
+        }
+
+        // whole == 0 here, so each step costs exactly one division
+        uint32_t counts = countsToNextStep(_compareAccumulator, true);
+        _compareAccumulator += static_cast<int32_t>(counts) * _stepsPerCountRemainder - _ratioDenominator;
+        _compareStepCount = _config.reverse_direction ? _compareStepCount - counts : _compareStepCount + counts;
+        entries[i] = _compareStepCount;
+        _comparePendingFall = true;
+    }
+}
+
+void SyncTimer::stopHardwareGearing()
+{
+    _encoder->stopCompareTable();
+    _stepper->stopExternalGearing();
+}
+
+void SyncTimer::superviseHardwareGearing()
+{
+    _debug_interrupt_count++;
+
+    uint32_t spindlePosition = _encoder->getRawCounter();
+    bool countingDown = _encoder->isCountingDown();
+    if (_config.mode == Mode::HARDWARE_GEARING && countingDown != _hwCountingDown)
+    {
+        _hwCountingDown = countingDown;
+        _stepper->setExternalGearingDirection(stepDirectionFor(countingDown));
+    }
+
+    // Exact demanded position since engagement (a 64-bit divide at the supervisor rate only)
+    int32_t countDelta = static_cast<int32_t>(spindlePosition - _hwOriginCount);
+    if (_config.reverse_direction)
+    {
+        countDelta = -countDelta;
+    }
+    int64_t scaled = static_cast<int64_t>(countDelta) * _config.ratio_numerator;
+    int64_t den = static_cast<int64_t>(_config.ratio_denominator);
+    int64_t demanded = scaled / den;
+    if (scaled % den != 0 && scaled < 0)
+    {
+        demanded--; // floor
+    }
+
+    _stepper->updatePositionFromHardware();
+    int32_t delivered = _stepper->getCurrentPosition() - _hwOriginSteps;
+    int32_t error = static_cast<int32_t>(demanded - delivered);
+    _debug_last_steps = error;
+    _debug_isr_spindle_pos = spindlePosition;
+    recordFollowingError(error);
+
+    if (error > _hwErrorToleranceSteps || error < -_hwErrorToleranceSteps || _stepper->getTakeUpRemaining() != 0)
+    {
+        // Encoder dither around a line edge, an over-speed burst or a reversal under
+        // COMPARE_DMA cost us phase, or a reversal left backlash the trigger chain cannot inject.
+        // Hand over to the count-exact software path and let it make up the difference.
+        stopHardwareGearing();
+        _config.mode = Mode::PERIODIC;
+        _stepAccumulator = static_cast<int32_t>(scaled - demanded * den);
+        _commandedPosition = _hwOriginSteps + static_cast<int32_t>(demanded);
+        _previousSpindlePosition = spindlePosition;
+        float speedHz = static_cast<float>(std::abs(error)) * static_cast<float>(_config.update_freq);
+        _stepper->setSpeedHz(speedHz < 10.0f ? 10.0f : speedHz);
+        _stepper->setRelativePosition(error);
+        _hardwareGearingFallbacks++;
+        setSyncFrequency(_config.update_freq);
+        resetObserver(spindlePosition);
+        _obsRunning = true;
+    }
+
+    _lastUpdateTime = HAL_GetTick();
+}
+
+bool SyncTimer::startNco()
+{
+    if (!_stepper->startNco(true))
+    {
+        return false;
+    }
+    _hwOriginSteps = _stepper->getCurrentPosition();
+    _ncoDemandedSteps = 0;
+    _ncoVelocity = 0.0f;
+    return true;
+}
+
+void SyncTimer::updateNco()
+{
+    using MotionLimits = SystemConfig::Limits::Motion;
+
+    _debug_interrupt_count++;
+
+    uint32_t spindlePosition = _encoder->getRawCounter();
+    int32_t rawDelta = static_cast<int32_t>(spindlePosition - _previousSpindlePosition);
+    int32_t delta_encoder = rawDelta;
+    _observer.update(delta_encoder);
+    delta_encoder -= absorbPhaseShift(delta_encoder);
+    if (_config.reverse_direction)
+    {
+        delta_encoder = -delta_encoder;
+    }
+    _debug_isr_previous_pos = _previousSpindlePosition;
+    _debug_isr_spindle_pos = spindlePosition;
+    _previousSpindlePosition = spindlePosition;
+
+    // Exact position reference; the float path below only shapes the rate.
+    int32_t dueSteps = advanceGearing(delta_encoder);
+    applyPendingConfig();
+    dueSteps += interpolateSubCount(spindlePosition, rawDelta);
+    _ncoDemandedSteps += brakeSteps(rampSteps(dueSteps));
+
+    // Feed-forward: a few counts per tick are heavily quantised, so take the observer's velocity
+    // (or the ramp's or the brake's, while one of those is shaping the output).
+    _ncoVelocity = _braking ? _brakeVelocity * static_cast<float>(_brakeDirection) : _rampActive ? _rampVelocity : observerStepRate();
+
+    _stepper->updatePositionFromHardware();
+    int32_t error = _ncoDemandedSteps - (_stepper->getCurrentPosition() - _hwOriginSteps);
+    _debug_last_steps = error;
+    recordFollowingError(error);
+
+    float command = _ncoVelocity + MotionLimits::NCO_PHASE_GAIN * static_cast<float>(error);
+    bool direction = command >= 0.0f;
+    float rate = fabsf(command);
+    if (rate > static_cast<float>(MotionLimits::NCO_MAX_STEP_HZ))
+        rate = static_cast<float>(MotionLimits::NCO_MAX_STEP_HZ);
+
+    if (rate < MotionLimits::NCO_MIN_STEP_HZ)
+    {
+        _stepper->setNcoFrequency(0.0f);
+    }
+    else if (_stepper->setNcoDirection(direction))
+    {
+        _stepper->setNcoFrequency(rate);
+    }
+    // else: parked and waiting for the current period to end before DIR flips
+
+    _lastUpdateTime = HAL_GetTick();
+    superviseStop();
 }
 
 void SyncTimer::printDebugInfo()
@@ -278,12 +1526,19 @@ void SyncTimer::printDebugInfo()
         SerialDebug.print("ISR Previous: ");
         SerialDebug.println(_debug_isr_previous_pos);
         SerialDebug.print("Accumulator: ");
-        SerialDebug.print((long)_desiredSteps_scaled_accumulated); // Cast for printing
-        SerialDebug.println();
-        SerialDebug.print("Config Scaled: ");
-        SerialDebug.println(_config.steps_per_encoder_tick_scaled);
+        SerialDebug.println(_stepAccumulator);
+        SerialDebug.print("Ratio: ");
+        SerialDebug.print(_config.ratio_numerator);
+        SerialDebug.print("/");
+        SerialDebug.println(_config.ratio_denominator);
         SerialDebug.print("Reverse: ");
         SerialDebug.println(_config.reverse_direction);
+        SerialDebug.print("Mode: ");
+        SerialDebug.println(_config.mode == Mode::EDGE_TRIGGERED     ? "EDGE"
+                            : _config.mode == Mode::HARDWARE_GEARING ? "HARDWARE"
+                            : _config.mode == Mode::COMPARE_DMA      ? "COMPARE_DMA"
+                            : _config.mode == Mode::NCO              ? "NCO"
+                                                                     : "PERIODIC");
         SerialDebug.println("-----------------------");
     }
 }
@@ -3,6 +3,7 @@
 #include "Config/serial_debug.h"
 #include "UI/HmiHandlers/ThreadingPageHandler.h" // For getSelectedPitchData
 #include <math.h>                                // For fabs
+#include <string.h>                              // For memcpy
 
 ThreadingMode::ThreadingMode()
     : _motionControl(nullptr),
@@ -15,7 +16,19 @@ ThreadingMode::ThreadingMode()
       _ui_autoStopEnabled(false),
       _ui_targetStopAbsoluteSteps(0),
       _ui_targetStopIsSet(false),
-      _autoStopCompletionPendingHmiSignal(false)
+      _autoStopCompletionPendingHmiSignal(false),
+      _pitchTableSize(0),
+      _ui_progressiveEnabled(false),
+      _ui_progressiveEndPitchMm(0.0f),
+      _ui_progressiveLengthMm(0.0f),
+      _indexEngagePhaseCounts(0),
+      _currentStart(0),
+      _cycleState(CycleState::IDLE),
+      _cycleStartSteps(0),
+      _cyclePasses(0),
+      _cycleStopMs(0),
+      _cycleFinishing(false),
+      _cycleSpringPassesLeft(0)
 {
     // Initialize thread data to defaults
     _threadData.pitch = 1.0f; // Default to 1mm pitch
@@ -76,6 +89,14 @@ void ThreadingMode::end()
 
 void ThreadingMode::setThreadData(const ThreadData &thread_data)
 {
+    if (thread_data.pitch != _threadData.pitch || thread_data.starts != _threadData.starts || thread_data.units != _threadData.units)
+    {
+        _currentStart = 0; // A different thread starts over at its first start
+        if (_motionControl)
+        {
+            _motionControl->releaseThreadLock();
+        }
+    }
     _threadData = thread_data;
     _threadData.valid = true; // Assume data being set is intended to be valid
 
@@ -85,6 +106,11 @@ void ThreadingMode::setThreadData(const ThreadData &thread_data)
     SerialDebug.print("Starts: ");
     SerialDebug.println(_threadData.starts);
 
+    if (_ui_progressiveEnabled)
+    {
+        applyUiProgressivePitch(); // The ramp starts from the new lead (and reconfigures if running)
+        return;
+    }
     // If running, reconfigure motion control with new thread data
     if (_running)
     {
@@ -100,6 +126,161 @@ void ThreadingMode::setPositions(const Position &positions)
     SerialDebug.println("ThreadingMode: Positions set.");
 }
 
+void ThreadingMode::setProgressivePitch(float start_pitch_mm, float end_pitch_mm, float length_mm)
+{
+    MotionControl::PitchPoint points[2] = {{0.0f, start_pitch_mm}, {length_mm, end_pitch_mm}};
+    setPitchTable(points, 2);
+}
+
+bool ThreadingMode::setPitchTable(const MotionControl::PitchPoint *points, uint8_t count)
+{
+    if (!points || count < 2 || count > SystemConfig::Limits::Motion::MAX_PITCH_PROFILE_POINTS)
+    {
+        SerialDebug.println("ThreadingMode: Pitch table rejected (size).");
+        return false;
+    }
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if (points[i].pitch_mm <= 0.0f || (i > 0 && points[i].z_mm <= points[i - 1].z_mm))
+        {
+            SerialDebug.println("ThreadingMode: Pitch table rejected (pitch <= 0 or Z not increasing).");
+            return false;
+        }
+    }
+
+    memcpy(_pitchTable, points, count * sizeof(MotionControl::PitchPoint));
+    _pitchTableSize = count;
+    SerialDebug.print("ThreadingMode: Variable pitch set, points: ");
+    SerialDebug.println(count);
+
+    if (_running)
+    {
+        configureThreading();
+    }
+    return true;
+}
+
+void ThreadingMode::setUiProgressivePitchEnabled(bool enabled)
+{
+    _ui_progressiveEnabled = enabled;
+    if (enabled)
+    {
+        applyUiProgressivePitch();
+    }
+    else
+    {
+        clearVariablePitch();
+    }
+}
+
+void ThreadingMode::setUiProgressiveEndPitchFromString(const char *valueStr)
+{
+    _ui_progressiveEndPitchMm = fabsf(static_cast<float>(atof(valueStr)));
+    if (_ui_progressiveEnabled)
+    {
+        applyUiProgressivePitch();
+    }
+}
+
+void ThreadingMode::setUiProgressiveLengthFromString(const char *valueStr)
+{
+    _ui_progressiveLengthMm = fabsf(static_cast<float>(atof(valueStr)));
+    if (_ui_progressiveEnabled)
+    {
+        applyUiProgressivePitch();
+    }
+}
+
+void ThreadingMode::applyUiProgressivePitch()
+{
+    float startPitchMm = getEffectivePitch();
+    if (startPitchMm <= 0.0f || _ui_progressiveEndPitchMm <= 0.0f || _ui_progressiveLengthMm <= 0.0f)
+    {
+        SerialDebug.println("ThreadingMode: Progressive pitch needs an end lead and a length; using constant pitch.");
+        clearVariablePitch();
+        return;
+    }
+    setProgressivePitch(startPitchMm, _ui_progressiveEndPitchMm, _ui_progressiveLengthMm);
+}
+
+String ThreadingMode::getFormattedUiProgressivePitch() const
+{
+    if (!_ui_progressiveEnabled || !isVariablePitch())
+    {
+        return String("OFF");
+    }
+    char buffer[SystemConfig::HmiParameters::MAX_HMI_STRING_LENGTH];
+    snprintf(buffer, sizeof(buffer), "%.3f>%.3f/%.0f", getEffectivePitch(), _ui_progressiveEndPitchMm, _ui_progressiveLengthMm);
+    return String(buffer);
+}
+
+void ThreadingMode::setIndexEngagePhase(uint32_t counts)
+{
+    _indexEngagePhaseCounts = counts;
+}
+
+uint32_t ThreadingMode::startPhaseCounts(uint8_t start, uint32_t countsPerRev) const
+{
+    uint8_t starts = _threadData.starts > 0 ? _threadData.starts : 1;
+    return static_cast<uint32_t>(static_cast<uint64_t>(start) * countsPerRev / starts);
+}
+
+bool ThreadingMode::indexToNextStart()
+{
+    uint8_t starts = _threadData.starts;
+    if (!_motionControl || starts <= 1)
+    {
+        return false;
+    }
+
+    uint32_t countsPerRev;
+    if (!_motionControl->getCountsPerSpindleRevolution(countsPerRev) || countsPerRev % starts != 0)
+    {
+        SerialDebug.println("ThreadingMode: Warning - counts per spindle rev not divisible by starts; start spacing rounded.");
+    }
+
+    // Shift by the difference of the (rounded) start phases, so a full cycle of starts is exactly one revolution.
+    uint8_t next = (_currentStart + 1) % starts;
+    uint32_t from = startPhaseCounts(_currentStart, countsPerRev);
+    uint32_t to = (next == 0) ? countsPerRev : startPhaseCounts(next, countsPerRev);
+    if ((_motionControl->isElsActive() || _motionControl->hasThreadLock()) && !_motionControl->shiftSpindlePhase(to - from))
+    {
+        SerialDebug.println("ThreadingMode: Cannot shift phase in this sync mode; stop and restart to index.");
+        return false;
+    }
+    // When idle without a thread lock, the next index-locked start() picks up the new start's phase.
+    if (!_motionControl->isElsActive() && !_motionControl->hasThreadLock() && !SystemConfig::RuntimeConfig::Motion::index_engage)
+    {
+        SerialDebug.println("ThreadingMode: Index engage is off; only the first start can be started.");
+    }
+
+    _currentStart = next;
+    SerialDebug.print("ThreadingMode: Now cutting start ");
+    SerialDebug.print(_currentStart + 1);
+    SerialDebug.print("/");
+    SerialDebug.println(starts);
+    return true;
+}
+
+void ThreadingMode::startNewThread()
+{
+    if (_motionControl)
+    {
+        _motionControl->releaseThreadLock();
+    }
+    _currentStart = 0;
+    SerialDebug.println("ThreadingMode: Thread lock released; next start begins a new thread.");
+}
+
+void ThreadingMode::clearVariablePitch()
+{
+    _pitchTableSize = 0;
+    if (_running)
+    {
+        configureThreading();
+    }
+}
+
 void ThreadingMode::enableMultiStart(bool enable)
 {
     // This function might be deprecated if starts are part of ThreadData
@@ -147,11 +328,39 @@ void ThreadingMode::start()
 
     configureThreading();
     _motionControl->setMode(MotionControl::Mode::THREADING); // Ensure correct ELS mode
-    _motionControl->startMotion();                           // Or a specific start for threading if different
+    if (!engageInGroove())
+    {
+        if (_currentStart != 0)
+        {
+            // An unlocked start has no spindle phase, so it would cut the first start instead.
+            handleError("Selected start needs an index-locked engage");
+            return;
+        }
+        if (SystemConfig::RuntimeConfig::Motion::index_engage)
+        {
+            SerialDebug.println("ThreadingMode: Index engage not possible, starting unlocked.");
+        }
+        _motionControl->startMotion();
+    }
     _running = true;
     _error = false;
 }
 
+bool ThreadingMode::engageInGroove()
+{
+    // Re-cutting the same thread: the previous pass left the exact spindle/carriage relation.
+    if (_motionControl->hasThreadLock() && _motionControl->startMotionLocked())
+    {
+        SerialDebug.println("ThreadingMode: Re-engaging in the previous pass's groove.");
+        return true;
+    }
+    // Otherwise lock the pass to the spindle index so every pass lands in the same groove.
+    uint32_t countsPerRev;
+    _motionControl->getCountsPerSpindleRevolution(countsPerRev);
+    uint32_t engagePhase = _indexEngagePhaseCounts + startPhaseCounts(_currentStart, countsPerRev);
+    return SystemConfig::RuntimeConfig::Motion::index_engage && _motionControl->startMotionAtIndex(engagePhase);
+}
+
 void ThreadingMode::stop()
 {
     if (!_motionControl)
@@ -160,18 +369,19 @@ void ThreadingMode::stop()
         return;
     }
     SerialDebug.println("ThreadingMode: Stopping...");
+    cycleAbort();
     _motionControl->stopMotion(); // Or a specific stop for threading
     _running = false;
 }
 
 void ThreadingMode::update()
 {
-    if (!_running || !_motionControl)
+    if (!_motionControl)
     {
         return;
     }
-    // Threading mode might have specific update logic, e.g., checking for end of thread pass
-    // For now, main ELS sync is handled by MotionControl's ISR via SyncTimer
+    // Main ELS sync is handled by MotionControl's ISR via SyncTimer; the cycle runs between passes too
+    updateCycle();
 
     // Check for auto-stop completion
     checkAndHandleAutoStopCompletion();
@@ -346,6 +556,17 @@ void ThreadingMode::configureThreading()
         // MotionControl interprets positive pitch as AWAY_FROM_CHUCK
         mcCfg.thread_pitch = effectivePitchValue;
     }
+    // Let the gearing use the exact TPI rather than the rounded mm conversion
+    mcCfg.thread_tpi = (_threadData.units == Units::IMPERIAL) ? _threadData.pitch : 0.0f;
+
+    if (isVariablePitch())
+    {
+        // The profile replaces the constant pitch; thread_pitch only carries the direction.
+        mcCfg.thread_pitch = m_feedDirectionIsTowardsChuck ? -_pitchTable[0].pitch_mm : _pitchTable[0].pitch_mm;
+        mcCfg.thread_tpi = 0.0f;
+        mcCfg.pitch_table = _pitchTable;
+        mcCfg.pitch_table_size = _pitchTableSize;
+    }
 
     _motionControl->setConfig(mcCfg); // This will apply the pitch and its sign
 
@@ -387,6 +608,7 @@ void ThreadingMode::handleError(const char *msg)
     _errorMsg = msg;
     SerialDebug.print("ThreadingMode ERROR: ");
     SerialDebug.println(msg);
+    cycleAbort();
     // Potentially stop motion or enter a safe state
     if (_motionControl && _running)
     {
@@ -399,6 +621,7 @@ void ThreadingMode::handleError(const char *msg)
 
 void ThreadingMode::resetAutoStopRuntimeSettings()
 {
+    cycleAbort();
     _ui_autoStopEnabled = false;
     _ui_targetStopIsSet = false;
     _ui_targetStopAbsoluteSteps = 0;
@@ -414,6 +637,7 @@ void ThreadingMode::setUiAutoStopEnabled(bool enabled)
     _ui_autoStopEnabled = enabled;
     if (!_ui_autoStopEnabled)
     {
+        cycleAbort(); // The cycle has no end without a target
         // If disabling, also clear any set target in MC and UI
         _ui_targetStopIsSet = false;
         _ui_targetStopAbsoluteSteps = 0;
@@ -426,7 +650,7 @@ void ThreadingMode::setUiAutoStopEnabled(bool enabled)
     else
     {
         // If enabling and a target is already set in UI, re-arm it in MC
-        if (_ui_targetStopIsSet && _motionControl)
+        if (_ui_targetStopIsSet && _motionControl && _cycleState == CycleState::IDLE)
         {
             _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
         }
@@ -487,7 +711,8 @@ void ThreadingMode::setUiAutoStopTargetPositionFromString(const char *valueStr)
     SerialDebug.print(", abs target steps: ");
     SerialDebug.println(_ui_targetStopAbsoluteSteps);
 
-    if (_ui_autoStopEnabled)
+    // Between cycle passes the new target is armed when the next pass engages
+    if (_ui_autoStopEnabled && (_cycleState == CycleState::IDLE || _cycleState == CycleState::THREADING))
     {
         _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
     }
@@ -506,7 +731,7 @@ void ThreadingMode::grabCurrentZAsUiAutoStopTarget()
     SerialDebug.print("ThreadingMode: UI Auto-stop target grabbed as current Z (abs steps): ");
     SerialDebug.println(_ui_targetStopAbsoluteSteps);
 
-    if (_ui_autoStopEnabled)
+    if (_ui_autoStopEnabled && (_cycleState == CycleState::IDLE || _cycleState == CycleState::THREADING))
     {
         _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
     }
@@ -544,6 +769,10 @@ String ThreadingMode::getFormattedUiAutoStopTarget() const
 
 bool ThreadingMode::checkAndHandleAutoStopCompletion()
 {
+    if (_cycleState != CycleState::IDLE)
+    {
+        return false; // updateCycle() owns the stop and keeps the target for the next pass
+    }
     if (_motionControl && _motionControl->wasTargetStopReachedAndMotionHalted())
     {
         SerialDebug.println("ThreadingMode: Auto-stop completion detected from MotionControl.");
@@ -563,3 +792,187 @@ void ThreadingMode::clearAutoStopCompletionHmiSignal()
 {
     _autoStopCompletionPendingHmiSignal = false;
 }
+
+// --- Multi-Pass Cycle ---
+
+bool ThreadingMode::cycleStart()
+{
+    if (!_motionControl || _cycleState != CycleState::IDLE)
+    {
+        return false;
+    }
+    if (!_ui_autoStopEnabled || !_ui_targetStopIsSet)
+    {
+        SerialDebug.println("ThreadingMode::cycleStart - The cycle needs an auto-stop target.");
+        return false;
+    }
+    if (!_motionControl->isMotorEnabled())
+    {
+        SerialDebug.println("ThreadingMode::cycleStart - Motor disabled.");
+        return false;
+    }
+    int32_t currentSteps = _motionControl->getCurrentPositionSteps();
+    if (currentSteps == _ui_targetStopAbsoluteSteps)
+    {
+        SerialDebug.println("ThreadingMode::cycleStart - Already at the stop target.");
+        return false;
+    }
+
+    // Every pass starts from here, so every pass engages on the same relation
+    _cycleStartSteps = currentSteps;
+    _cyclePasses = 0;
+    _cycleFinishing = false;
+    _cycleSpringPassesLeft = 0;
+    _cycleState = CycleState::THREADING;
+
+    if (_motionControl->isElsActive())
+    {
+        _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
+    }
+    else
+    {
+        _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true, false);
+        start();
+        if (!_motionControl->isElsActive())
+        {
+            cycleAbort();
+            return false;
+        }
+    }
+
+    SerialDebug.print("ThreadingMode: cycle armed, start ");
+    SerialDebug.print(_cycleStartSteps);
+    SerialDebug.print(" -> stop ");
+    SerialDebug.println(_ui_targetStopAbsoluteSteps);
+    return true;
+}
+
+void ThreadingMode::cycleAbort()
+{
+    if (_cycleState == CycleState::IDLE)
+    {
+        return;
+    }
+    if (_cycleState == CycleState::RETURNING && _motionControl)
+    {
+        _motionControl->abortPositioning();
+    }
+    // A pass in progress keeps its auto-stop and finishes like a manual one
+    _cycleState = CycleState::IDLE;
+    _cycleFinishing = false;
+    SerialDebug.println("ThreadingMode: cycle aborted.");
+}
+
+void ThreadingMode::cycleFinish()
+{
+    if (_cycleState == CycleState::IDLE || _cycleFinishing)
+    {
+        return;
+    }
+    uint8_t springPasses = SystemConfig::RuntimeConfig::Motion::spring_passes;
+    if (springPasses > SystemConfig::Limits::Motion::MAX_SPRING_PASSES)
+    {
+        springPasses = SystemConfig::Limits::Motion::MAX_SPRING_PASSES;
+    }
+    // Pressed during a pass, that pass is at final depth; pressed on the way back, the next one is.
+    _cycleSpringPassesLeft = (_cycleState == CycleState::THREADING) ? springPasses : springPasses + 1;
+    _cycleFinishing = true;
+    SerialDebug.print("ThreadingMode: final depth, passes left after this one: ");
+    SerialDebug.println(_cycleSpringPassesLeft);
+}
+
+void ThreadingMode::updateCycle()
+{
+    if (_cycleState == CycleState::IDLE)
+    {
+        return;
+    }
+    if (!_motionControl->isMotorEnabled() || _motionControl->getStatus().error)
+    {
+        cycleAbort();
+        return;
+    }
+
+    switch (_cycleState)
+    {
+    case CycleState::THREADING:
+        if (_motionControl->wasTargetStopReachedAndMotionHalted())
+        {
+            // stopMotion() has captured the thread lock the next pass re-engages on
+            _cycleStopMs = millis();
+            _cyclePasses++;
+            _autoStopCompletionPendingHmiSignal = true;
+            _cycleState = CycleState::RETRACT;
+            SerialDebug.print("ThreadingMode: pass ");
+            SerialDebug.print(_cyclePasses);
+            SerialDebug.println(" done, waiting for the X retract.");
+        }
+        break;
+
+    case CycleState::RETRACT:
+    {
+        uint32_t delay = SystemConfig::RuntimeConfig::Motion::thread_cycle_retract_ms;
+        if (delay > SystemConfig::Limits::Motion::MAX_CYCLE_RETURN_DELAY_MS)
+        {
+            delay = SystemConfig::Limits::Motion::MAX_CYCLE_RETURN_DELAY_MS;
+        }
+        if (millis() - _cycleStopMs < delay)
+        {
+            break;
+        }
+        // The spindle keeps turning; the return is a plain planned move with the sync off
+        if (_motionControl->moveToPositionSteps(_cycleStartSteps, 0.0f, false))
+        {
+            _cycleState = CycleState::RETURNING;
+        }
+        else
+        {
+            SerialDebug.println("ThreadingMode: cycle return could not start.");
+            cycleAbort();
+        }
+        break;
+    }
+
+    case CycleState::RETURNING:
+        if (_motionControl->isPositioning())
+        {
+            break;
+        }
+        if (_motionControl->getCurrentPositionSteps() != _cycleStartSteps)
+        {
+            SerialDebug.println("ThreadingMode: cycle return ended away from the start.");
+            cycleAbort();
+            break;
+        }
+        if (_cycleFinishing)
+        {
+            if (_cycleSpringPassesLeft == 0)
+            {
+                _cycleState = CycleState::IDLE;
+                _cycleFinishing = false;
+                SerialDebug.print("ThreadingMode: cycle complete after ");
+                SerialDebug.print(_cyclePasses);
+                SerialDebug.println(" passes.");
+                break;
+            }
+            _cycleSpringPassesLeft--;
+        }
+        // The lock gives the exact encoder count at which the relation reaches the carriage again;
+        // the engagement waits for it in the compare interrupt.
+        _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true, false);
+        if (engageInGroove())
+        {
+            _cycleState = CycleState::THREADING;
+        }
+        else
+        {
+            _motionControl->clearAbsoluteTargetStop();
+            SerialDebug.println("ThreadingMode: no thread lock or index to re-engage on; cycle stopped.");
+            cycleAbort();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
@@ -10,17 +10,23 @@ TurningMode::TurningMode()
       _mode(Mode::MANUAL),
       _z_axis_zero_offset_steps(0),     // Initialize zero offset
       _feedDirectionTowardsChuck(true), // Default to Towards Chuck
+      _feedPerMinuteEnabled(false),
       _ui_autoStopEnabled(false),       // Initialize auto-stop UI state
       _ui_targetStopAbsoluteSteps(0),   // Initialize auto-stop UI target
       _ui_targetStopIsSet(false),       // Initialize auto-stop UI target set state
       _running(false),
       _error(false),
       _errorMsg(nullptr),
-      _autoStopCompletionPendingHmiSignal(false) // Initialize new flag
+      _autoStopCompletionPendingHmiSignal(false), // Initialize new flag
+      _cycleState(CycleState::IDLE),
+      _cycleStartSteps(0),
+      _cyclePassStartMs(0),
+      _cycleStopMs(0)
 {
     _positions.start_position = 0.0f;
     _positions.end_position = 0.0f;
     _positions.valid = false;
+    _cycleStats = CycleStats{0, 0, 0, 0, 0};
 }
 
 TurningMode::~TurningMode()
@@ -83,11 +89,12 @@ void TurningMode::activate()
     SerialDebug.println("TurningMode::activate() called.");
     if (_motionControl)
     {
-        _motionControl->setMode(MotionControl::Mode::TURNING);
+        _motionControl->setMode(motionMode());
         configureFeedRate(); // Ensure MotionControl gets the latest feed rate config for turning
         // Attempt to start motion. MotionControl::startMotion() has guards to prevent issues.
         _motionControl->startMotion();
-        SerialDebug.println("TurningMode: Activated. MotionControl mode set to TURNING, configured, and startMotion() called.");
+        SerialDebug.println(_feedPerMinuteEnabled ? "TurningMode: Activated. MotionControl mode set to FEEDING, configured, and startMotion() called."
+                                                  : "TurningMode: Activated. MotionControl mode set to TURNING, configured, and startMotion() called.");
     }
     else
     {
@@ -98,6 +105,7 @@ void TurningMode::activate()
 void TurningMode::deactivate()
 {
     SerialDebug.println("TurningMode::deactivate() called.");
+    cycleAbort();
     if (_motionControl)
     {
         _motionControl->stopMotion();
@@ -129,6 +137,36 @@ void TurningMode::selectPreviousFeedRate()
     }
 }
 
+void TurningMode::adjustFeedOverride(int32_t prevNextValue)
+{
+    if (!_motionControl)
+    {
+        return;
+    }
+
+    using MotionLimits = SystemConfig::Limits::Motion;
+    uint16_t percent = _motionControl->getFeedOverride();
+    if (prevNextValue == 1)
+    {
+        percent -= MotionLimits::FEED_OVERRIDE_STEP_PERCENT;
+    }
+    else if (prevNextValue == 2)
+    {
+        percent += MotionLimits::FEED_OVERRIDE_STEP_PERCENT;
+    }
+    else
+    {
+        percent = 100;
+    }
+    // Applied without stopping; MotionControl slews towards it while the cut runs.
+    _motionControl->setFeedOverride(percent);
+}
+
+uint16_t TurningMode::getFeedOverride() const
+{
+    return _motionControl ? _motionControl->getEffectiveFeedOverride() : 100;
+}
+
 void TurningMode::setFeedRateMetric(bool isMetric)
 {
     _feedRateManager.setMetric(isMetric);
@@ -157,8 +195,70 @@ FeedRateManager &TurningMode::getFeedRateManager()
 //     }
 // }
 
+MotionControl::Mode TurningMode::motionMode() const
+{
+    return _feedPerMinuteEnabled ? MotionControl::Mode::FEEDING : MotionControl::Mode::TURNING;
+}
+
+void TurningMode::setFeedPerMinuteEnabled(bool enabled)
+{
+    if (_feedPerMinuteEnabled == enabled)
+    {
+        return;
+    }
+    _feedPerMinuteEnabled = enabled;
+    SerialDebug.print("TurningMode: Feed per minute ");
+    SerialDebug.println(enabled ? "ON" : "OFF");
+    if (!_motionControl)
+    {
+        return;
+    }
+
+    // setMode() stops the current feed; the new one starts only if the motor is engaged
+    _motionControl->setMode(motionMode());
+    if (_ui_autoStopEnabled && _ui_targetStopIsSet && _cycleState == CycleState::IDLE)
+    {
+        _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true, false);
+    }
+    if (_motionControl->isMotorEnabled())
+    {
+        _motionControl->startMotion();
+    }
+}
+
+void TurningMode::setFeedPerMinuteFromString(const char *valueStr)
+{
+    if (!valueStr || !_motionControl)
+    {
+        return;
+    }
+    float value = fabsf(static_cast<float>(atof(valueStr)));
+    if (!SystemConfig::RuntimeConfig::System::measurement_unit_is_metric)
+    {
+        value *= 25.4f; // in/min to mm/min
+    }
+    _motionControl->setFeedPerMinute(value);
+    SerialDebug.print("TurningMode: Feed per minute set to ");
+    SerialDebug.print(_motionControl->getFeedPerMinute(), 1);
+    SerialDebug.println(" mm/min");
+}
+
+String TurningMode::getFormattedFeedPerMinute() const
+{
+    float mmPerMin = _motionControl ? _motionControl->getFeedPerMinute() : SystemConfig::Limits::Motion::DEFAULT_FEED_PER_MINUTE_MM;
+    if (SystemConfig::RuntimeConfig::System::measurement_unit_is_metric)
+    {
+        return String(mmPerMin, 1) + " mm/min";
+    }
+    return String(mmPerMin / 25.4f, 2) + " in/min";
+}
+
 void TurningMode::setMode(Mode mode)
 {
+    if (mode != Mode::SEMI_AUTO)
+    {
+        cycleAbort();
+    }
     _mode = mode;
 }
 
@@ -233,6 +333,12 @@ void TurningMode::stop()
 
 void TurningMode::update()
 {
+    // The cycle also runs while the feed is off (stopped, returning, waiting for re-arm)
+    updateCycle();
+
+    // The auto-stop releases the feed when it settles, so look for completion before the guard below
+    checkAndHandleAutoStopCompletion();
+
     // Use MotionControl's ELS active state for the primary guard.
     // TurningMode::_running should ideally mirror this, but let's rely on MC's state directly here.
     if (!_motionControl || !_motionControl->isElsActive())
@@ -251,8 +357,7 @@ void TurningMode::update()
         _running = true;
     }
 
-    // Update motion controller
-    _motionControl->update();
+    // MotionControl::update() itself runs from the main loop on every page.
 
     // Log current position vs target if auto-stop is active
     // Condition now also implicitly relies on _motionControl->isElsActive() via the guard above.
@@ -272,25 +377,6 @@ void TurningMode::update()
     //     // SerialDebug.print(", TargetSteps: ");
     //     // SerialDebug.println(_ui_targetStopAbsoluteSteps);
     // }
-
-    // In semi-auto mode, check if we've reached the end position
-    if (_mode == Mode::SEMI_AUTO && _positioning)
-    {
-        float currentPos = getCurrentPosition();
-        if (_positioning->hasReachedEndPosition(currentPos))
-        {
-            // SerialDebug.println("Reached end position, stopping"); // Optional log
-            stop();
-        }
-    }
-
-    // Check for auto-stop completion
-    if (checkAndHandleAutoStopCompletion())
-    {
-        // SerialDebug.println("TurningMode::update - Auto-stop completed. HMI flash needed."); // Optional log
-        // The target is cleared within checkAndHandleAutoStopCompletion if MC confirms stop.
-        // UI display should be updated by TurningPageHandler to "---" or similar.
-    }
 }
 
 float TurningMode::getCurrentPosition() const
@@ -480,6 +566,7 @@ bool TurningMode::getFeedDirectionTowardsChuck() const
 
 void TurningMode::resetAutoStopRuntimeSettings()
 {
+    cycleAbort();
     _ui_autoStopEnabled = false;
     _ui_targetStopIsSet = false;
     _ui_targetStopAbsoluteSteps = 0;
@@ -495,6 +582,7 @@ void TurningMode::setUiAutoStopEnabled(bool enabled)
     _ui_autoStopEnabled = enabled;
     if (!_ui_autoStopEnabled)
     {
+        cycleAbort(); // The cycle has no end without a target
         // If disabling, also clear any set target in MC and UI
         _ui_targetStopIsSet = false;
         _ui_targetStopAbsoluteSteps = 0;
@@ -507,7 +595,7 @@ void TurningMode::setUiAutoStopEnabled(bool enabled)
     else
     {
         // If enabling and a target is already set in UI, re-arm it in MC
-        if (_ui_targetStopIsSet && _motionControl)
+        if (_ui_targetStopIsSet && _motionControl && _cycleState == CycleState::IDLE)
         {
             _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
         }
@@ -627,7 +715,7 @@ void TurningMode::setUiAutoStopTargetPositionFromString(const char *valueStr)
     SerialDebug.print(", absSteps: ");
     SerialDebug.println(_ui_targetStopAbsoluteSteps);
 
-    if (_ui_autoStopEnabled)
+    if (_ui_autoStopEnabled && (_cycleState == CycleState::IDLE || _cycleState == CycleState::FEEDING))
     {
         _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
     }
@@ -651,7 +739,8 @@ void TurningMode::grabCurrentZAsUiAutoStopTarget()
     SerialDebug.print("TurningMode: UI Auto-stop target grabbed as current Z (abs steps): ");
     SerialDebug.println(_ui_targetStopAbsoluteSteps);
 
-    if (_ui_autoStopEnabled)
+    // Between cycle passes the new target is armed by the next cycleStart()
+    if (_ui_autoStopEnabled && (_cycleState == CycleState::IDLE || _cycleState == CycleState::FEEDING))
     {
         _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
     }
@@ -745,6 +834,10 @@ String TurningMode::getFormattedUiAutoStopTarget() const
 
 bool TurningMode::checkAndHandleAutoStopCompletion()
 {
+    if (_cycleState != CycleState::IDLE)
+    {
+        return false; // updateCycle() owns the stop and keeps the target for the next pass
+    }
     if (_motionControl && _motionControl->wasTargetStopReachedAndMotionHalted())
     {
         SerialDebug.println("TurningMode: Auto-stop completion detected from MotionControl.");
@@ -768,3 +861,158 @@ void TurningMode::clearAutoStopCompletionHmiSignal()
 {
     _autoStopCompletionPendingHmiSignal = false;
 }
+
+// --- Semi-Auto Cycle ---
+
+bool TurningMode::cycleStart()
+{
+    if (!_motionControl || _mode != Mode::SEMI_AUTO)
+    {
+        SerialDebug.println("TurningMode::cycleStart - Semi-auto mode not selected.");
+        return false;
+    }
+    if (!_ui_autoStopEnabled || !_ui_targetStopIsSet)
+    {
+        SerialDebug.println("TurningMode::cycleStart - The cycle needs an auto-stop target.");
+        return false;
+    }
+    if (!_motionControl->isMotorEnabled())
+    {
+        SerialDebug.println("TurningMode::cycleStart - Motor disabled.");
+        return false;
+    }
+    if (_cycleState != CycleState::IDLE && _cycleState != CycleState::WAITING)
+    {
+        return false; // A pass is still running
+    }
+
+    int32_t currentSteps = _motionControl->getCurrentPositionSteps();
+    if (currentSteps == _ui_targetStopAbsoluteSteps)
+    {
+        SerialDebug.println("TurningMode::cycleStart - Already at the stop target.");
+        return false;
+    }
+
+    if (_cycleState == CycleState::IDLE)
+    {
+        // First pass: wherever the carriage is now is where every pass starts
+        _cycleStartSteps = currentSteps;
+        _cycleStats = CycleStats{0, 0, 0, 0, 0};
+    }
+
+    _cycleState = CycleState::FEEDING;
+    _cyclePassStartMs = millis();
+    // Arms the ISR brake and starts the feed if it is off (always the case after a return)
+    _motionControl->configureAbsoluteTargetStop(_ui_targetStopAbsoluteSteps, true);
+
+    SerialDebug.print("TurningMode: cycle pass ");
+    SerialDebug.print(_cycleStats.passes + 1);
+    SerialDebug.print(" armed, start ");
+    SerialDebug.print(_cycleStartSteps);
+    SerialDebug.print(" -> stop ");
+    SerialDebug.println(_ui_targetStopAbsoluteSteps);
+    return true;
+}
+
+void TurningMode::cycleAbort()
+{
+    if (_cycleState == CycleState::IDLE)
+    {
+        return;
+    }
+    if (_cycleState == CycleState::RETURNING && _motionControl)
+    {
+        _motionControl->abortPositioning();
+    }
+    // A feed in progress keeps its auto-stop and finishes like a manual one
+    _cycleState = CycleState::IDLE;
+    SerialDebug.println("TurningMode: cycle aborted.");
+}
+
+void TurningMode::updateCycle()
+{
+    if (_cycleState == CycleState::IDLE || !_motionControl)
+    {
+        return;
+    }
+    if (!_motionControl->isMotorEnabled() || _motionControl->getStatus().error)
+    {
+        cycleAbort();
+        return;
+    }
+
+    switch (_cycleState)
+    {
+    case CycleState::FEEDING:
+        if (_motionControl->wasTargetStopReachedAndMotionHalted())
+        {
+            _cycleStopMs = millis();
+            _autoStopCompletionPendingHmiSignal = true;
+            _cycleState = CycleState::RETRACT;
+        }
+        break;
+
+    case CycleState::RETRACT:
+    {
+        uint32_t delay = SystemConfig::RuntimeConfig::Motion::cycle_return_delay_ms;
+        if (delay > SystemConfig::Limits::Motion::MAX_CYCLE_RETURN_DELAY_MS)
+        {
+            delay = SystemConfig::Limits::Motion::MAX_CYCLE_RETURN_DELAY_MS;
+        }
+        if (millis() - _cycleStopMs < delay)
+        {
+            break;
+        }
+        // Planned rapid at max_feed_rate; the feed stays off afterwards until the next cycleStart()
+        if (_motionControl->moveToPositionSteps(_cycleStartSteps, 0.0f, false))
+        {
+            _cycleState = CycleState::RETURNING;
+        }
+        else
+        {
+            SerialDebug.println("TurningMode: cycle return could not start.");
+            cycleAbort();
+        }
+        break;
+    }
+
+    case CycleState::RETURNING:
+        if (!_motionControl->isPositioning())
+        {
+            if (_motionControl->getCurrentPositionSteps() != _cycleStartSteps)
+            {
+                SerialDebug.println("TurningMode: cycle return ended away from the start.");
+                cycleAbort();
+                break;
+            }
+            finishCyclePass();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void TurningMode::finishCyclePass()
+{
+    uint32_t now = millis();
+    _cycleStats.passes++;
+    _cycleStats.lastFeedMs = _cycleStopMs - _cyclePassStartMs;
+    _cycleStats.lastReturnMs = now - _cycleStopMs;
+    _cycleStats.lastPassMs = now - _cyclePassStartMs;
+    _cycleStats.totalMs += _cycleStats.lastPassMs;
+    _cycleState = CycleState::WAITING;
+
+    SerialDebug.print("TurningMode: cycle pass ");
+    SerialDebug.print(_cycleStats.passes);
+    SerialDebug.print(" done. Feed ");
+    SerialDebug.print(_cycleStats.lastFeedMs);
+    SerialDebug.print(" ms, return ");
+    SerialDebug.print(_cycleStats.lastReturnMs);
+    SerialDebug.print(" ms, pass ");
+    SerialDebug.print(_cycleStats.lastPassMs);
+    SerialDebug.print(" ms, average ");
+    SerialDebug.print(_cycleStats.totalMs / _cycleStats.passes);
+    SerialDebug.println(" ms.");
+}
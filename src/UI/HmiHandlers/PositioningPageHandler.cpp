@@ -0,0 +1,192 @@
+#include "UI/HmiHandlers/PositioningPageHandler.h"
+#include "Config/Hmi/PositioningPageOptions.h"
+#include "Config/SystemConfig.h"
+#include "Config/serial_debug.h"
+#include "LumenProtocol.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Define static member variables
+Positioning *PositioningPageHandler::_positioning = nullptr;
+float PositioningPageHandler::_increment = 1.0f;
+bool PositioningPageHandler::_lastShownMoving = false;
+bool PositioningPageHandler::_lastShownTakeUp = false;
+
+const uint16_t STRING_Z_POS_ADDRESS_POSITIONING_DRO = 135;
+
+static uint32_t lastDroUpdateTimeMs_Positioning = 0;
+const uint32_t POSITIONING_DRO_UPDATE_INTERVAL = 100;
+
+void PositioningPageHandler::init(Positioning *positioning)
+{
+    _positioning = positioning;
+    SerialDebug.println("PositioningPageHandler initialized.");
+}
+
+void PositioningPageHandler::onEnterPage()
+{
+    SerialDebug.println("PositioningPageHandler: onEnterPage called.");
+    _lastShownMoving = _positioning && _positioning->isMoving();
+    _lastShownTakeUp = _lastShownMoving && _positioning->isTakingUpBacklash();
+    updateDRO();
+    sendStatusDisplay();
+    sendStartDisplay();
+}
+
+void PositioningPageHandler::onExitPage()
+{
+    // A planned move is bounded and decelerates by itself, so it is left to finish.
+    SerialDebug.println("PositioningPageHandler: onExitPage called.");
+}
+
+void PositioningPageHandler::handlePacket(const lumen_packet_t *packet)
+{
+    if (!packet || !_positioning)
+    {
+        return;
+    }
+
+    using namespace HmiPositioningPageOptions;
+
+    if (packet->address == string_goto_value_to_stm32Address && packet->type == kString)
+    {
+        _positioning->setEndPosition(atof(packet->data._string)); // Run by the "Go To" button
+    }
+    else if (packet->address == bool_gotoAddress && packet->type == kBool)
+    {
+        if (packet->data._bool) // React on button press (true)
+        {
+            if (!_positioning->goToAbsolute(_positioning->getEndPosition()))
+            {
+                SerialDebug.println("PositioningPageHandler: go-to rejected (busy).");
+            }
+        }
+    }
+    else if (packet->address == string_increment_to_stm32Address && packet->type == kString)
+    {
+        float increment = fabsf(atof(packet->data._string));
+        if (increment > 0.0f)
+        {
+            _increment = increment;
+        }
+    }
+    else if (packet->address == int_move_byAddress && (packet->type == kS32 || packet->type == kBool))
+    {
+        if (packet->data._s32 == MOVE_BY_CMD_MINUS)
+        {
+            _positioning->moveBy(-_increment);
+        }
+        else if (packet->data._s32 == MOVE_BY_CMD_PLUS)
+        {
+            _positioning->moveBy(_increment);
+        }
+    }
+    else if (packet->address == bool_set_startAddress && packet->type == kBool)
+    {
+        if (packet->data._bool)
+        {
+            _positioning->setStartHere();
+            sendStartDisplay();
+        }
+    }
+    else if (packet->address == bool_return_to_startAddress && packet->type == kBool)
+    {
+        if (packet->data._bool)
+        {
+            _positioning->returnToStart();
+        }
+    }
+    else if (packet->address == bool_stop_moveAddress && packet->type == kBool)
+    {
+        if (packet->data._bool)
+        {
+            _positioning->stopMove();
+        }
+    }
+    else if (packet->address == bool_zero_zAddress && packet->type == kBool)
+    {
+        if (packet->data._bool && !_positioning->isMoving())
+        {
+            // The start position keeps its place on the carriage
+            float zeroShift = _positioning->getCurrentPosition();
+            _positioning->setZeroPosition();
+            _positioning->setStartPosition(_positioning->getStartPosition() - zeroShift);
+            updateDRO();
+            sendStartDisplay();
+        }
+    }
+}
+
+void PositioningPageHandler::update()
+{
+    if (!_positioning)
+    {
+        return;
+    }
+
+    uint32_t currentTime = millis();
+    if (currentTime - lastDroUpdateTimeMs_Positioning >= POSITIONING_DRO_UPDATE_INTERVAL)
+    {
+        updateDRO();
+        lastDroUpdateTimeMs_Positioning = currentTime;
+    }
+
+    bool moving = _positioning->isMoving();
+    bool takingUp = moving && _positioning->isTakingUpBacklash(); // The DRO holds still meanwhile
+    if (moving != _lastShownMoving || takingUp != _lastShownTakeUp)
+    {
+        _lastShownMoving = moving;
+        _lastShownTakeUp = takingUp;
+        sendStatusDisplay();
+        if (!moving)
+        {
+            updateDRO(); // Show the exact final position at once
+        }
+    }
+}
+
+void PositioningPageHandler::updateDRO()
+{
+    if (!_positioning)
+    {
+        return;
+    }
+    char positionStr[MAX_STRING_SIZE];
+    formatPosition(_positioning->getCurrentPosition(), positionStr, sizeof(positionStr));
+    sendString(STRING_Z_POS_ADDRESS_POSITIONING_DRO, positionStr);
+}
+
+void PositioningPageHandler::sendStatusDisplay()
+{
+    sendString(HmiPositioningPageOptions::string_status_dispAddress, _lastShownTakeUp ? "TAKE-UP" : (_lastShownMoving ? "MOVING" : "READY"));
+}
+
+void PositioningPageHandler::sendStartDisplay()
+{
+    if (!_positioning)
+    {
+        return;
+    }
+    char startStr[MAX_STRING_SIZE];
+    formatPosition(_positioning->getStartPosition(), startStr, sizeof(startStr));
+    sendString(HmiPositioningPageOptions::string_start_dispAddress, startStr);
+}
+
+void PositioningPageHandler::sendString(uint16_t address, const char *text)
+{
+    lumen_packet_t packet;
+    packet.address = address;
+    packet.type = kString;
+    strncpy(packet.data._string, text, MAX_STRING_SIZE - 1);
+    packet.data._string[MAX_STRING_SIZE - 1] = '\0';
+    lumen_write_packet(&packet);
+}
+
+void PositioningPageHandler::formatPosition(float position, char *buffer, size_t size)
+{
+    const char *units = SystemConfig::RuntimeConfig::System::measurement_unit_is_metric ? " mm" : " in";
+    snprintf(buffer, size - strlen(units), "%.3f", position);
+    strncat(buffer, units, size - strlen(buffer) - 1);
+}
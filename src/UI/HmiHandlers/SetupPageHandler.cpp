@@ -256,6 +256,30 @@ void SetupPageHandler::onEnterPage()
     packet.type = kBool;
     packet.data._bool = (SystemConfig::RuntimeConfig::Z_Axis::leadscrew_standard_is_metric == false); // 0=Metric, 1=Imperial
     lumen_write_packet(&packet);
+
+    // 16. Edge-Triggered Sync (ADDR_EDGE_TRIGGERED_SYNC_TOGGLE)
+    packet.address = HmiSetupPageOptions::ADDR_EDGE_TRIGGERED_SYNC_TOGGLE;
+    packet.type = kBool;
+    packet.data._bool = SystemConfig::RuntimeConfig::Motion::edge_triggered_sync;
+    lumen_write_packet(&packet);
+
+    // 17. Hardware Gearing (ADDR_HARDWARE_GEARING_TOGGLE)
+    packet.address = HmiSetupPageOptions::ADDR_HARDWARE_GEARING_TOGGLE;
+    packet.type = kBool;
+    packet.data._bool = SystemConfig::RuntimeConfig::Motion::hardware_gearing;
+    lumen_write_packet(&packet);
+
+    // 18. Compare DMA Sync (ADDR_COMPARE_DMA_SYNC_TOGGLE)
+    packet.address = HmiSetupPageOptions::ADDR_COMPARE_DMA_SYNC_TOGGLE;
+    packet.type = kBool;
+    packet.data._bool = SystemConfig::RuntimeConfig::Motion::compare_dma_sync;
+    lumen_write_packet(&packet);
+
+    // 19. NCO Sync (ADDR_NCO_SYNC_TOGGLE)
+    packet.address = HmiSetupPageOptions::ADDR_NCO_SYNC_TOGGLE;
+    packet.type = kBool;
+    packet.data._bool = SystemConfig::RuntimeConfig::Motion::nco_sync;
+    lumen_write_packet(&packet);
 }
 
 void SetupPageHandler::handlePacket(const lumen_packet_t *packet)
@@ -631,6 +655,47 @@ void SetupPageHandler::handlePacket(const lumen_packet_t *packet)
             SerialDebug.println(hmiDisplayStringBuffer);
         }
     }
+    // --- Column 4: Sync modes ---
+    else if (packet->address == HmiSetupPageOptions::ADDR_EDGE_TRIGGERED_SYNC_TOGGLE)
+    {
+        if (SystemConfig::RuntimeConfig::Motion::edge_triggered_sync != packet->data._bool)
+        {
+            SystemConfig::RuntimeConfig::Motion::edge_triggered_sync = packet->data._bool;
+            SystemConfig::RuntimeConfigDirtyFlags::Motion::sync_modes = true;
+            SerialDebug.print("SetupHandler: Edge-Triggered Sync set to: ");
+            SerialDebug.println(SystemConfig::RuntimeConfig::Motion::edge_triggered_sync);
+        }
+    }
+    else if (packet->address == HmiSetupPageOptions::ADDR_HARDWARE_GEARING_TOGGLE)
+    {
+        if (SystemConfig::RuntimeConfig::Motion::hardware_gearing != packet->data._bool)
+        {
+            SystemConfig::RuntimeConfig::Motion::hardware_gearing = packet->data._bool;
+            SystemConfig::RuntimeConfigDirtyFlags::Motion::sync_modes = true;
+            SerialDebug.print("SetupHandler: Hardware Gearing set to: ");
+            SerialDebug.println(SystemConfig::RuntimeConfig::Motion::hardware_gearing);
+        }
+    }
+    else if (packet->address == HmiSetupPageOptions::ADDR_COMPARE_DMA_SYNC_TOGGLE)
+    {
+        if (SystemConfig::RuntimeConfig::Motion::compare_dma_sync != packet->data._bool)
+        {
+            SystemConfig::RuntimeConfig::Motion::compare_dma_sync = packet->data._bool;
+            SystemConfig::RuntimeConfigDirtyFlags::Motion::sync_modes = true;
+            SerialDebug.print("SetupHandler: Compare DMA Sync set to: ");
+            SerialDebug.println(SystemConfig::RuntimeConfig::Motion::compare_dma_sync);
+        }
+    }
+    else if (packet->address == HmiSetupPageOptions::ADDR_NCO_SYNC_TOGGLE)
+    {
+        if (SystemConfig::RuntimeConfig::Motion::nco_sync != packet->data._bool)
+        {
+            SystemConfig::RuntimeConfig::Motion::nco_sync = packet->data._bool;
+            SystemConfig::RuntimeConfigDirtyFlags::Motion::sync_modes = true;
+            SerialDebug.print("SetupHandler: NCO Sync set to: ");
+            SerialDebug.println(SystemConfig::RuntimeConfig::Motion::nco_sync);
+        }
+    }
     // --- Action Buttons ---
     else if (packet->address == HmiSetupPageOptions::ADDR_SAVE_ALL_PARAMS_PULSE)
     {
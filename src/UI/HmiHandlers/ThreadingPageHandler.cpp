@@ -39,6 +39,11 @@ const uint16_t STRING_Z_POS_ADDRESS_THREADING_DRO = 135;
 // Define DRO update interval
 const uint32_t HANDLER_DRO_UPDATE_INTERVAL_THREADING = 100; // Milliseconds
 
+// Last cycle state sent to the HMI
+static ThreadingMode::CycleState lastShownCycleState_Threading = ThreadingMode::CycleState::IDLE;
+static uint32_t lastShownCyclePasses_Threading = 0;
+static uint8_t lastShownSpringPassesLeft_Threading = 0;
+
 void ThreadingPageHandler::init(DisplayComm *displayComm, ThreadingMode *threadingMode, MotionControl *motionControl) // Added motionControl
 {
     _displayComm = displayComm;
@@ -76,6 +81,10 @@ void ThreadingPageHandler::onEnterPage()
         _threadingMode->resetAutoStopRuntimeSettings();
         updateAutoStopTargetDisplay();
         _threadingMode->activate();
+        updateStartDisplay();
+        updateCycleDisplay();
+        updateSpringPassesDisplay();
+        updateProgressivePitchDisplay();
     }
     SerialDebug.print("ThreadingPageHandler: Entered Page. Current category: ");
     if (_currentCategoryIndex < HmiThreadingPageOptions::NUM_THREAD_CATEGORIES)
@@ -199,6 +208,86 @@ void ThreadingPageHandler::handlePacket(const lumen_packet_t *packet)
             updateAutoStopTargetDisplay();
         }
     }
+    else if (packet->address == HmiThreadingPageOptions::bool_next_startAddress && packet->type == kBool)
+    {
+        if (packet->data._bool && _threadingMode) // React on button press (true)
+        {
+            _threadingMode->indexToNextStart();
+            updateStartDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::bool_new_threadAddress && packet->type == kBool)
+    {
+        if (packet->data._bool && _threadingMode) // React on button press (true)
+        {
+            _threadingMode->startNewThread();
+            updateStartDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::bool_cycle_startAddress && packet->type == kBool)
+    {
+        if (packet->data._bool && _threadingMode) // React on button press (true)
+        {
+            if (!_threadingMode->cycleStart())
+            {
+                SerialDebug.println("ThreadingPageHandler: cycle start rejected.");
+            }
+            updateCycleDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::bool_cycle_finishAddress && packet->type == kBool)
+    {
+        if (packet->data._bool && _threadingMode)
+        {
+            _threadingMode->cycleFinish();
+            updateCycleDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::bool_cycle_abortAddress && packet->type == kBool)
+    {
+        if (packet->data._bool && _threadingMode)
+        {
+            _threadingMode->cycleAbort();
+            updateCycleDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::int_spring_passes_prev_nextAddress && (packet->type == kS32 || packet->type == kBool))
+    {
+        uint8_t &springPasses = SystemConfig::RuntimeConfig::Motion::spring_passes;
+        if (packet->data._s32 == 1 && springPasses > 0)
+        {
+            springPasses--;
+        }
+        else if (packet->data._s32 == 2 && springPasses < SystemConfig::Limits::Motion::MAX_SPRING_PASSES)
+        {
+            springPasses++;
+        }
+        updateSpringPassesDisplay();
+    }
+    else if (packet->address == HmiThreadingPageOptions::bool_progressive_pitch_enDisAddress && packet->type == kBool)
+    {
+        if (_threadingMode)
+        {
+            _threadingMode->setUiProgressivePitchEnabled(packet->data._bool);
+            updateProgressivePitchDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::string_progressive_end_pitch_to_stm32Address && packet->type == kString)
+    {
+        if (_threadingMode)
+        {
+            _threadingMode->setUiProgressiveEndPitchFromString(packet->data._string);
+            updateProgressivePitchDisplay();
+        }
+    }
+    else if (packet->address == HmiThreadingPageOptions::string_progressive_length_to_stm32Address && packet->type == kString)
+    {
+        if (_threadingMode)
+        {
+            _threadingMode->setUiProgressiveLengthFromString(packet->data._string);
+            updateProgressivePitchDisplay();
+        }
+    }
     else if (packet->address == HmiThreadingPageOptions::bool_grab_zAddress && packet->type == kBool)
     {
         if (packet->data._bool && _threadingMode) // React on button press (true)
@@ -258,6 +347,17 @@ void ThreadingPageHandler::update()
 {
     uint32_t currentTime = millis();
 
+    if (_threadingMode)
+    {
+        _threadingMode->update();
+        if (_threadingMode->getCycleState() != lastShownCycleState_Threading ||
+            _threadingMode->getCyclePasses() != lastShownCyclePasses_Threading ||
+            _threadingMode->getSpringPassesLeft() != lastShownSpringPassesLeft_Threading)
+        {
+            updateCycleDisplay();
+        }
+    }
+
     // Timed DRO Update
     if (currentTime - _lastDROUpdateTime >= HANDLER_DRO_UPDATE_INTERVAL_THREADING)
     {
@@ -537,6 +637,7 @@ void ThreadingPageHandler::selectNextPitch()
     }
 
     updatePitchDisplay();
+    updateProgressivePitchDisplay(); // A progressive ramp starts from the new lead
     SerialDebug.print("ThreadingPageHandler: Pitch changed to index (in active list): ");
     SerialDebug.println(_currentPitchIndex);
 }
@@ -599,6 +700,7 @@ void ThreadingPageHandler::selectPreviousPitch()
     }
 
     updatePitchDisplay();
+    updateProgressivePitchDisplay(); // A progressive ramp starts from the new lead
     SerialDebug.print("ThreadingPageHandler: Pitch changed to index (in active list): ");
     SerialDebug.println(_currentPitchIndex);
 }
@@ -642,6 +744,7 @@ void ThreadingPageHandler::updatePitchDisplay()
 
     SerialDebug.print("ThreadingPageHandler: Sent pitch to HMI: ");
     SerialDebug.println(pitch_string_buffer);
+    updateStartDisplay(); // A new pitch starts over at the first start
 }
 
 void ThreadingPageHandler::updateAutoStopTargetDisplay()
@@ -654,6 +757,77 @@ void ThreadingPageHandler::updateAutoStopTargetDisplay()
     _displayComm->updateText(HmiThreadingPageOptions::string_set_stop_disp_value_from_stm32Address, formattedTarget.c_str());
 }
 
+void ThreadingPageHandler::updateStartDisplay()
+{
+    if (!_displayComm || !_threadingMode)
+    {
+        return;
+    }
+    char startStr[MAX_STRING_SIZE];
+    uint8_t starts = _threadingMode->getThreadData().starts;
+    snprintf(startStr, sizeof(startStr), "%u/%u", _threadingMode->getCurrentStart() + 1, starts > 0 ? starts : 1);
+    _displayComm->updateText(HmiThreadingPageOptions::string_current_startAddress, startStr);
+}
+
+void ThreadingPageHandler::updateCycleDisplay()
+{
+    if (!_displayComm || !_threadingMode)
+    {
+        return;
+    }
+    lastShownCycleState_Threading = _threadingMode->getCycleState();
+    lastShownCyclePasses_Threading = _threadingMode->getCyclePasses();
+    lastShownSpringPassesLeft_Threading = _threadingMode->getSpringPassesLeft();
+
+    char cycleStr[MAX_STRING_SIZE];
+    unsigned long pass = lastShownCyclePasses_Threading;
+    switch (lastShownCycleState_Threading)
+    {
+    case ThreadingMode::CycleState::THREADING:
+        snprintf(cycleStr, sizeof(cycleStr), "P%lu CUT", pass + 1);
+        break;
+    case ThreadingMode::CycleState::RETRACT:
+        snprintf(cycleStr, sizeof(cycleStr), "P%lu RETRACT", pass);
+        break;
+    case ThreadingMode::CycleState::RETURNING:
+        snprintf(cycleStr, sizeof(cycleStr), "P%lu RETURN", pass);
+        break;
+    default:
+        if (pass > 0)
+            snprintf(cycleStr, sizeof(cycleStr), "P%lu END", pass);
+        else
+            snprintf(cycleStr, sizeof(cycleStr), "---");
+        break;
+    }
+    if (_threadingMode->isCycleFinishing())
+    {
+        size_t used = strlen(cycleStr);
+        snprintf(cycleStr + used, sizeof(cycleStr) - used, " S%u", lastShownSpringPassesLeft_Threading);
+    }
+    _displayComm->updateText(HmiThreadingPageOptions::string_cycle_dispAddress, cycleStr);
+}
+
+void ThreadingPageHandler::updateSpringPassesDisplay()
+{
+    if (!_displayComm)
+    {
+        return;
+    }
+    char springStr[MAX_STRING_SIZE];
+    snprintf(springStr, sizeof(springStr), "%u", SystemConfig::RuntimeConfig::Motion::spring_passes);
+    _displayComm->updateText(HmiThreadingPageOptions::string_spring_passes_dispAddress, springStr);
+}
+
+void ThreadingPageHandler::updateProgressivePitchDisplay()
+{
+    if (!_displayComm || !_threadingMode)
+    {
+        return;
+    }
+    _displayComm->updateText(HmiThreadingPageOptions::string_progressive_pitch_dispAddress,
+                             _threadingMode->getFormattedUiProgressivePitch().c_str());
+}
+
 void ThreadingPageHandler::checkAndHandleAutoStopCompletionFlash()
 {
     if (_threadingMode && _threadingMode->isAutoStopCompletionPendingHmiSignal())
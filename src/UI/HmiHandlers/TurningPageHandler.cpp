@@ -29,8 +29,11 @@ const uint16_t STRING_Z_POS_ADDRESS_TURNING_DRO = 135;
 
 static uint32_t lastDroUpdateTimeMs_Handler = 0;
 const uint32_t HANDLER_DRO_UPDATE_INTERVAL = 100;
+static uint16_t lastShownFeedOverride_Handler = 100;
 static uint32_t lastRpmUpdateTimeMs_Handler = 0;
 const uint32_t HANDLER_RPM_UPDATE_INTERVAL = 200;
+static TurningMode::CycleState lastShownCycleState_Handler = TurningMode::CycleState::IDLE;
+static uint32_t lastShownCyclePasses_Handler = 0;
 
 void TurningPageHandler::init(TurningMode *turningMode, DisplayComm *displayComm, MotionControl *motionControl)
 {
@@ -64,6 +67,21 @@ void TurningPageHandler::onEnterPage()
         lumen_write_packet(&autoStopTargetPacket);
 
         sendTurningPageFeedDisplays();
+        sendFeedOverrideDisplay();
+
+        lumen_packet_t semiAutoPacket;
+        semiAutoPacket.address = HmiTurningPageOptions::bool_semi_autoAddress;
+        semiAutoPacket.type = kBool;
+        semiAutoPacket.data._bool = (_turningMode->getMode() == TurningMode::Mode::SEMI_AUTO);
+        lumen_write_packet(&semiAutoPacket);
+        sendCycleDisplay();
+
+        lumen_packet_t feedPerMinutePacket;
+        feedPerMinutePacket.address = HmiTurningPageOptions::bool_feed_per_minuteAddress;
+        feedPerMinutePacket.type = kBool;
+        feedPerMinutePacket.data._bool = _turningMode->isFeedPerMinuteEnabled();
+        lumen_write_packet(&feedPerMinutePacket);
+        sendFeedPerMinuteDisplay();
 
         lumen_packet_t motorEnablePacket;
         motorEnablePacket.address = HmiInputOptions::ADDR_TURNING_MOTOR_ENABLE_TOGGLE;
@@ -117,6 +135,14 @@ void TurningPageHandler::handlePacket(const lumen_packet_t *packet)
             }
         }
     }
+    else if (packet->address == HmiTurningPageOptions::int_feed_override_prev_nextAddress)
+    {
+        if (packet->type == kS32 || packet->type == kBool)
+        {
+            _turningMode->adjustFeedOverride(packet->data._s32);
+            sendFeedOverrideDisplay();
+        }
+    }
     else if (packet->address == HmiInputOptions::ADDR_TURNING_MOTOR_ENABLE_TOGGLE)
     {
         if (packet->type == kBool)
@@ -171,6 +197,49 @@ void TurningPageHandler::handlePacket(const lumen_packet_t *packet)
             lumen_write_packet(&responsePacket);
         }
     }
+    else if (packet->address == HmiTurningPageOptions::bool_semi_autoAddress)
+    {
+        if (packet->type == kBool)
+        {
+            _turningMode->setMode(packet->data._bool ? TurningMode::Mode::SEMI_AUTO : TurningMode::Mode::MANUAL);
+            sendCycleDisplay();
+        }
+    }
+    else if (packet->address == HmiTurningPageOptions::bool_feed_per_minuteAddress)
+    {
+        if (packet->type == kBool)
+        {
+            _turningMode->setFeedPerMinuteEnabled(packet->data._bool);
+            sendFeedPerMinuteDisplay();
+        }
+    }
+    else if (packet->address == HmiTurningPageOptions::string_feed_per_minute_to_stm32Address)
+    {
+        if (packet->type == kString || packet->type == kBool) // HMI bug workaround
+        {
+            _turningMode->setFeedPerMinuteFromString(packet->data._string);
+            sendFeedPerMinuteDisplay();
+        }
+    }
+    else if (packet->address == HmiTurningPageOptions::bool_cycle_startAddress)
+    {
+        if (packet->type == kBool && packet->data._bool)
+        {
+            if (!_turningMode->cycleStart())
+            {
+                SerialDebug.println("TurningPageHandler: cycle start rejected.");
+            }
+            sendCycleDisplay();
+        }
+    }
+    else if (packet->address == HmiTurningPageOptions::bool_cycle_abortAddress)
+    {
+        if (packet->type == kBool && packet->data._bool)
+        {
+            _turningMode->cycleAbort();
+            sendCycleDisplay();
+        }
+    }
     else if (packet->address == HmiTurningPageOptions::bool_grab_zAddress)
     {
         if (packet->type == kBool && packet->data._bool)
@@ -230,8 +299,8 @@ void TurningPageHandler::update()
             {
                 _isFlashingTargetReached = false;
                 _flashStateCount = 0;
-                String clearedTargetDisplay = "--- ";
-                clearedTargetDisplay += (SystemConfig::RuntimeConfig::System::measurement_unit_is_metric ? "mm" : "in");
+                // "---" once a manual stop has cleared the target; a cycle keeps it for the next pass
+                String clearedTargetDisplay = _turningMode->getFormattedUiAutoStopTarget();
 
                 lumen_packet_t finalPacket;
                 finalPacket.address = HmiTurningPageOptions::string_set_stop_disp_value_from_stm32Address;
@@ -243,6 +312,18 @@ void TurningPageHandler::update()
         }
     }
 
+    if (_turningMode->getCycleState() != lastShownCycleState_Handler ||
+        _turningMode->getCycleStats().passes != lastShownCyclePasses_Handler)
+    {
+        sendCycleDisplay();
+    }
+
+    // The applied override slews towards the request; keep the effective feed on screen current.
+    if (_turningMode->getFeedOverride() != lastShownFeedOverride_Handler)
+    {
+        sendTurningPageFeedDisplays();
+    }
+
     uint32_t currentTime = millis();
     if (currentTime - lastDroUpdateTimeMs_Handler >= HANDLER_DRO_UPDATE_INTERVAL)
     {
@@ -265,7 +346,8 @@ void TurningPageHandler::sendTurningPageFeedDisplays()
     lumen_write_packet(&packet);
 
     char feedRateStr[MAX_STRING_SIZE];
-    _turningMode->getFeedRateManager().getDisplayString(feedRateStr, sizeof(feedRateStr));
+    lastShownFeedOverride_Handler = _turningMode->getFeedOverride();
+    _turningMode->getFeedRateManager().getDisplayString(feedRateStr, sizeof(feedRateStr), lastShownFeedOverride_Handler);
     packet.address = HmiInputOptions::ADDR_TURNING_FEED_RATE_VALUE_DISPLAY;
     packet.type = kString;
     strncpy(packet.data._string, feedRateStr, MAX_STRING_SIZE - 1);
@@ -280,6 +362,18 @@ void TurningPageHandler::sendTurningPageFeedDisplays()
     lumen_write_packet(&packet);
 }
 
+void TurningPageHandler::sendFeedOverrideDisplay()
+{
+    if (!_motionControl)
+        return;
+
+    lumen_packet_t packet;
+    packet.address = HmiTurningPageOptions::string_feed_override_dispAddress;
+    packet.type = kString;
+    snprintf(packet.data._string, MAX_STRING_SIZE, "%u%%", _motionControl->getFeedOverride());
+    lumen_write_packet(&packet);
+}
+
 void TurningPageHandler::updateDRO()
 {
     if (!_displayComm || !_turningMode)
@@ -327,3 +421,49 @@ void TurningPageHandler::flashCompleteMessage()
     flashPacket.data._string[MAX_STRING_SIZE - 1] = '\0';
     lumen_write_packet(&flashPacket);
 }
+
+void TurningPageHandler::sendFeedPerMinuteDisplay()
+{
+    if (!_turningMode)
+        return;
+
+    lumen_packet_t packet;
+    packet.address = HmiTurningPageOptions::string_feed_per_minute_dispAddress;
+    packet.type = kString;
+    String formatted = _turningMode->getFormattedFeedPerMinute();
+    strncpy(packet.data._string, formatted.c_str(), MAX_STRING_SIZE - 1);
+    packet.data._string[MAX_STRING_SIZE - 1] = '\0';
+    lumen_write_packet(&packet);
+}
+
+void TurningPageHandler::sendCycleDisplay()
+{
+    if (!_turningMode)
+        return;
+
+    const TurningMode::CycleStats &stats = _turningMode->getCycleStats();
+    lastShownCycleState_Handler = _turningMode->getCycleState();
+    lastShownCyclePasses_Handler = stats.passes;
+
+    lumen_packet_t packet;
+    packet.address = HmiTurningPageOptions::string_cycle_dispAddress;
+    packet.type = kString;
+    switch (lastShownCycleState_Handler)
+    {
+    case TurningMode::CycleState::FEEDING:
+        snprintf(packet.data._string, MAX_STRING_SIZE, "P%lu FEED", (unsigned long)(stats.passes + 1));
+        break;
+    case TurningMode::CycleState::RETRACT:
+    case TurningMode::CycleState::RETURNING:
+        snprintf(packet.data._string, MAX_STRING_SIZE, "P%lu RETURN", (unsigned long)(stats.passes + 1));
+        break;
+    case TurningMode::CycleState::WAITING:
+        snprintf(packet.data._string, MAX_STRING_SIZE, "P%lu %.1fs", (unsigned long)stats.passes, stats.lastPassMs / 1000.0f);
+        break;
+    default:
+        strncpy(packet.data._string, (_turningMode->getMode() == TurningMode::Mode::SEMI_AUTO) ? "READY" : "---", MAX_STRING_SIZE - 1);
+        packet.data._string[MAX_STRING_SIZE - 1] = '\0';
+        break;
+    }
+    lumen_write_packet(&packet);
+}
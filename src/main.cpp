@@ -17,6 +17,8 @@
 #include "UI/HmiHandlers/TurningPageHandler.h"
 #include "UI/HmiHandlers/JogPageHandler.h"
 #include "UI/HmiHandlers/ThreadingPageHandler.h"
+#include "UI/HmiHandlers/PositioningPageHandler.h"
+#include "Motion/Positioning.h"
 
 enum ActiveHmiPage
 {
@@ -68,6 +70,7 @@ void sendMainPageFeedRateDisplay()
 
 EncoderTimer globalEncoderTimerInstance;
 MotionControl motionCtrl(MotionControl::MotionPins{STM32Step::PinConfig::StepPin::PIN, STM32Step::PinConfig::DirPin::PIN, STM32Step::PinConfig::EnablePin::PIN});
+Positioning positioning(&motionCtrl);
 
 volatile bool g_exti_pa5_index_pulse_detected = false;
 volatile unsigned long g_last_pa5_interrupt_time = 0;
@@ -80,9 +83,11 @@ extern "C" void lumen_write_bytes(uint8_t *data, uint32_t length)
 
 void pa5_index_pulse_isr()
 {
+    uint32_t index_count = globalEncoderTimerInstance.getRawCounter(); // Latch first: the spindle keeps counting
     unsigned long interrupt_time = millis();
     if (interrupt_time - g_last_pa5_interrupt_time > PA5_DEBOUNCE_DELAY_MS)
     {
+        globalEncoderTimerInstance.IndexPulse_Callback_Internal(index_count);
         g_exti_pa5_index_pulse_detected = true;
         g_last_pa5_interrupt_time = interrupt_time;
     }
@@ -182,6 +187,7 @@ void setup()
     TurningPageHandler::init(menuSystem.getTurningMode(), &displayComm, &motionCtrl);
     JogPageHandler::init(&motionCtrl);
     ThreadingPageHandler::init(&displayComm, menuSystem.getThreadingMode(), &motionCtrl);
+    PositioningPageHandler::init(&positioning);
 
     displayComm.showScreen(currentPage);
 
@@ -224,6 +230,9 @@ void loop()
         lastRpmHmiUpdateTime = currentTime;
     }
 
+    // Stop and fault handling must not depend on the page shown
+    motionCtrl.update();
+
     if (currentPage == PAGE_TURNING)
     {
         TurningPageHandler::update();
@@ -232,6 +241,10 @@ void loop()
     {
         ThreadingPageHandler::update();
     }
+    else if (currentPage == PAGE_POSITIONING)
+    {
+        PositioningPageHandler::update();
+    }
 
     while (SerialDisplay.available() > 0 && hmi_buffer_write_idx < HMI_SERIAL_INPUT_BUFFER_SIZE)
     {
@@ -265,6 +278,10 @@ void loop()
                 {
                     ThreadingPageHandler::onExitPage();
                 }
+                else if (currentPage == PAGE_POSITIONING)
+                {
+                    PositioningPageHandler::onExitPage();
+                }
 
                 currentPage = newPage;
 
@@ -286,6 +303,10 @@ void loop()
                 {
                     ThreadingPageHandler::onEnterPage();
                 }
+                else if (currentPage == PAGE_POSITIONING)
+                {
+                    PositioningPageHandler::onEnterPage();
+                }
             }
         }
         else
@@ -311,6 +332,9 @@ void loop()
             case PAGE_JOG:
                 JogPageHandler::handlePacket(packet);
                 break;
+            case PAGE_POSITIONING:
+                PositioningPageHandler::handlePacket(packet);
+                break;
             case PAGE_THREADING:
                 if (packet->address == 192 && packet->type == kBool && packet->data._bool)
                 {
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Config/serial_debug.h"
+
+// PASS/FAIL reporting shared by the self-checking test sketches. Each sketch is one
+// translation unit, so every one gets its own count.
+
+static uint32_t failures = 0;
+
+inline void check(const char *name, bool ok)
+{
+    SerialDebug.print(ok ? "PASS: " : "FAIL: ");
+    SerialDebug.println(name);
+    if (!ok)
+    {
+        failures++;
+    }
+}
+
+// Prints the failure count; the last thing a sketch's setup() does
+inline void reportFailures()
+{
+    SerialDebug.print("\nFailures: ");
+    SerialDebug.println(failures);
+}
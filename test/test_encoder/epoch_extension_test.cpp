@@ -0,0 +1,100 @@
+#include <Arduino.h>
+#include "Config/serial_debug.h"
+#include "Hardware/EncoderTimer.h"
+#include "../test_check.h"
+
+HardwareSerial SerialDebug(PA3, PA2);
+
+EncoderTimer encoder;
+
+// Checks the 64-bit position TIM2's wraps are extended to. TIM2 is forced across the wrap
+// in software (the spindle must stand still): a UG event sets the update flag as a real
+// wrap would, with the update interrupt held off, so the window in which the flag is
+// pending but the epoch not yet bumped is exercised deterministically.
+
+int64_t epochBase()
+{
+    int64_t position = encoder.getAbsolutePosition();
+    return position - static_cast<int64_t>(static_cast<uint32_t>(position)); // epoch x 2^32
+}
+
+// Raises the update flag as a wrap does, then leaves the counter at `count`
+void forceWrap(uint32_t count)
+{
+    TIM2->DIER &= ~TIM_DIER_UIE;
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->CNT = count;
+}
+
+void releaseWrap()
+{
+    TIM2->DIER |= TIM_DIER_UIE; // The update interrupt now books the wrap into the epoch
+    delay(1);
+}
+
+void testForwardWrap()
+{
+    int64_t base = epochBase();
+    TIM2->CNT = 0xFFFFFFF0UL;
+    encoder.reset();
+    check("position below the wrap", encoder.getAbsolutePosition() == base + 0xFFFFFFF0LL);
+
+    forceWrap(3);
+    check("pending forward wrap is already counted", encoder.getAbsolutePosition() == base + 0x100000003LL);
+    check("relative count runs on across the wrap", encoder.getCount() == 19);
+
+    releaseWrap();
+    check("epoch booked once forward", encoder.getAbsolutePosition() == base + 0x100000003LL);
+    check("relative count unchanged once booked", encoder.getCount() == 19);
+}
+
+void testBackwardWrap()
+{
+    int64_t base = epochBase();
+    TIM2->CNT = 5;
+    encoder.reset();
+
+    forceWrap(0xFFFFFFFDUL);
+    check("pending backward wrap is already counted", encoder.getAbsolutePosition() == base - 3);
+    check("relative count runs back across the wrap", encoder.getCount() == -8);
+
+    releaseWrap();
+    check("epoch booked once backward", encoder.getAbsolutePosition() == base - 3);
+    check("raw counter is the low word", static_cast<uint32_t>(encoder.getAbsolutePosition()) == encoder.getRawCounter());
+}
+
+void testManyWraps()
+{
+    int64_t base = epochBase();
+    for (int i = 0; i < 5; i++)
+    {
+        forceWrap(0);
+        releaseWrap();
+    }
+    check("five forward wraps add 5 x 2^32", encoder.getAbsolutePosition() == base + 5 * 0x100000000LL);
+}
+
+void setup()
+{
+    SerialDebug.begin(115200);
+    delay(1000);
+    SerialDebug.println("\n=== Encoder Epoch Extension Test ===");
+
+    if (!encoder.begin())
+    {
+        SerialDebug.println("Encoder initialization failed!");
+        return;
+    }
+
+    testForwardWrap();
+    testBackwardWrap();
+    testManyWraps();
+    TIM2->CNT = 0;
+
+    reportFailures();
+}
+
+void loop()
+{
+    delay(1000);
+}
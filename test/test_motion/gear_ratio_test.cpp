@@ -0,0 +1,145 @@
+#include <Arduino.h>
+#include "Config/serial_debug.h"
+#include "Config/SystemConfig.h"
+#include "Motion/GearRatio.h"
+#include "../test_check.h"
+
+HardwareSerial SerialDebug(PA3, PA2);
+
+using namespace SystemConfig;
+
+// Checks the rational gearing: that the drive train reduces to the expected fraction,
+// and that the ISR's accumulator run on that fraction books exactly numerator x counts /
+// denominator steps however long it runs and however the counts are batched.
+
+// Runs the SyncTimer accumulator (GearRatio::advance()) over `counts`, fed in
+// tick-sized batches of `batch` counts the way the ISR sees them
+int64_t accumulateSteps(const GearRatio &ratio, int64_t counts, int64_t batch)
+{
+    int32_t phase = 0;
+    int64_t steps = 0;
+    int64_t done = 0;
+    while (done != counts)
+    {
+        int64_t n = counts - done;
+        if (n > batch)
+            n = batch;
+        else if (n < -batch)
+            n = -batch;
+        steps += ratio.advance(n, phase);
+        done += n;
+    }
+    return steps;
+}
+
+void setMachine(uint16_t ppr, uint32_t driverPulses, float leadscrewPitch, bool metric)
+{
+    RuntimeConfig::Encoder::ppr = ppr;
+    RuntimeConfig::Z_Axis::driver_pulses_per_rev = driverPulses;
+    RuntimeConfig::Z_Axis::lead_screw_pitch = leadscrewPitch;
+    RuntimeConfig::Z_Axis::leadscrew_standard_is_metric = metric;
+    RuntimeConfig::Z_Axis::motor_pulley_teeth = 1;
+    RuntimeConfig::Z_Axis::lead_screw_pulley_teeth = 1;
+    RuntimeConfig::Spindle::chuck_pulley_teeth = 1;
+    RuntimeConfig::Spindle::encoder_pulley_teeth = 1;
+}
+
+void testFractionReduces()
+{
+    GearRatio r = GearRatio::fromFraction(3000, 4000);
+    check("fromFraction reduces to lowest terms", r.numerator == 3 && r.denominator == 4 && r.exact);
+
+    GearRatio zero = GearRatio::fromFraction(5, 0);
+    check("zero denominator yields 0/1", zero.numerator == 0 && zero.denominator == 1 && !zero.exact);
+
+    // Two large coprime terms cannot fit: the nearest convergent is used instead
+    GearRatio big = GearRatio::fromFraction(0x7FFFFFFFFULL, 0x3FFFFFFFFULL + 2);
+    check("oversized fraction is approximated", !big.exact && big.numerator <= GearRatio::MAX_TERM &&
+                                                    big.denominator <= GearRatio::MAX_TERM);
+    check("approximation stays close", fabs(big.toFloat() - 0x7FFFFFFFFULL / (double)(0x3FFFFFFFFULL + 2)) < 1e-6);
+
+    GearRatio s = GearRatio(r).scaled(8, 6);
+    check("scaled ratio reduces again", s.numerator == 1 && s.denominator == 1 && s.exact);
+}
+
+void testMetricFeed()
+{
+    // 1000 PPR x4, 1600 pulses/rev on a 2 mm screw: 1.5 mm/rev = 1200 steps per 4000 counts
+    setMachine(1000, 1600, 2.0f, true);
+    GearRatio r = GearRatio::forFeed(1.5f);
+    check("metric feed reduces to 3/10", r.numerator == 3 && r.denominator == 10 && r.exact);
+}
+
+void testImperialThread()
+{
+    // 11 TPI on a 2 mm screw: 25.4 / 11 mm per rev has no finite decimal, yet the ratio is exact
+    setMachine(1000, 1600, 2.0f, true);
+    GearRatio r = GearRatio::forFeed(25.4f / 11.0f, 11.0f);
+    check("imperial thread is exact", r.exact);
+    check("imperial thread reduces to 127/275", r.numerator == 127 && r.denominator == 275);
+}
+
+void testAccumulatorIsExact()
+{
+    setMachine(1000, 1600, 2.0f, true);
+    GearRatio r = GearRatio::forFeed(25.4f / 11.0f, 11.0f);
+
+    // 550 spindle revolutions of 4000 counts each, a whole number of ratio periods
+    const int64_t counts = 550LL * 4000;
+    int64_t expected = counts * r.numerator / r.denominator;
+    check("accumulator books exact steps forward", accumulateSteps(r, counts, 37) == expected);
+    check("accumulator books exact steps in reverse", accumulateSteps(r, -counts, 37) == -expected);
+    check("batching does not change the steps", accumulateSteps(r, counts, 1) == expected &&
+                                                  accumulateSteps(r, counts, 4000) == expected);
+
+    // One count at a time, against the add/compare definition of the accumulator
+    int32_t phase = 0;
+    int32_t reference = 0;
+    int64_t steps = 0;
+    int64_t referenceSteps = 0;
+    bool sameEachCount = true;
+    for (int32_t i = 0; i < 1000; i++)
+    {
+        steps += r.advance(1, phase);
+        reference += static_cast<int32_t>(r.numerator);
+        while (reference >= static_cast<int32_t>(r.denominator))
+        {
+            reference -= static_cast<int32_t>(r.denominator);
+            referenceSteps++;
+        }
+        sameEachCount = sameEachCount && steps == referenceSteps && phase == reference;
+    }
+    steps += r.advance(-1000, phase);
+    check("each count matches the add/compare accumulator", sameEachCount);
+    check("reversing over the same counts returns to the start", steps == 0 && phase == 0);
+
+    // A float steps-per-count drifts over the same run
+    float perCount = r.toFloat();
+    float drifted = 0.0f;
+    for (int64_t i = 0; i < counts; i++)
+    {
+        drifted += perCount;
+    }
+    SerialDebug.print("Float accumulation error over 550 rev: ");
+    SerialDebug.print(drifted - static_cast<float>(expected));
+    SerialDebug.println(" steps");
+}
+
+void setup()
+{
+    SerialDebug.begin(115200);
+    delay(1000);
+    SerialDebug.println("\n=== GearRatio Test ===");
+
+    testFractionReduces();
+    testMetricFeed();
+    testImperialThread();
+    testAccumulatorIsExact();
+
+    reportFailures();
+}
+
+void loop()
+{
+    delay(1000);
+}
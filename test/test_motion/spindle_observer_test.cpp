@@ -0,0 +1,145 @@
+#include <Arduino.h>
+#include "Config/serial_debug.h"
+#include "Motion/SpindleObserver.h"
+#include "../test_check.h"
+
+HardwareSerial SerialDebug(PA3, PA2);
+
+// Feeds the Q32 spindle observer synthetic encoder counts, tick by tick as the sync ISR
+// does, and checks that it settles onto the true position, speed and acceleration, and
+// that the fixed-point state runs on across the 32-bit count wrap.
+
+const double Q32 = 4294967296.0;
+
+// Spindle with a sub-count true position; the encoder reports its floor
+struct Spindle
+{
+    double position; // Counts
+    int64_t reported;
+};
+
+// Advances the spindle one tick and runs the observer on what the encoder saw
+void tick(SpindleObserver &observer, Spindle &spindle, double countsThisTick)
+{
+    spindle.position += countsThisTick;
+    int64_t count = static_cast<int64_t>(floor(spindle.position));
+    observer.update(static_cast<int32_t>(count - spindle.reported));
+    spindle.reported = count;
+}
+
+double estimate(const SpindleObserver &observer)
+{
+    return static_cast<double>(observer.measured()) + static_cast<double>(observer.offset()) / Q32;
+}
+
+double velocity(const SpindleObserver &observer)
+{
+    return static_cast<double>(observer.velocity()) / Q32;
+}
+
+void testConstantSpeed(uint32_t tickHz, double countsPerTick, const char *label)
+{
+    SpindleObserver observer;
+    observer.configure(tickHz);
+    observer.reset(0);
+    Spindle spindle = {0.0, 0};
+
+    // 10 Hz poles: two seconds is many time constants
+    for (uint32_t i = 0; i < 2 * tickHz; i++)
+    {
+        tick(observer, spindle, countsPerTick);
+    }
+
+    SerialDebug.print(label);
+    SerialDebug.println(":");
+    check("  velocity settles on the spindle speed", fabs(velocity(observer) - countsPerTick) < 1e-3 * countsPerTick + 1e-4);
+    // The encoder floors the position, so the estimate sits up to one count behind it
+    check("  position tracks to within a count", fabs(estimate(observer) - spindle.position) < 1.0);
+}
+
+void testAcceleration()
+{
+    const uint32_t tickHz = 1000;
+    SpindleObserver observer;
+    observer.configure(tickHz);
+    observer.reset(0);
+    Spindle spindle = {0.0, 0};
+
+    // Spindle run up to 3000 RPM in a second on a 1000 PPR disk: 0.2 counts/tick^2 at 1 kHz
+    double speed = 0.0;
+    const double accel = 0.2;
+    for (uint32_t i = 0; i < tickHz; i++)
+    {
+        speed += accel;
+        tick(observer, spindle, speed);
+    }
+
+    double observedAccel = static_cast<double>(observer.acceleration()) / Q32;
+    check("acceleration settles on the run-up rate", fabs(observedAccel - accel) < 0.1 * accel);
+    check("velocity follows a run-up without lag", fabs(velocity(observer) - speed) < 0.01 * speed);
+}
+
+void testStopAndReverse()
+{
+    const uint32_t tickHz = 1000;
+    SpindleObserver observer;
+    observer.configure(tickHz);
+    observer.reset(1000);
+    Spindle spindle = {1000.5, 1000};
+
+    for (uint32_t i = 0; i < tickHz; i++)
+    {
+        tick(observer, spindle, 7.3);
+    }
+    for (uint32_t i = 0; i < 2 * tickHz; i++)
+    {
+        tick(observer, spindle, 0.0);
+    }
+    check("velocity returns to zero at a standstill", fabs(velocity(observer)) < 1e-3);
+    check("estimate settles on the count at a standstill", fabs(estimate(observer) - spindle.reported) < 0.01);
+
+    for (uint32_t i = 0; i < 2 * tickHz; i++)
+    {
+        tick(observer, spindle, -4.2);
+    }
+    check("velocity follows a reversal", fabs(velocity(observer) + 4.2) < 1e-2);
+}
+
+void testPastTheWrap()
+{
+    // Started just short of the 32-bit wrap: the unwrapped count and the Q32 offset run on across it
+    const uint32_t tickHz = 1000;
+    SpindleObserver observer;
+    observer.configure(tickHz);
+    observer.reset(0xFFF00000UL);
+    Spindle spindle = {static_cast<double>(0xFFF00000UL), 0xFFF00000LL};
+
+    // 3000 RPM on a 1000 PPR disk for 100 s
+    for (uint32_t i = 0; i < 100 * tickHz; i++)
+    {
+        tick(observer, spindle, 200.0);
+    }
+    check("measured count runs on past 2^32", observer.measured() == spindle.reported && spindle.reported > 0x100000000LL);
+    check("velocity stays exact past the wrap", fabs(velocity(observer) - 200.0) < 1e-3);
+    check("position stays within a count past the wrap", fabs(estimate(observer) - spindle.position) < 1.0);
+}
+
+void setup()
+{
+    SerialDebug.begin(115200);
+    delay(1000);
+    SerialDebug.println("\n=== Spindle Observer Test ===");
+
+    testConstantSpeed(1000, 123.456, "1 kHz tick, 123.456 counts/tick");
+    testConstantSpeed(50000, 0.0371, "50 kHz tick, 0.0371 counts/tick");
+    testAcceleration();
+    testStopAndReverse();
+    testPastTheWrap();
+
+    reportFailures();
+}
+
+void loop()
+{
+    delay(1000);
+}
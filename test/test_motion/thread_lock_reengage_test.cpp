@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include "Config/serial_debug.h"
+#include "Motion/GearRatio.h"
+#include "../test_check.h"
+
+HardwareSerial SerialDebug(PA3, PA2);
+
+// Checks the thread-lock re-engagement arithmetic (GearRatio::reach()): started at the
+// engage count with the phase and catch-up it returns, the ISR accumulator must land on
+// exactly the relation the lock recorded, and no earlier count may do.
+
+struct Geared
+{
+    int64_t steps;
+    int32_t accumulator;
+};
+
+// Runs the SyncTimer accumulator (GearRatio::advance()) over `counts` from a point at `phase`
+Geared gear(const GearRatio &ratio, int32_t phase, int64_t counts)
+{
+    Geared g = {0, phase};
+    g.steps = ratio.advance(counts, g.accumulator);
+    return g;
+}
+
+void checkRatio(const char *label, uint32_t numerator, uint32_t denominator, int32_t lockPhase)
+{
+    GearRatio ratio;
+    ratio.numerator = numerator;
+    ratio.denominator = denominator;
+
+    // Carriage offsets from the locked point, behind it and ahead of it
+    const int32_t offsets[] = {-5000, -1, 0, 1, 2, 12345};
+    bool onRelation = true;
+    bool firstCount = true;
+    bool inRange = true;
+    for (int32_t offset : offsets)
+    {
+        GearRatio::Reach r = ratio.reach(offset, lockPhase);
+        Geared at = gear(ratio, lockPhase, r.counts);
+        Geared before = gear(ratio, lockPhase, r.counts - 1);
+
+        // Engaging there with `phase` and `catchUpSteps` continues the locked relation exactly
+        onRelation = onRelation && at.steps == offset + r.catchUpSteps && at.accumulator == r.phase;
+        firstCount = firstCount && before.steps < offset;
+        inRange = inRange && r.phase >= 0 && r.phase < static_cast<int32_t>(denominator) &&
+                  r.catchUpSteps >= 0 && r.catchUpSteps <= static_cast<int32_t>(numerator / denominator);
+    }
+
+    SerialDebug.print(label);
+    SerialDebug.println(":");
+    check("  engage count lands on the locked relation", onRelation);
+    check("  no earlier count reaches the carriage", firstCount);
+    check("  phase and catch-up stay within one count", inRange);
+}
+
+void testNoGearing()
+{
+    GearRatio none;
+    GearRatio::Reach r = none.reach(100, 0);
+    check("a zero ratio never re-engages away from the point", r.counts == 0 && r.phase == 0 && r.catchUpSteps == 0);
+}
+
+void setup()
+{
+    SerialDebug.begin(115200);
+    delay(1000);
+    SerialDebug.println("\n=== Thread Lock Re-Engage Test ===");
+
+    checkRatio("11 TPI, 127/275", 127, 275, 100);
+    checkRatio("1.5 mm, 3/10", 3, 10, 7);
+    checkRatio("coarse, 7/3", 7, 3, 2);
+    testNoGearing();
+
+    reportFailures();
+}
+
+void loop()
+{
+    delay(1000);
+}
@@ -0,0 +1,154 @@
+#include <Arduino.h>
+#include "STM32Step.h"
+#include "planner.h"
+#include "Config/serial_debug.h"
+#include "../test_check.h"
+
+HardwareSerial SerialDebug(PA3, PA2);
+
+using namespace STM32Step;
+
+// Runs the planner off-line, exactly as the segment ring refill would, and checks
+// the step count and speeds of the profile it produces.
+
+static const uint32_t BATCH = 8;
+
+struct ProfileResult
+{
+    uint32_t steps;    // Pulses in all generated segments
+    uint32_t segments;
+    float peakHz;      // Fastest segment
+    float lastHz;      // Rate of the final segment
+};
+
+// Drains the planner; `stopAfter` > 0 requests a stop once that many segments are out
+ProfileResult run(MotionPlanner &planner, uint32_t stopAfter = 0)
+{
+    StepSegment out[BATCH];
+    ProfileResult result = {0, 0, 0.0f, 0.0f};
+
+    while (!planner.isFinished() && result.segments < 100000)
+    {
+        uint32_t n = planner.generate(out, BATCH);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            result.steps += out[i].pulses;
+            result.segments++;
+            result.peakHz = max(result.peakHz, out[i].frequency_hz);
+            result.lastHz = out[i].frequency_hz;
+            if (stopAfter > 0 && result.segments == stopAfter)
+            {
+                planner.requestStop();
+            }
+        }
+        if (n == 0)
+        {
+            break;
+        }
+    }
+    return result;
+}
+
+void testTrapezoidalMoveIsExact()
+{
+    MotionPlanner planner;
+    planner.configure(ProfileShape::TRAPEZOIDAL, 20000.0f, 0.0f, 200.0f);
+    planner.startMove(12345, 8000.0f);
+    ProfileResult r = run(planner);
+
+    check("trapezoidal move ends on its step count", r.steps == 12345);
+    check("trapezoidal move reaches cruise speed", r.peakHz > 7900.0f && r.peakHz < 8100.0f);
+    check("trapezoidal move ramps down before its last step", r.lastHz <= 1000.0f);
+}
+
+void testSCurveMoveIsExact()
+{
+    MotionPlanner planner;
+    planner.configure(ProfileShape::S_CURVE, 20000.0f, 200000.0f, 200.0f);
+    planner.startMove(54321, 10000.0f);
+    ProfileResult r = run(planner);
+
+    check("S-curve move ends on its step count", r.steps == 54321);
+    check("S-curve move stays under cruise speed", r.peakHz < 10100.0f);
+}
+
+void testShortMoveNeverCruises()
+{
+    // Too short to reach cruise: a triangle profile that still lands exactly
+    MotionPlanner planner;
+    planner.configure(ProfileShape::TRAPEZOIDAL, 20000.0f, 0.0f, 200.0f);
+    planner.startMove(300, 20000.0f);
+    ProfileResult r = run(planner);
+
+    check("short move ends on its step count", r.steps == 300);
+    check("short move peaks below cruise speed", r.peakHz < 20000.0f);
+}
+
+void testJogStopsOnRequest()
+{
+    MotionPlanner planner;
+    planner.configure(ProfileShape::TRAPEZOIDAL, 20000.0f, 0.0f, 200.0f);
+    planner.startJog(5000.0f);
+    ProfileResult r = run(planner, 200);
+
+    // 5 kHz at 20000 steps/s^2 stops within 625 steps
+    check("jog finishes after a stop request", planner.isFinished());
+    check("jog runs down at the configured rate", r.segments > 200 && r.segments < 200 + 140);
+}
+
+void testBoundedStopEndsShort()
+{
+    MotionPlanner planner;
+    planner.configure(ProfileShape::TRAPEZOIDAL, 20000.0f, 0.0f, 200.0f);
+    planner.startMove(100000, 5000.0f);
+    ProfileResult r = run(planner, 50);
+
+    // A stop on a bounded move ends along the ramp, it does not creep on to the target
+    check("bounded stop finishes", planner.isFinished());
+    check("bounded stop ends short of its target", r.steps < 100000);
+    check("bounded stop ends within its stopping distance", r.steps < 50 * 10 + 700);
+}
+
+void testLimitToEndsOnCount()
+{
+    MotionPlanner planner;
+    planner.configure(ProfileShape::TRAPEZOIDAL, 20000.0f, 0.0f, 200.0f);
+    planner.startJog(5000.0f);
+
+    StepSegment out[BATCH];
+    uint32_t steps = 0;
+    for (int i = 0; i < 10; i++)
+    {
+        uint32_t n = planner.generate(out, BATCH);
+        for (uint32_t j = 0; j < n; j++)
+        {
+            steps += out[j].pulses;
+        }
+    }
+    uint32_t limit = steps + 5000;
+    planner.limitTo(limit);
+    steps += run(planner).steps;
+
+    check("limited jog ends on its step count", steps == limit);
+}
+
+void setup()
+{
+    SerialDebug.begin(115200);
+    delay(1000);
+    SerialDebug.println("\n=== MotionPlanner Profile Test ===");
+
+    testTrapezoidalMoveIsExact();
+    testSCurveMoveIsExact();
+    testShortMoveNeverCruises();
+    testJogStopsOnRequest();
+    testBoundedStopEndsShort();
+    testLimitToEndsOnCount();
+
+    reportFailures();
+}
+
+void loop()
+{
+    delay(1000);
+}